@@ -36,7 +36,10 @@ extern "C" {
 #include "mraa/i2c.h"
 #include "mraa/uart.h"
 #include "mraa/uart_ow.h"
+#include "mraa/modbus.h"
 #include "mraa/led.h"
+#include "mraa/led_strip.h"
+#include "mraa/crc.h"
 
 #ifdef __cplusplus
 }
@@ -52,6 +52,12 @@ extern "C" {
  */
 typedef struct _aio* mraa_aio_context;
 
+/**
+ * Opaque pointer definition to the internal struct _aio_stream. A stream
+ * samples one or more AIO pins of the same ADC from its IIO buffer.
+ */
+typedef struct _aio_stream* mraa_aio_stream_context;
+
 /**
  * Initialise an Analog input device, connected to the specified pin. Aio pins
  * are always 0 indexed reguardless of their position. Check your board mapping
@@ -80,6 +86,21 @@ int mraa_aio_read(mraa_aio_context dev);
  */
 float mraa_aio_read_float(mraa_aio_context dev);
 
+/**
+ * Read several inputs as close together in time as possible. All files are
+ * opened up front and read back to back with one pread each, then shifted
+ * like mraa_aio_read(). For simultaneous samples use a stream, where every
+ * scan holds all channels from one trigger.
+ *
+ * @param devs The AIO contexts
+ * @param count Number of contexts
+ * @param values Receives one value per context
+ * @param timestamp Receives the CLOCK_MONOTONIC time in ns halfway through
+ * the reads, may be NULL
+ * @return Result of operation
+ */
+mraa_result_t mraa_aio_read_multi(mraa_aio_context* devs, int count, int* values, int64_t* timestamp);
+
 /**
  * Close the analog input context, this will free the memory for the context
  *
@@ -106,6 +127,164 @@ mraa_result_t mraa_aio_set_bit(mraa_aio_context dev, int bits);
  */
 int mraa_aio_get_bit(mraa_aio_context dev);
 
+/**
+ * Average several raw reads into every sample of mraa_aio_read() and
+ * mraa_aio_read_calibrated(), trading rate for noise.
+ *
+ * @param dev The AIO context
+ * @param samples raw reads per sample, 1 to 1024, 1 disables averaging
+ * @return Result of operation
+ */
+mraa_result_t mraa_aio_set_oversampling(mraa_aio_context dev, unsigned int samples);
+
+/**
+ * Set a linear calibration from raw ADC codes to engineering units,
+ * units = (raw + offset) * scale as with the IIO _offset and _scale
+ * attributes. Replaces a calibration table. The default is scale 1 and
+ * offset 0, so calibrated reads return the raw code.
+ *
+ * @param dev The AIO context
+ * @param scale units per ADC code
+ * @param offset added to the raw code before scaling
+ * @return Result of operation
+ */
+mraa_result_t mraa_aio_set_calibration(mraa_aio_context dev, float scale, float offset);
+
+/**
+ * Set a calibration table for non linear sensors such as thermistors.
+ * Values between points are interpolated linearly, beyond the ends the
+ * first and last segments are extended.
+ *
+ * @param dev The AIO context
+ * @param raw raw ADC codes, strictly increasing
+ * @param units value at each raw code
+ * @param points number of points, at least 2
+ * @return Result of operation
+ */
+mraa_result_t mraa_aio_set_calibration_table(mraa_aio_context dev, const float* raw, const float* units, int points);
+
+/**
+ * Read the input in calibrated units. With oversampling the mean of the raw
+ * reads is calibrated, so the extra resolution is kept.
+ *
+ * @param dev The AIO context
+ * @param value Receives the calibrated value
+ * @return Result of operation
+ */
+mraa_result_t mraa_aio_read_calibrated(mraa_aio_context dev, float* value);
+
+/**
+ * Convert a block of raw ADC codes of this input to calibrated units. The
+ * linear calibration uses SSE2 or NEON.
+ *
+ * @param dev The AIO context
+ * @param raw raw ADC codes, i.e. from mraa_aio_stream_read()
+ * @param units Receives count values
+ * @param count number of codes
+ * @return Result of operation
+ */
+mraa_result_t mraa_aio_convert(mraa_aio_context dev, const int32_t* raw, float* units, int count);
+
+/**
+ * Create a stream over the IIO buffer of the ADC behind the given pins.
+ * Instead of reading sysfs for every sample, the kernel fills a buffer on
+ * each trigger and whole scans are read from /dev/iio:deviceN. The pins
+ * stay usable with mraa_aio_read() while the stream is stopped.
+ *
+ * @param pins initialised AIO contexts, all on the platform ADC
+ * @param count number of contexts, the number of values in each scan
+ * @return stream context or NULL, also NULL on boards without IIO ADC
+ */
+mraa_aio_stream_context mraa_aio_stream_init(mraa_aio_context* pins, int count);
+
+/**
+ * Choose the trigger that starts each scan. An hrtimer trigger of that name
+ * is created through configfs when none exists yet. Without a trigger the
+ * one already attached to the device is used.
+ *
+ * @param stream The AIO stream context
+ * @param trigger trigger name, i.e. "hrtimer0" or "sysfstrig0"
+ * @param rate_hz sampling_frequency to set on the trigger, 0 to keep it
+ * @return Result of operation
+ */
+mraa_result_t mraa_aio_stream_set_trigger(mraa_aio_stream_context stream, const char* trigger, unsigned int rate_hz);
+
+/**
+ * Size the kernel buffer. Readers are woken once watermark scans are
+ * buffered, so a larger watermark means fewer, bigger reads.
+ *
+ * @param stream The AIO stream context
+ * @param length buffer length in scans, 0 for the driver default
+ * @param watermark scans before a read is woken, 0 for the driver default
+ * @return Result of operation
+ */
+mraa_result_t mraa_aio_stream_set_buffer(mraa_aio_stream_context stream, unsigned int length, unsigned int watermark);
+
+/**
+ * Average every factor scans into one before they are read, a boxcar
+ * decimation done while decoding the buffer. Timestamps are those halfway
+ * through each group.
+ *
+ * @param stream The AIO stream context
+ * @param factor scans per output, 1 disables decimation
+ * @return Result of operation
+ */
+mraa_result_t mraa_aio_stream_set_decimation(mraa_aio_stream_context stream, unsigned int factor);
+
+/**
+ * Enable the scan elements of the pins and the timestamp, attach the
+ * trigger and start buffering.
+ *
+ * @param stream The AIO stream context
+ * @return Result of operation
+ */
+mraa_result_t mraa_aio_stream_start(mraa_aio_stream_context stream);
+
+/**
+ * Read buffered scans. Values are the raw ADC codes, sign extended, stored
+ * scan after scan with one value per pin in the order given at init. With
+ * decimation each value is the rounded mean of its group.
+ *
+ * @param stream The AIO stream context
+ * @param values room for scans * count values
+ * @param timestamps room for scans timestamps in ns or NULL, 0 when the
+ * device has no timestamp channel
+ * @param scans maximum number of scans to read
+ * @param timeout_ms time to wait for the first scan, -1 waits forever
+ * @return number of scans read, 0 on timeout or -1 on error
+ */
+int mraa_aio_stream_read(mraa_aio_stream_context stream, int32_t* values, int64_t* timestamps, int scans, int timeout_ms);
+
+/**
+ * Read buffered scans like mraa_aio_stream_read(), converted with the
+ * calibration of each pin's AIO context.
+ *
+ * @param stream The AIO stream context
+ * @param values room for scans * count values
+ * @param timestamps room for scans timestamps in ns or NULL
+ * @param scans maximum number of scans to read
+ * @param timeout_ms time to wait for the first scan, -1 waits forever
+ * @return number of scans read, 0 on timeout or -1 on error
+ */
+int mraa_aio_stream_read_calibrated(mraa_aio_stream_context stream, float* values, int64_t* timestamps, int scans, int timeout_ms);
+
+/**
+ * Stop buffering. Scans still in the kernel buffer are dropped.
+ *
+ * @param stream The AIO stream context
+ * @return Result of operation
+ */
+mraa_result_t mraa_aio_stream_stop(mraa_aio_stream_context stream);
+
+/**
+ * Stop the stream if running and free it. The AIO contexts are not closed
+ * and must stay open as long as the stream exists.
+ *
+ * @param stream The AIO stream context
+ * @return Result of operation
+ */
+mraa_result_t mraa_aio_stream_close(mraa_aio_stream_context stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,8 @@
 #pragma once
 
 #include <stdexcept>
+#include <string>
+#include <vector>
 #include "aio.h"
 #include "types.hpp"
 
@@ -109,6 +111,97 @@ class Aio
         }
         return x;
     }
+    /**
+     * Read several AIO pins back to back, see mraa_aio_read_multi()
+     *
+     * @param pins the pins to read
+     * @param timestamp if not NULL receives the monotonic time of the
+     * reads in ns
+     * @throws std::invalid_argument in case of error
+     * @returns one value per pin, shifted like read()
+     */
+    static std::vector<unsigned int>
+    readMulti(const std::vector<Aio*>& pins, int64_t* timestamp = NULL)
+    {
+        std::vector<mraa_aio_context> devs(pins.size());
+        std::vector<int> values(pins.size());
+        for (size_t i = 0; i < pins.size(); i++) {
+            devs[i] = pins[i]->m_aio;
+        }
+        if (pins.empty() ||
+            mraa_aio_read_multi(&devs[0], (int) devs.size(), &values[0], timestamp) != MRAA_SUCCESS) {
+            throw std::invalid_argument("Unknown error in Aio::readMulti()");
+        }
+        return std::vector<unsigned int>(values.begin(), values.end());
+    }
+    /**
+     * Average several raw reads into every sample
+     *
+     * @param samples raw reads per sample, 1 disables averaging
+     * @return mraa::Result type
+     */
+    Result
+    setOversampling(unsigned int samples)
+    {
+        return (Result) mraa_aio_set_oversampling(m_aio, samples);
+    }
+    /**
+     * Set a linear calibration, units = (raw + offset) * scale
+     *
+     * @param scale units per ADC code
+     * @param offset added to the raw code before scaling
+     * @return mraa::Result type
+     */
+    Result
+    setCalibration(float scale, float offset = 0.0f)
+    {
+        return (Result) mraa_aio_set_calibration(m_aio, scale, offset);
+    }
+    /**
+     * Set a calibration table interpolated between points
+     *
+     * @param raw raw ADC codes, strictly increasing
+     * @param units value at each raw code
+     * @return mraa::Result type
+     */
+    Result
+    setCalibrationTable(const std::vector<float>& raw, const std::vector<float>& units)
+    {
+        if (raw.size() != units.size() || raw.size() < 2) {
+            return ERROR_INVALID_PARAMETER;
+        }
+        return (Result) mraa_aio_set_calibration_table(m_aio, &raw[0], &units[0], (int) raw.size());
+    }
+    /**
+     * Read the input in calibrated units
+     *
+     * @throws std::invalid_argument in case of error
+     * @returns calibrated value
+     */
+    float
+    readCalibrated()
+    {
+        float value;
+        if (mraa_aio_read_calibrated(m_aio, &value) != MRAA_SUCCESS) {
+            throw std::invalid_argument("Unknown error in Aio::readCalibrated()");
+        }
+        return value;
+    }
+    /**
+     * Convert raw ADC codes of this input to calibrated units
+     *
+     * @param raw raw ADC codes
+     * @returns calibrated values
+     */
+    std::vector<float>
+    convert(const std::vector<int32_t>& raw)
+    {
+        std::vector<float> units(raw.size());
+        if (!raw.empty()) {
+            mraa_aio_convert(m_aio, &raw[0], &units[0], (int) raw.size());
+        }
+        return units;
+    }
     /**
      * Set the bit value which mraa will shift the raw reading
      * from the ADC to. I.e. 10bits
@@ -134,4 +227,188 @@ class Aio
   private:
     mraa_aio_context m_aio;
 };
+
+/**
+ * @brief API to buffered, triggered analog input
+ *
+ * Samples a set of AIO pins from the IIO buffer of the ADC, one scan per
+ * trigger, and reads many scans at once.
+ */
+class AioStream
+{
+  public:
+    /**
+     * AioStream Constructor, takes the AIO pin numbers to sample in each
+     * scan
+     *
+     * @param pins AIO pins, as for Aio
+     */
+    AioStream(const std::vector<int>& pins) : m_stream(NULL)
+    {
+        for (size_t i = 0; i < pins.size(); i++) {
+            mraa_aio_context aio = mraa_aio_init(pins[i]);
+            if (aio == NULL) {
+                closePins();
+                throw std::invalid_argument("Invalid AIO pin specified - do you have an ADC?");
+            }
+            m_pins.push_back(aio);
+        }
+        if (!m_pins.empty()) {
+            m_stream = mraa_aio_stream_init(&m_pins[0], (int) m_pins.size());
+        }
+        if (m_stream == NULL) {
+            closePins();
+            throw std::invalid_argument("AIO pins cannot be streamed");
+        }
+    }
+    /**
+     * AioStream destructor, stops the stream
+     */
+    ~AioStream()
+    {
+        mraa_aio_stream_close(m_stream);
+        closePins();
+    }
+    /**
+     * Choose the trigger that starts each scan, creating an hrtimer
+     * trigger of that name if none exists
+     *
+     * @param trigger trigger name
+     * @param rateHz trigger sampling frequency, 0 to keep it
+     * @return Result of operation
+     */
+    Result
+    setTrigger(const std::string& trigger, unsigned int rateHz = 0)
+    {
+        return (Result) mraa_aio_stream_set_trigger(m_stream, trigger.c_str(), rateHz);
+    }
+    /**
+     * Size the kernel buffer
+     *
+     * @param length buffer length in scans, 0 for the driver default
+     * @param watermark scans before a read is woken, 0 for the driver default
+     * @return Result of operation
+     */
+    Result
+    setBuffer(unsigned int length, unsigned int watermark = 0)
+    {
+        return (Result) mraa_aio_stream_set_buffer(m_stream, length, watermark);
+    }
+    /**
+     * Average every factor scans into one
+     *
+     * @param factor scans per output, 1 disables decimation
+     * @return Result of operation
+     */
+    Result
+    setDecimation(unsigned int factor)
+    {
+        return (Result) mraa_aio_stream_set_decimation(m_stream, factor);
+    }
+    /**
+     * Start buffering
+     *
+     * @return Result of operation
+     */
+    Result
+    start()
+    {
+        return (Result) mraa_aio_stream_start(m_stream);
+    }
+    /**
+     * Stop buffering
+     *
+     * @return Result of operation
+     */
+    Result
+    stop()
+    {
+        return (Result) mraa_aio_stream_stop(m_stream);
+    }
+    /**
+     * Read buffered scans
+     *
+     * @param scans maximum number of scans to read
+     * @param timeoutMs time to wait for the first scan, -1 waits forever
+     * @throws std::runtime_error in case of error
+     * @return raw values, one per pin for each scan read, empty on timeout
+     */
+    std::vector<int32_t>
+    read(int scans, int timeoutMs = -1)
+    {
+        std::vector<int64_t> timestamps;
+        return read(scans, timestamps, timeoutMs);
+    }
+    /**
+     * Read buffered scans with their timestamps
+     *
+     * @param scans maximum number of scans to read
+     * @param timestamps filled with one timestamp in ns per scan read
+     * @param timeoutMs time to wait for the first scan, -1 waits forever
+     * @throws std::runtime_error in case of error
+     * @return raw values, one per pin for each scan read, empty on timeout
+     */
+    std::vector<int32_t>
+    read(int scans, std::vector<int64_t>& timestamps, int timeoutMs = -1)
+    {
+        std::vector<int32_t> values((size_t) scans * m_pins.size());
+        timestamps.resize(scans);
+        int got = scans > 0 ? mraa_aio_stream_read(m_stream, &values[0], &timestamps[0], scans, timeoutMs) : 0;
+        if (got < 0) {
+            throw std::runtime_error("AioStream::read() failed");
+        }
+        values.resize((size_t) got * m_pins.size());
+        timestamps.resize(got);
+        return values;
+    }
+
+    /**
+     * Read buffered scans in the calibrated units of each pin
+     *
+     * @param scans maximum number of scans to read
+     * @param timeoutMs time to wait for the first scan, -1 waits forever
+     * @throws std::runtime_error in case of error
+     * @return values, one per pin for each scan read, empty on timeout
+     */
+    std::vector<float>
+    readCalibrated(int scans, int timeoutMs = -1)
+    {
+        std::vector<float> values((size_t) scans * m_pins.size());
+        int got = scans > 0 ? mraa_aio_stream_read_calibrated(m_stream, &values[0], NULL, scans, timeoutMs) : 0;
+        if (got < 0) {
+            throw std::runtime_error("AioStream::readCalibrated() failed");
+        }
+        values.resize((size_t) got * m_pins.size());
+        return values;
+    }
+    /**
+     * Set a linear calibration on one pin of the stream
+     *
+     * @param index position of the pin in the constructor list
+     * @param scale units per ADC code
+     * @param offset added to the raw code before scaling
+     * @return Result of operation
+     */
+    Result
+    setCalibration(size_t index, float scale, float offset = 0.0f)
+    {
+        if (index >= m_pins.size()) {
+            return ERROR_INVALID_PARAMETER;
+        }
+        return (Result) mraa_aio_set_calibration(m_pins[index], scale, offset);
+    }
+
+  private:
+    void
+    closePins()
+    {
+        for (size_t i = 0; i < m_pins.size(); i++) {
+            mraa_aio_close(m_pins[i]);
+        }
+        m_pins.clear();
+    }
+
+    std::vector<mraa_aio_context> m_pins;
+    mraa_aio_stream_context m_stream;
+};
 }
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief Checksums for sensor frames and memory dumps
+ *
+ * Table driven CRCs used by the 1-Wire and Modbus modules, exposed for
+ * validating data read from devices. The CRC32 variants process eight
+ * bytes per step (slicing-by-8) and use the CRC instructions of ARMv8
+ * (CRC32 and CRC32C) and x86 SSE4.2 (CRC32C only) when the CPU has them.
+ *
+ * Every function takes the running value of a previous call as its last
+ * argument so long buffers can be checked in pieces. Pass the initial
+ * value listed with each function to start.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * CRC-8/MAXIM (Dallas 1-Wire), polynomial x^8 + x^5 + x^4 + 1, reflected
+ *
+ * @param buf data to checksum
+ * @param len length of data
+ * @param crc 0 to start, or the result of the previous piece
+ * @return updated crc, 0 over data followed by its crc
+ */
+uint8_t mraa_crc8_maxim(const uint8_t* buf, size_t len, uint8_t crc);
+
+/**
+ * CRC-16/IBM, polynomial 0x8005 reflected. Start with 0xFFFF for Modbus
+ * RTU or 0 for CRC-16/ARC.
+ *
+ * @param buf data to checksum
+ * @param len length of data
+ * @param crc initial value, or the result of the previous piece
+ * @return updated crc, send low byte first
+ */
+uint16_t mraa_crc16_ibm(const uint8_t* buf, size_t len, uint16_t crc);
+
+/**
+ * CRC-16/CCITT, polynomial 0x1021 not reflected. Start with 0xFFFF for
+ * CCITT-FALSE or 0 for XMODEM.
+ *
+ * @param buf data to checksum
+ * @param len length of data
+ * @param crc initial value, or the result of the previous piece
+ * @return updated crc, send high byte first
+ */
+uint16_t mraa_crc16_ccitt(const uint8_t* buf, size_t len, uint16_t crc);
+
+/**
+ * CRC-32 as used by Ethernet, zlib and PNG, polynomial 0x04C11DB7
+ * reflected. Pre and post inversion are done internally so the result
+ * can be fed back in directly.
+ *
+ * @param buf data to checksum
+ * @param len length of data
+ * @param crc 0 to start, or the result of the previous piece
+ * @return updated crc
+ */
+uint32_t mraa_crc32(const uint8_t* buf, size_t len, uint32_t crc);
+
+/**
+ * CRC-32C (Castagnoli), polynomial 0x1EDC6F41 reflected, as used by
+ * iSCSI, ext4 and many flash file systems. Chains like mraa_crc32().
+ *
+ * @param buf data to checksum
+ * @param len length of data
+ * @param crc 0 to start, or the result of the previous piece
+ * @return updated crc
+ */
+uint32_t mraa_crc32c(const uint8_t* buf, size_t len, uint32_t crc);
+
+#ifdef __cplusplus
+}
+#endif
@@ -97,7 +97,9 @@ typedef struct _iio* mraa_iio_context;
 mraa_iio_context mraa_iio_init(int device);
 
 /**
- * Trigger buffer
+ * Trigger buffer. Buffer and event callbacks of all devices run on one
+ * shared thread that waits on every device with epoll, so they should
+ * return quickly. A callback may close its own device.
  *
  * @param dev The iio context
  * @param fptr Callback
@@ -106,6 +108,62 @@ mraa_iio_context mraa_iio_init(int device);
  */
 mraa_result_t mraa_iio_trigger_buffer(mraa_iio_context dev, void (*fptr)(char*, void*), void* args);
 
+/**
+ * Size the kernel buffer of the device. Must be called while the buffer is
+ * disabled. The reader thread reads up to length scans at once and is
+ * woken when watermark scans are waiting.
+ *
+ * @param dev The iio context
+ * @param length buffer length in scans, 0 keeps the driver setting
+ * @param watermark scans before the reader is woken, 0 keeps the driver setting
+ * @return Result of operation
+ */
+mraa_result_t mraa_iio_set_buffer(mraa_iio_context dev, unsigned int length, unsigned int watermark);
+
+/**
+ * Trigger buffer with one callback per read. data holds scans whole scans
+ * of mraa_iio_read_size() bytes each, valid only during the callback.
+ * timestamp is the CLOCK_MONOTONIC time of the read in ns.
+ *
+ * @param dev The iio context
+ * @param fptr Callback
+ * @param args Arguments
+ * @return Result of operation
+ */
+mraa_result_t mraa_iio_trigger_buffer_batch(mraa_iio_context dev,
+                                            void (*fptr)(char* data, int scans, int64_t timestamp, void* args),
+                                            void* args);
+
+/**
+ * Trigger buffer into a ring instead of calling back, so a slow consumer
+ * never holds up the reader. When the ring is full new scans are dropped
+ * and counted as overruns.
+ *
+ * @param dev The iio context
+ * @param scans ring size in scans
+ * @return Result of operation
+ */
+mraa_result_t mraa_iio_trigger_buffer_ring(mraa_iio_context dev, unsigned int scans);
+
+/**
+ * Take scans out of the ring without blocking
+ *
+ * @param dev The iio context
+ * @param data room for scans * mraa_iio_read_size() bytes
+ * @param timestamps room for scans read times in ns, or NULL
+ * @param scans maximum number of scans to take
+ * @return number of scans taken or -1 if no ring is running
+ */
+int mraa_iio_ring_read(mraa_iio_context dev, char* data, int64_t* timestamps, int scans);
+
+/**
+ * Get the number of scans dropped because the ring was full
+ *
+ * @param dev The iio context
+ * @return overrun count
+ */
+unsigned long long mraa_iio_ring_overruns(mraa_iio_context dev);
+
 /**
  * Get device name
  *
@@ -167,11 +225,12 @@ mraa_result_t mraa_iio_read_float(mraa_iio_context dev, const char* filename, fl
 mraa_result_t mraa_iio_read_int(mraa_iio_context dev, const char* filename, int* data);
 
 /**
- * Read String from file
+ * Read String from file. The file is kept open after the first read so
+ * polling an attribute costs a single pread.
  *
  * @param dev The iio context
  * @param filename Filename
- * @param data Data
+ * @param data Data, NUL terminated when shorter than max_len
  * @param max_len Max lenght to read
  * @return Result of operation
  */
@@ -233,7 +292,8 @@ mraa_result_t mraa_iio_get_event_data(mraa_iio_context dev);
 mraa_result_t mraa_iio_event_poll(mraa_iio_context dev, struct iio_event_data* data);
 
 /**
- * Setup event callback
+ * Setup event callback, run on the thread shared with the buffer
+ * callbacks. Can be combined with a buffer callback on the same device.
  *
  * @param dev The iio context
  * @param fptr Callback
@@ -274,6 +334,205 @@ mraa_result_t mraa_iio_event_extract_event(struct iio_event_data* event,
  */
 mraa_result_t mraa_iio_get_mount_matrix(mraa_iio_context dev, const char *sysfs_name, float mm[9]);
 
+/**
+ * Split buffered scans into one array per channel, shifted, masked and
+ * sign extended. Channels stored as le:s16/16>>0 or le:s32/32>>0 are
+ * copied without any bit fiddling.
+ *
+ * @param dev The iio context
+ * @param data scans whole scans as read from the buffer
+ * @param scans number of scans
+ * @param channels scan indexes of the enabled channels to extract
+ * @param count number of channels
+ * @param out count arrays of scans values
+ * @return Result of operation
+ */
+mraa_result_t mraa_iio_demux(mraa_iio_context dev, const char* data, int scans, const int* channels, int count, int32_t** out);
+
+/**
+ * Split buffered scans into one float array per channel converted to
+ * units as (raw + offset) * scale. le:s16/16>>0 and le:s32/32>>0 channels
+ * are converted with SSE2 or NEON.
+ *
+ * @param dev The iio context
+ * @param data scans whole scans as read from the buffer
+ * @param scans number of scans
+ * @param channels scan indexes of the enabled channels to extract
+ * @param count number of channels
+ * @param scale count scales, or NULL for 1
+ * @param offset count offsets, or NULL for 0
+ * @param out count arrays of scans values
+ * @return Result of operation
+ */
+mraa_result_t mraa_iio_demux_float(mraa_iio_context dev,
+                                   const char* data,
+                                   int scans,
+                                   const int* channels,
+                                   int count,
+                                   const float* scale,
+                                   const float* offset,
+                                   float** out);
+
+/**
+ * Rotate blocks of x, y and z samples in place by a mount matrix from
+ * mraa_iio_get_mount_matrix(), x' = mm[0] x + mm[1] y + mm[2] z and so on.
+ *
+ * @param mm row major 3x3 matrix
+ * @param x x samples
+ * @param y y samples
+ * @param z z samples
+ * @param scans number of samples in each array
+ * @return Result of operation
+ */
+mraa_result_t mraa_iio_apply_mount_matrix(const float mm[9], float* x, float* y, float* z, int scans);
+
+/**
+ * Get the _scale and _offset of a scan element, using the attributes
+ * shared by its type (in_accel_scale for in_accel_x) when it has none of
+ * its own. Missing attributes give scale 1 and offset 0.
+ *
+ * @param dev The iio context
+ * @param index scan index of the channel
+ * @param scale Receives the scale
+ * @param offset Receives the offset
+ * @return Result of operation
+ */
+mraa_result_t mraa_iio_get_channel_scale(mraa_iio_context dev, int index, float* scale, float* offset);
+
+/**
+ * Opaque pointer to a time alignment stage over several IIO devices
+ */
+typedef struct _iio_sync* mraa_iio_sync_context;
+
+/**
+ * How aligned samples are computed from the two around each output time
+ */
+typedef enum {
+    MRAA_IIO_SYNC_LINEAR = 0,  /**< linear interpolation */
+    MRAA_IIO_SYNC_NEAREST = 1  /**< the closer of the two samples */
+} mraa_iio_sync_mode_t;
+
+/**
+ * Create a stage that resamples streams from several devices, gyro,
+ * accel and magnetometer say, onto one common time base. Each output
+ * tuple holds the channels of every stream in the order they were added.
+ * All memory is allocated when streams are added.
+ *
+ * @param rate_hz output rate
+ * @param mode interpolation
+ * @return sync context or NULL
+ */
+mraa_iio_sync_context mraa_iio_sync_init(double rate_hz, mraa_iio_sync_mode_t mode);
+
+/**
+ * Add a device to the stage. Samples are taken from its ring, see
+ * mraa_iio_trigger_buffer_ring(), or handed in with mraa_iio_sync_push().
+ * Channels are converted to units with the driver's _scale and _offset.
+ * Streams can only be added before the first mraa_iio_sync_read().
+ *
+ * @param sync sync context
+ * @param dev The iio context
+ * @param channels scan indexes of the channels to align
+ * @param count number of channels
+ * @param ts_channel scan index of in_timestamp, or -1 to stamp scans with
+ * the time they were read
+ * @param depth samples held for the stream, enough to cover the slowest
+ * stream's latency
+ * @return stream number or -1
+ */
+int mraa_iio_sync_add_stream(mraa_iio_sync_context sync,
+                             mraa_iio_context dev,
+                             const int* channels,
+                             int count,
+                             int ts_channel,
+                             unsigned int depth);
+
+/**
+ * Override the unit conversion of a stream, (raw + offset) * scale
+ *
+ * @param sync sync context
+ * @param stream stream number
+ * @param scale one per channel, or NULL for 1
+ * @param offset one per channel, or NULL for 0
+ * @return Result of operation
+ */
+mraa_result_t mraa_iio_sync_set_scale(mraa_iio_sync_context sync, int stream, const float* scale, const float* offset);
+
+/**
+ * Hand whole scans of a stream to the stage, for devices read through a
+ * batch callback. When the stream is full the oldest samples are dropped.
+ *
+ * @param sync sync context
+ * @param stream stream number
+ * @param data scans as read from the buffer
+ * @param scans number of scans
+ * @param read_time CLOCK_MONOTONIC time the scans were read, ns
+ * @return Result of operation
+ */
+mraa_result_t mraa_iio_sync_push(mraa_iio_sync_context sync, int stream, const char* data, int scans, int64_t read_time);
+
+/**
+ * Emit the aligned tuples that every stream has samples on both sides
+ * of. Output times start at the first time all streams have data and
+ * follow the output rate; gaps where samples were dropped are skipped.
+ *
+ * @param sync sync context
+ * @param values max tuples of mraa_iio_sync_width() floats
+ * @param timestamps max output times in ns, or NULL
+ * @param max most tuples to emit
+ * @return number of tuples emitted or -1
+ */
+int mraa_iio_sync_read(mraa_iio_sync_context sync, float* values, int64_t* timestamps, int max);
+
+/**
+ * Get the number of floats in each output tuple
+ *
+ * @param sync sync context
+ * @return channels over all streams or -1
+ */
+int mraa_iio_sync_width(mraa_iio_sync_context sync);
+
+/**
+ * Estimate how far a stream's timestamps lag the host CLOCK_MONOTONIC,
+ * from the smallest gap between sample time and read time over a sliding
+ * window. It includes the shortest transfer latency, so differences
+ * between streams are the relative offsets of their clocks.
+ *
+ * @param sync sync context
+ * @param stream stream number
+ * @param offset_ns estimated offset
+ * @return Result of operation, MRAA_ERROR_INVALID_RESOURCE before any data
+ */
+mraa_result_t mraa_iio_sync_clock_offset(mraa_iio_sync_context sync, int stream, int64_t* offset_ns);
+
+/**
+ * Add each stream's estimated clock offset to its timestamps as they come
+ * in, for devices stamping with different clocks
+ *
+ * @param sync sync context
+ * @param enable 1 to correct, 0 to use the device timestamps as they are
+ * @return Result of operation
+ */
+mraa_result_t mraa_iio_sync_set_clock_correction(mraa_iio_sync_context sync, mraa_boolean_t enable);
+
+/**
+ * Get the number of samples of a stream dropped because it was full or
+ * went back in time
+ *
+ * @param sync sync context
+ * @param stream stream number
+ * @return dropped samples
+ */
+unsigned long long mraa_iio_sync_overruns(mraa_iio_sync_context sync, int stream);
+
+/**
+ * Free a sync context. The devices are left as they are.
+ *
+ * @param sync sync context
+ * @return Result of operation
+ */
+mraa_result_t mraa_iio_sync_close(mraa_iio_sync_context sync);
+
 /**
  * Create trigger
  *
@@ -292,7 +551,19 @@ mraa_result_t mraa_iio_create_trigger(mraa_iio_context dev, const char* trigger)
 mraa_result_t mraa_iio_update_channels(mraa_iio_context dev);
 
 /**
- * De-inits an mraa_iio_context device
+ * Drop what is cached about a device: its channels, events and open
+ * attribute files. They are read from sysfs again on the next
+ * mraa_iio_init(). Use after the driver was reloaded or reconfigured
+ * behind mraa's back; the device must not be in use meanwhile.
+ *
+ * @param dev The iio context
+ * @return Result of operation
+ */
+mraa_result_t mraa_iio_invalidate(mraa_iio_context dev);
+
+/**
+ * De-inits an mraa_iio_context device. Stops the buffer reader; the
+ * channel layout stays cached for the next mraa_iio_init().
  *
  * @param dev The iio context
  * @return Result of operation
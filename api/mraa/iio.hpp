@@ -30,6 +30,7 @@
 #include "types.hpp"
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
 namespace mraa
 {
@@ -58,6 +59,14 @@ class IioHandler
   public:
     /** onIioEvent Handler */
     virtual void onIioEvent(const IioEventData& eventData) = 0;
+    /**
+     * onIioScans Handler, called once per buffer read
+     *
+     * @param data scans whole scans, valid during the call only
+     * @param scans number of scans
+     * @param timestamp monotonic time of the read in ns
+     */
+    virtual void onIioScans(const char* data, int scans, int64_t timestamp) {};
     /** Destructor */
     virtual ~IioHandler(){}; // add an empty destructor to get rid of warning
 };
@@ -244,7 +253,83 @@ class Iio
         }
     }
 
+    /**
+     * Size the kernel buffer, see mraa_iio_set_buffer()
+     *
+     * @param length buffer length in scans, 0 keeps the driver setting
+     * @param watermark scans before the reader is woken, 0 keeps the driver setting
+     *
+     * @throws std::runtime_error on failure
+     */
+    void
+    setBuffer(unsigned int length, unsigned int watermark = 0) const
+    {
+        if (mraa_iio_set_buffer(m_iio, length, watermark) != MRAA_SUCCESS) {
+            throw std::runtime_error("setBuffer failed");
+        }
+    }
+
+    /**
+     * Register buffer handler, onIioScans is called once per read
+     *
+     * @param handler handler class that implements IioHandler
+     *
+     * @throws std::runtime_error on failure
+     */
+    void
+    registerBufferHandler(IioHandler* handler) const
+    {
+        mraa_result_t res = mraa_iio_trigger_buffer_batch(m_iio, private_scans_handler, handler);
+        if (res != MRAA_SUCCESS) {
+            throw std::runtime_error("registerBufferHandler failed");
+        }
+    }
+
+    /**
+     * Start reading the buffer into a ring, taken out with readRing()
+     *
+     * @param scans ring size in scans
+     *
+     * @throws std::runtime_error on failure
+     */
+    void
+    startRing(unsigned int scans) const
+    {
+        if (mraa_iio_trigger_buffer_ring(m_iio, scans) != MRAA_SUCCESS) {
+            throw std::runtime_error("startRing failed");
+        }
+    }
+
+    /**
+     * Take up to scans scans out of the ring without blocking
+     *
+     * @param scans maximum number of scans
+     * @return raw scans, a multiple of the scan size
+     *
+     * @throws std::runtime_error if no ring is running
+     */
+    std::vector<char>
+    readRing(int scans) const
+    {
+        int size = mraa_iio_read_size(m_iio);
+        std::vector<char> data((size_t) (scans > 0 ? scans : 0) * size + 1);
+        int got = mraa_iio_ring_read(m_iio, &data[0], NULL, scans);
+        if (got < 0) {
+            throw std::runtime_error("readRing failed");
+        }
+        data.resize((size_t) got * size);
+        return data;
+    }
+
   private:
+    static void
+    private_scans_handler(char* data, int scans, int64_t timestamp, void* args)
+    {
+        if (args != NULL) {
+            ((IioHandler*) args)->onIioScans(data, scans, timestamp);
+        }
+    }
+
     static void
     private_event_handler(iio_event_data* data, void* args)
     {
@@ -265,6 +350,120 @@ class Iio
         }
     }
 
+    friend class IioSync;
     mraa_iio_context m_iio;
 };
+
+/**
+ * @brief API to align samples of several IIO devices in time
+ *
+ * Resamples the rings of several devices onto one output rate, see
+ * mraa_iio_sync_init()
+ */
+class IioSync
+{
+  public:
+    /**
+     * IioSync constructor
+     *
+     * @param rateHz output rate
+     * @param mode interpolation
+     *
+     * @throws std::invalid_argument if initialization fails
+     */
+    IioSync(double rateHz, mraa_iio_sync_mode_t mode = MRAA_IIO_SYNC_LINEAR)
+    {
+        m_sync = mraa_iio_sync_init(rateHz, mode);
+        if (m_sync == NULL) {
+            throw std::invalid_argument("Invalid IIO sync rate or mode");
+        }
+    }
+
+    /**
+     * IioSync destructor, the devices are left as they are
+     */
+    ~IioSync()
+    {
+        mraa_iio_sync_close(m_sync);
+    }
+
+    /**
+     * Add a device whose ring is running
+     *
+     * @param iio device
+     * @param channels scan indexes of the channels to align
+     * @param tsChannel scan index of in_timestamp or -1
+     * @param depth samples held for the stream
+     * @return stream number
+     *
+     * @throws std::invalid_argument if the stream cannot be added
+     */
+    int
+    addStream(Iio& iio, const std::vector<int>& channels, int tsChannel, unsigned int depth)
+    {
+        int stream = mraa_iio_sync_add_stream(m_sync, iio.m_iio, channels.empty() ? NULL : &channels[0],
+                                              (int) channels.size(), tsChannel, depth);
+        if (stream < 0) {
+            throw std::invalid_argument("Invalid IIO sync stream");
+        }
+        return stream;
+    }
+
+    /**
+     * Emit aligned tuples, mraa_iio_sync_width() floats each
+     *
+     * @param maxTuples most tuples to emit
+     * @param timestamps filled with the output times in ns
+     * @return tuples one after the other
+     *
+     * @throws std::runtime_error on failure
+     */
+    std::vector<float>
+    read(int maxTuples, std::vector<int64_t>& timestamps)
+    {
+        int width = mraa_iio_sync_width(m_sync);
+        std::vector<float> values((size_t) (maxTuples > 0 ? maxTuples : 0) * width + 1);
+        timestamps.resize((size_t) (maxTuples > 0 ? maxTuples : 0) + 1);
+        int got = mraa_iio_sync_read(m_sync, &values[0], &timestamps[0], maxTuples);
+        if (got < 0) {
+            throw std::runtime_error("IioSync read failed");
+        }
+        values.resize((size_t) got * width);
+        timestamps.resize(got);
+        return values;
+    }
+
+    /**
+     * Get the estimated lag of a stream's timestamps behind CLOCK_MONOTONIC
+     *
+     * @param stream stream number
+     * @return offset in ns
+     *
+     * @throws std::runtime_error before the stream has data
+     */
+    int64_t
+    clockOffset(int stream)
+    {
+        int64_t offset;
+        if (mraa_iio_sync_clock_offset(m_sync, stream, &offset) != MRAA_SUCCESS) {
+            throw std::runtime_error("No IIO sync clock offset yet");
+        }
+        return offset;
+    }
+
+    /**
+     * Move each stream's timestamps onto the host clock as they come in
+     *
+     * @param enable true to correct
+     * @return Result of operation
+     */
+    Result
+    setClockCorrection(bool enable)
+    {
+        return (Result) mraa_iio_sync_set_clock_correction(m_sync, enable ? 1 : 0);
+    }
+
+  private:
+    mraa_iio_sync_context m_sync;
+};
 }
@@ -125,11 +125,13 @@ typedef struct _mraa_io_descriptor {
   *              s:0x1:mode2:400000  # spi bus 1, mode2 (CPOL = 1, CPHA = 0), 400 KHz
   *
   *      UART
-  *          UART_KEY:uart ndx[:baud:mode]
+  *          UART_KEY:uart ndx[:baud:mode[:rs485[:de gpio]]]
   *
   *          examples:
   *              u:1                 # uart bus 1
   *              u:0x1:9600:8N1      # uart bus 1, 9600 baud, 8 bit byte, no parity, 1 stop bit
+  *              u:1:19200:8E1:rs485 # uart bus 1, RS-485 with the driver toggling RTS as DE
+  *              u:1:19200:8E1:rs485:12 # as above, gpio 12 as DE if the driver has no RS-485
   *
   *      UART_OW
   *          UART_OW_KEY:uart_ow ndx
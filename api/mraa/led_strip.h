@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief Addressable LED strip over SPI
+ *
+ * Drives WS2812 and SK6812 style single wire LED strips from a SPI MOSI
+ * line. Every data bit is sent as four SPI bits at 3.2 MHz, 1000 for a 0
+ * and 1110 for a 1, followed by a low reset period that latches the frame.
+ * Frames are sent from a background thread so the next frame can be
+ * filled and encoded while the previous one is still on the wire.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "common.h"
+
+/**
+ * LED strip chip types
+ */
+typedef enum {
+    MRAA_LED_STRIP_WS2812 = 0,      /**< 3 channels, sent G R B */
+    MRAA_LED_STRIP_SK6812_RGBW = 1, /**< 4 channels, sent G R B W */
+} mraa_led_strip_type_t;
+
+/**
+ * Opaque pointer definition to the internal struct _led_strip
+ */
+typedef struct _led_strip* mraa_led_strip_context;
+
+/**
+ * Initialise a LED strip on a SPI bus, uses board mapping. Each frame is
+ * sent as a single spidev message, so mraa_led_strip_frame_size() must not
+ * exceed the spidev bufsiz module parameter (4096 by default, about 330
+ * RGB LEDs). Longer strips need spidev loaded with a larger bufsiz, e.g.
+ * spidev.bufsiz=65536 on the kernel command line, or init fails.
+ *
+ * @param bus SPI bus to use, as listed in platform definition
+ * @param count number of LEDs on the strip
+ * @param type LED chip type
+ * @return LED strip context or NULL
+ */
+mraa_led_strip_context mraa_led_strip_init(int bus, int count, mraa_led_strip_type_t type);
+
+/**
+ * Set the colour of one LED. Takes effect on the next mraa_led_strip_show().
+ *
+ * @param dev The LED strip context
+ * @param index LED index starting at 0
+ * @param r red level
+ * @param g green level
+ * @param b blue level
+ * @param w white level, ignored by 3 channel strips
+ * @return Result of operation
+ */
+mraa_result_t mraa_led_strip_set_pixel(mraa_led_strip_context dev, int index, uint8_t r, uint8_t g, uint8_t b, uint8_t w);
+
+/**
+ * Set every LED to the same colour
+ *
+ * @param dev The LED strip context
+ * @param r red level
+ * @param g green level
+ * @param b blue level
+ * @param w white level, ignored by 3 channel strips
+ * @return Result of operation
+ */
+mraa_result_t mraa_led_strip_fill(mraa_led_strip_context dev, uint8_t r, uint8_t g, uint8_t b, uint8_t w);
+
+/**
+ * Set global brightness applied when frames are encoded
+ *
+ * @param dev The LED strip context
+ * @param brightness 0 (off) to 255 (full)
+ * @return Result of operation
+ */
+mraa_result_t mraa_led_strip_set_brightness(mraa_led_strip_context dev, uint8_t brightness);
+
+/**
+ * Set gamma correction applied when frames are encoded
+ *
+ * @param dev The LED strip context
+ * @param gamma gamma exponent, 1.0 disables correction
+ * @return Result of operation
+ */
+mraa_result_t mraa_led_strip_set_gamma(mraa_led_strip_context dev, float gamma);
+
+/**
+ * Size in bytes of an encoded frame, including the latch period
+ *
+ * @param dev The LED strip context
+ * @return frame size or -1 in case of error
+ */
+int mraa_led_strip_frame_size(mraa_led_strip_context dev);
+
+/**
+ * Encode the current pixels into a SPI bitstream without sending it
+ *
+ * @param dev The LED strip context
+ * @param buf buffer of at least mraa_led_strip_frame_size() bytes
+ * @return Result of operation
+ */
+mraa_result_t mraa_led_strip_render(mraa_led_strip_context dev, uint8_t* buf);
+
+/**
+ * Encode the current pixels and queue them for sending. Returns once the
+ * frame is handed to the sender thread, waiting only if the previous frame
+ * is still being sent.
+ *
+ * @param dev The LED strip context
+ * @return Result of operation, including failure of the previous frame
+ */
+mraa_result_t mraa_led_strip_show(mraa_led_strip_context dev);
+
+/**
+ * Wait until the last queued frame has been sent
+ *
+ * @param dev The LED strip context
+ * @return Result of the last transfer
+ */
+mraa_result_t mraa_led_strip_flush(mraa_led_strip_context dev);
+
+/**
+ * Send any queued frame and de-init the LED strip and its SPI bus
+ *
+ * @param dev The LED strip context
+ * @return Result of operation
+ */
+mraa_result_t mraa_led_strip_close(mraa_led_strip_context dev);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief Modbus RTU master
+ *
+ * Modbus RTU master running on a mraa UART. Frame timing is derived from
+ * the UART baudrate: requests are only sent after the bus has been idle for
+ * 3.5 character times, and responses are considered complete as soon as
+ * their length is known from the function code, so consecutive
+ * transactions follow each other as closely as the protocol allows.
+ * A poll scheduler can repeat read requests to many slaves from a
+ * background thread.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "common.h"
+#include "uart.h"
+
+/** Highest unicast slave address */
+#define MRAA_MODBUS_MAX_SLAVE 247
+
+/** Mraa Modbus Context */
+typedef struct _modbus* mraa_modbus_context;
+
+/**
+ * Per slave statistics
+ */
+typedef struct {
+    unsigned long long requests;   /**< requests sent */
+    unsigned long long responses;  /**< valid responses received */
+    unsigned long long timeouts;   /**< requests without a complete response */
+    unsigned long long crc_errors; /**< responses with a bad CRC or framing */
+    unsigned long long exceptions; /**< exception responses */
+    unsigned int min_latency_us;   /**< fastest request to response time */
+    unsigned int max_latency_us;   /**< slowest request to response time */
+    unsigned int mean_latency_us;  /**< average request to response time */
+} mraa_modbus_stats_t;
+
+/**
+ * Callback with the result of a scheduled poll. values is only valid during
+ * the call and holds count registers on success.
+ */
+typedef void (*mraa_modbus_poll_cb)(uint8_t slave, uint8_t function, uint16_t address, const uint16_t* values, int count, mraa_result_t result, void* args);
+
+/**
+ * Create a Modbus RTU master on an open UART. The UART is not owned by the
+ * master and must stay open; set its baudrate and mode first, or call
+ * mraa_modbus_update_timing() after changing them.
+ *
+ * @param uart uart context
+ * @return modbus context or NULL
+ */
+mraa_modbus_context mraa_modbus_init(mraa_uart_context uart);
+
+/**
+ * Recompute the inter-frame timing from the current UART baudrate
+ *
+ * @param dev modbus context
+ * @return Result of operation
+ */
+mraa_result_t mraa_modbus_update_timing(mraa_modbus_context dev);
+
+/**
+ * Set how long to wait for the first byte of a response
+ *
+ * @param dev modbus context
+ * @param timeout_ms response timeout in milliseconds
+ * @return Result of operation
+ */
+mraa_result_t mraa_modbus_set_timeout(mraa_modbus_context dev, unsigned int timeout_ms);
+
+/**
+ * Send a raw request PDU and receive the response PDU. Exception responses
+ * are returned as they are, with the high bit of the function code set.
+ *
+ * @param dev modbus context
+ * @param slave slave address, 0 broadcasts and does not wait for a response
+ * @param request request PDU, function code first
+ * @param length bytes in request, at most 253
+ * @param response buffer for the response PDU
+ * @param max_length size of response
+ * @return response PDU length, 0 for broadcasts or -1 in case of error
+ */
+int mraa_modbus_transact(mraa_modbus_context dev, uint8_t slave, const uint8_t* request, int length, uint8_t* response, int max_length);
+
+/**
+ * Read holding registers (function 3)
+ *
+ * @param dev modbus context
+ * @param slave slave address
+ * @param address first register
+ * @param count number of registers, 1 to 125
+ * @param values buffer for count registers
+ * @return Result of operation, MRAA_ERROR_NO_DATA_AVAILABLE on timeout,
+ * MRAA_ERROR_MODBUS_FRAME for a corrupt response or
+ * MRAA_ERROR_MODBUS_EXCEPTION, see mraa_modbus_last_exception()
+ */
+mraa_result_t mraa_modbus_read_holding_registers(mraa_modbus_context dev, uint8_t slave, uint16_t address, int count, uint16_t* values);
+
+/**
+ * Read input registers (function 4)
+ *
+ * @param dev modbus context
+ * @param slave slave address
+ * @param address first register
+ * @param count number of registers, 1 to 125
+ * @param values buffer for count registers
+ * @return Result of operation
+ */
+mraa_result_t mraa_modbus_read_input_registers(mraa_modbus_context dev, uint8_t slave, uint16_t address, int count, uint16_t* values);
+
+/**
+ * Write a single holding register (function 6)
+ *
+ * @param dev modbus context
+ * @param slave slave address, 0 to broadcast
+ * @param address register
+ * @param value value to write
+ * @return Result of operation
+ */
+mraa_result_t mraa_modbus_write_register(mraa_modbus_context dev, uint8_t slave, uint16_t address, uint16_t value);
+
+/**
+ * Write consecutive holding registers (function 16)
+ *
+ * @param dev modbus context
+ * @param slave slave address, 0 to broadcast
+ * @param address first register
+ * @param count number of registers, 1 to 123
+ * @param values registers to write
+ * @return Result of operation
+ */
+mraa_result_t mraa_modbus_write_registers(mraa_modbus_context dev, uint8_t slave, uint16_t address, int count, const uint16_t* values);
+
+/**
+ * Exception code of the last exception response. Requests of the poll
+ * scheduler count as transactions too.
+ *
+ * @param dev modbus context
+ * @return exception code, 0 if the last transaction had none
+ */
+int mraa_modbus_last_exception(mraa_modbus_context dev);
+
+/**
+ * Get statistics for one slave
+ *
+ * @param dev modbus context
+ * @param slave slave address
+ * @param stats filled with the counters of that slave
+ * @return Result of operation
+ */
+mraa_result_t mraa_modbus_get_stats(mraa_modbus_context dev, uint8_t slave, mraa_modbus_stats_t* stats);
+
+/**
+ * Schedule a register read repeated every period_ms by the poll thread.
+ * Must be called while the poll thread is stopped.
+ *
+ * @param dev modbus context
+ * @param slave slave address
+ * @param function 3 for holding or 4 for input registers
+ * @param address first register
+ * @param count number of registers, 1 to 125
+ * @param period_ms interval between reads, 0 polls as often as the bus allows
+ * @param cb callback run from the poll thread with every result
+ * @param args argument passed to cb
+ * @return Result of operation
+ */
+mraa_result_t mraa_modbus_poll_add(mraa_modbus_context dev, uint8_t slave, uint8_t function, uint16_t address, int count, unsigned int period_ms, mraa_modbus_poll_cb cb, void* args);
+
+/**
+ * Start the poll thread. Due requests are sent back to back, earliest
+ * deadline first. Direct transactions remain possible and are serialised
+ * with the poller.
+ *
+ * @param dev modbus context
+ * @return Result of operation
+ */
+mraa_result_t mraa_modbus_poll_start(mraa_modbus_context dev);
+
+/**
+ * Stop the poll thread
+ *
+ * @param dev modbus context
+ * @return Result of operation
+ */
+mraa_result_t mraa_modbus_poll_stop(mraa_modbus_context dev);
+
+/**
+ * Stop polling and free the modbus context. The UART is left open.
+ *
+ * @param dev modbus context
+ * @return Result of operation
+ */
+mraa_result_t mraa_modbus_close(mraa_modbus_context dev);
+
+#ifdef __cplusplus
+}
+#endif
@@ -50,6 +50,46 @@ extern "C" {
 /** Mraa Pwm Context */
 typedef struct _pwm* mraa_pwm_context;
 
+/**
+ * What a sequence does after its last step
+ */
+typedef enum {
+    MRAA_PWM_SEQ_ONESHOT = 0, /**< hold the last step and finish */
+    MRAA_PWM_SEQ_LOOP = 1     /**< start again from the first step */
+} mraa_pwm_seq_mode_t;
+
+/**
+ * One update of a sequence
+ */
+typedef struct {
+    int period_ns; /**< period in nanoseconds */
+    int duty_ns;   /**< pulsewidth in nanoseconds, 0 to period_ns */
+} mraa_pwm_step_t;
+
+/**
+ * Sequence generator, called from the player thread once per update.
+ * step arrives holding the period and duty currently output.
+ *
+ * @param index update number since the sequence started, skips when
+ *        updates were missed so it always tracks time
+ * @param step set to the next output
+ * @param args user data given to mraa_pwm_seq_play_gen()
+ * @return 1 to output step, 0 to finish the sequence
+ */
+typedef int (*mraa_pwm_seq_gen_t)(unsigned long long index, mraa_pwm_step_t* step, void* args);
+
+/**
+ * Sequence player statistics
+ */
+typedef struct {
+    unsigned long long updates;  /**< steps written */
+    unsigned long long missed;   /**< updates skipped because the thread ran late */
+    unsigned long long errors;   /**< writes that failed */
+    long long max_lateness_ns;   /**< worst update time deviation from schedule */
+    long long mean_lateness_ns;  /**< average update time deviation from schedule */
+    float rate_hz;               /**< achieved update rate of the current sequence */
+} mraa_pwm_seq_stats_t;
+
 /**
  * Initialise pwm_context, uses board mapping
  *
@@ -142,6 +182,19 @@ mraa_result_t mraa_pwm_pulsewidth_ms(mraa_pwm_context dev, int ms);
  */
 mraa_result_t mraa_pwm_pulsewidth_us(mraa_pwm_context dev, int us);
 
+/**
+ * Set period and pulsewidth together, nanoseconds. Only the values that
+ * differ from the last ones written reach the kernel, ordered so the
+ * duty never exceeds the period in between. On kernels with the pwm
+ * character device both are applied atomically.
+ *
+ * @param dev The Pwm context to use
+ * @param period_ns Period in nanoseconds, within the platform range
+ * @param duty_ns Pulsewidth in nanoseconds, 0 to period_ns
+ * @return Result of operation
+ */
+mraa_result_t mraa_pwm_config(mraa_pwm_context dev, int period_ns, int duty_ns);
+
 /**
  * Set the enable status of the PWM pin. None zero will assume on with output being driven.
  *   and 0 will disable the output.
@@ -169,6 +222,76 @@ mraa_result_t mraa_pwm_owner(mraa_pwm_context dev, mraa_boolean_t owner);
  */
 mraa_result_t mraa_pwm_close(mraa_pwm_context dev);
 
+/**
+ * Play duty cycles at a fixed rate from a timer driven thread, keeping
+ * the current period. Playing while a sequence runs replaces it at once.
+ * The context must not be written from elsewhere until the player is
+ * stopped. Writes go through the same platform hooks as mraa_pwm_write().
+ *
+ * @param dev The Pwm context to use
+ * @param duty duty cycles as for mraa_pwm_write(), 0.0 to 1.0, copied
+ * @param count number of steps in duty
+ * @param rate_hz updates per second
+ * @param mode what to do after the last step
+ * @param crossfade_ms blend from the current output into the sequence
+ *        over this time, 0 to switch at once
+ * @return Result of operation
+ */
+mraa_result_t mraa_pwm_seq_play(mraa_pwm_context dev, const float* duty, unsigned int count, unsigned int rate_hz, mraa_pwm_seq_mode_t mode, unsigned int crossfade_ms);
+
+/**
+ * Play period and duty pairs, otherwise like mraa_pwm_seq_play(). Use
+ * for tones, where the period changes with every step.
+ *
+ * @param dev The Pwm context to use
+ * @param steps period and pulsewidth of every step, copied
+ * @param count number of steps
+ * @param rate_hz updates per second
+ * @param mode what to do after the last step
+ * @param crossfade_ms blend time from the current output, 0 for none
+ * @return Result of operation
+ */
+mraa_result_t mraa_pwm_seq_play_steps(mraa_pwm_context dev, const mraa_pwm_step_t* steps, unsigned int count, unsigned int rate_hz, mraa_pwm_seq_mode_t mode, unsigned int crossfade_ms);
+
+/**
+ * Play steps computed by a generator, otherwise like mraa_pwm_seq_play().
+ * The sequence finishes when the generator returns 0.
+ *
+ * @param dev The Pwm context to use
+ * @param gen generator called once per update
+ * @param args passed to gen
+ * @param rate_hz updates per second
+ * @param crossfade_ms blend time from the current output, 0 for none
+ * @return Result of operation
+ */
+mraa_result_t mraa_pwm_seq_play_gen(mraa_pwm_context dev, mraa_pwm_seq_gen_t gen, void* args, unsigned int rate_hz, unsigned int crossfade_ms);
+
+/**
+ * Wait for a one-shot sequence to finish
+ *
+ * @param dev The Pwm context to use
+ * @param timeout_ms time to wait, -1 for no limit
+ * @return MRAA_SUCCESS once finished, MRAA_ERROR_NO_DATA_AVAILABLE on timeout
+ */
+mraa_result_t mraa_pwm_seq_wait(mraa_pwm_context dev, int timeout_ms);
+
+/**
+ * Get statistics of the sequence player
+ *
+ * @param dev The Pwm context to use
+ * @param stats filled with the current statistics
+ * @return Result of operation
+ */
+mraa_result_t mraa_pwm_seq_get_stats(mraa_pwm_context dev, mraa_pwm_seq_stats_t* stats);
+
+/**
+ * Stop the sequence player. The output keeps the last step written.
+ *
+ * @param dev The Pwm context to use
+ * @return Result of operation
+ */
+mraa_result_t mraa_pwm_seq_stop(mraa_pwm_context dev);
+
 /**
  * Get the maximum pwm period in us
  *
@@ -182,6 +182,55 @@ class Pwm
     {
         return (Result) mraa_pwm_pulsewidth_us(m_pwm, us);
     }
+    /**
+     * Set period and pulsewidth in one call, nanoseconds
+     *
+     * @param periodNs period in nanoseconds
+     * @param dutyNs pulsewidth in nanoseconds
+     * @return Result of operation
+     */
+    Result
+    config(int periodNs, int dutyNs)
+    {
+        return (Result) mraa_pwm_config(m_pwm, periodNs, dutyNs);
+    }
+    /**
+     * Play duty cycles at a fixed rate from a player thread
+     *
+     * @param duty duty cycles, 0.0 to 1.0, copied
+     * @param count number of duty cycles
+     * @param rateHz updates per second
+     * @param loop start again after the last step instead of holding it
+     * @param crossfadeMs blend time from the current output, 0 for none
+     * @return Result of operation
+     */
+    Result
+    seqPlay(const float* duty, unsigned int count, unsigned int rateHz, bool loop = false, unsigned int crossfadeMs = 0)
+    {
+        return (Result) mraa_pwm_seq_play(m_pwm, duty, count, rateHz,
+                                          loop ? MRAA_PWM_SEQ_LOOP : MRAA_PWM_SEQ_ONESHOT, crossfadeMs);
+    }
+    /**
+     * Wait for a one-shot sequence to finish
+     *
+     * @param timeoutMs time to wait, -1 for no limit
+     * @return Result of operation, ERROR_NO_DATA_AVAILABLE on timeout
+     */
+    Result
+    seqWait(int timeoutMs = -1)
+    {
+        return (Result) mraa_pwm_seq_wait(m_pwm, timeoutMs);
+    }
+    /**
+     * Stop the sequence player, the last step stays on the output
+     *
+     * @return Result of operation
+     */
+    Result
+    seqStop()
+    {
+        return (Result) mraa_pwm_seq_stop(m_pwm);
+    }
     /**
      * Set the enable status of the PWM pin. None zero will assume on with
      * output being driven and 0 will disable the output
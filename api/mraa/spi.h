@@ -48,6 +48,7 @@ extern "C" {
 #include <stdint.h>
 
 #include "common.h"
+#include "gpio.h"
 
 /**
  * MRAA SPI Modes
@@ -68,6 +69,18 @@ typedef enum {
  */
 typedef struct _spi* mraa_spi_context;
 
+/**
+ * SPI streaming statistics
+ */
+typedef struct {
+    unsigned long long transfers; /**< transfers completed and queued */
+    unsigned long long overruns;  /**< transfers dropped because the ring was full */
+    unsigned long long missed;    /**< timer periods skipped because a transfer ran late */
+    unsigned long long errors;    /**< transfers that failed */
+    long long max_lateness_ns;    /**< worst start time deviation from schedule */
+    long long mean_lateness_ns;   /**< average start time deviation from schedule */
+} mraa_spi_stream_stats_t;
+
 /**
  * Initialise SPI_context, uses board mapping. Sets the muxes
  *
@@ -124,10 +137,12 @@ int mraa_spi_write_word(mraa_spi_context dev, uint16_t data);
 /**
  * Write Buffer of bytes to the SPI device. The pointer return has to be
  * free'd by the caller. It will return a NULL pointer in cases of error.
+ * Use mraa_spi_transfer_buf() with a caller owned receive buffer to avoid the
+ * allocation.
  *
  * @param dev The Spi context
  * @param data to send
- * @param length elements within buffer, Max 4096
+ * @param length elements within buffer
  * @return Data received on the miso line, same length as passed in
  */
 uint8_t* mraa_spi_write_buf(mraa_spi_context dev, uint8_t* data, int length);
@@ -135,40 +150,45 @@ uint8_t* mraa_spi_write_buf(mraa_spi_context dev, uint8_t* data, int length);
 /**
  * Write Buffer of uint16 to the SPI device. The pointer return has to be
  * free'd by the caller. It will return a NULL pointer in cases of error.
+ * Use mraa_spi_transfer_buf_word() with a caller owned receive buffer to avoid the
+ * allocation.
  *
  * @param dev The Spi context
  * @param data to send
- * @param length elements (in bytes) within buffer, Max 4096
+ * @param length elements (in bytes) within buffer
  * @return Data received on the miso line, same length as passed in
  */
 uint16_t* mraa_spi_write_buf_word(mraa_spi_context dev, uint16_t* data, int length);
 
 /**
  * Transfer Buffer of bytes to the SPI device. Both send and recv buffers
- * are passed in
+ * are passed in. Buffers larger than the spidev bufsiz limit (4096 by
+ * default) are sent as several messages with chip select held asserted.
  *
  * @param dev The Spi context
  * @param data to send
  * @param rxbuf buffer to recv data back, may be NULL
- * @param length elements within buffer, Max 4096
+ * @param length elements within buffer
  * @return Result of operation
  */
 mraa_result_t mraa_spi_transfer_buf(mraa_spi_context dev, uint8_t* data, uint8_t* rxbuf, int length);
 
 /**
  * Transfer Buffer of uint16 to the SPI device. Both send and recv buffers
- * are passed in
+ * are passed in. Buffers larger than the spidev bufsiz limit are split on
+ * word boundaries with chip select held asserted.
  *
  * @param dev The Spi context
  * @param data to send
  * @param rxbuf buffer to recv data back, may be NULL
- * @param length elements (in bytes) within buffer, Max 4096
+ * @param length elements (in bytes) within buffer
  * @return Result of operation
  */
 mraa_result_t mraa_spi_transfer_buf_word(mraa_spi_context dev, uint16_t* data, uint16_t* rxbuf, int length);
 
 /**
- * Change the SPI lsb mode
+ * Change the SPI lsb mode. If the controller does not support lsb first
+ * transfers the bits are reversed in software instead.
  *
  * @param dev The Spi context
  * @param lsb Use least significant bit transmission. 0 for msbi
@@ -177,7 +197,8 @@ mraa_result_t mraa_spi_transfer_buf_word(mraa_spi_context dev, uint16_t* data, u
 mraa_result_t mraa_spi_lsbmode(mraa_spi_context dev, mraa_boolean_t lsb);
 
 /**
- * Set bits per mode on transaction, defaults at 8
+ * Set bits per mode on transaction, defaults at 8. If the controller does
+ * not support 16 bit words they are sent as byte pairs in wire order.
  *
  * @param dev The Spi context
  * @param bits bits per word
@@ -185,6 +206,77 @@ mraa_result_t mraa_spi_lsbmode(mraa_spi_context dev, mraa_boolean_t lsb);
  */
 mraa_result_t mraa_spi_bit_per_word(mraa_spi_context dev, unsigned int bits);
 
+/**
+ * Set scheduling of the streaming thread. Must be called before a stream is
+ * started. Raising priority usually requires CAP_SYS_NICE, if it is refused
+ * the stream runs with default scheduling.
+ *
+ * @param dev The Spi context
+ * @param priority SCHED_FIFO priority, 0 keeps the default policy
+ * @param cpu CPU to pin the thread to, -1 for no affinity
+ * @return Result of operation
+ */
+mraa_result_t mraa_spi_stream_sched(mraa_spi_context dev, int priority, int cpu);
+
+/**
+ * Start repeating a transfer at a fixed rate from a dedicated thread. Every
+ * received buffer is stored with a CLOCK_MONOTONIC timestamp in a ring read
+ * with mraa_spi_stream_read(). The context must not be used for other
+ * transfers until the stream is stopped.
+ *
+ * @param dev The Spi context
+ * @param data buffer sent on every transfer, copied
+ * @param length bytes per transfer
+ * @param period_us interval between transfer starts in microseconds
+ * @param depth number of transfers the ring holds, rounded up to the next
+ * power of two, at most 1048576
+ * @return Result of operation
+ */
+mraa_result_t mraa_spi_stream_start(mraa_spi_context dev, const uint8_t* data, int length, unsigned int period_us, unsigned int depth);
+
+/**
+ * Start repeating a transfer on every edge of a data ready gpio, otherwise
+ * behaves like mraa_spi_stream_start().
+ *
+ * @param dev The Spi context
+ * @param data buffer sent on every transfer, copied
+ * @param length bytes per transfer
+ * @param drdy gpio context of the data ready line, configured as input
+ * @param edge edge of drdy that triggers a transfer
+ * @param depth number of transfers the ring holds, rounded up to the next
+ * power of two, at most 1048576
+ * @return Result of operation
+ */
+mraa_result_t mraa_spi_stream_start_gpio(mraa_spi_context dev, const uint8_t* data, int length, mraa_gpio_context drdy, mraa_gpio_edge_t edge, unsigned int depth);
+
+/**
+ * Take received transfers out of the stream ring without blocking
+ *
+ * @param dev The Spi context
+ * @param rxbuf buffer for up to count transfers of the stream length
+ * @param timestamps buffer for count timestamps in nanoseconds, may be NULL
+ * @param count maximum number of transfers to take
+ * @return number of transfers copied or -1 in case of error
+ */
+int mraa_spi_stream_read(mraa_spi_context dev, uint8_t* rxbuf, mraa_timestamp_t* timestamps, int count);
+
+/**
+ * Get statistics of the running stream
+ *
+ * @param dev The Spi context
+ * @param stats filled with the current statistics
+ * @return Result of operation
+ */
+mraa_result_t mraa_spi_stream_get_stats(mraa_spi_context dev, mraa_spi_stream_stats_t* stats);
+
+/**
+ * Stop a stream and release its ring. Data not yet read is lost.
+ *
+ * @param dev The Spi context
+ * @return Result of operation
+ */
+mraa_result_t mraa_spi_stream_stop(mraa_spi_context dev);
+
 /**
  * De-inits an mraa_spi_context device
  *
@@ -29,6 +29,7 @@
 #include "spi.h"
 #include "types.hpp"
 #include <stdexcept>
+#include <vector>
 
 namespace mraa
 {
@@ -219,6 +220,40 @@ class Spi
     {
         return (Result) mraa_spi_transfer_buf_word(m_spi, txBuf, rxBuf, length);
     }
+
+    /**
+     * Transfer data to and from SPI device using caller owned storage.
+     * rxBuf is resized to match txBuf, so reusing the same vector across
+     * calls does not allocate once its capacity is large enough.
+     *
+     * @param txBuf buffer to send
+     * @param rxBuf buffer receiving data from the spi device
+     * @return Result of operation
+     */
+    Result
+    transfer(const std::vector<uint8_t>& txBuf, std::vector<uint8_t>& rxBuf)
+    {
+        rxBuf.resize(txBuf.size());
+        return (Result) mraa_spi_transfer_buf(m_spi, const_cast<uint8_t*>(txBuf.data()),
+                                              rxBuf.data(), (int) txBuf.size());
+    }
+
+    /**
+     * Transfer words to and from SPI device using caller owned storage.
+     * rxBuf is resized to match txBuf, so reusing the same vector across
+     * calls does not allocate once its capacity is large enough.
+     *
+     * @param txBuf buffer to send
+     * @param rxBuf buffer receiving data from the spi device
+     * @return Result of operation
+     */
+    Result
+    transfer_word(const std::vector<uint16_t>& txBuf, std::vector<uint16_t>& rxBuf)
+    {
+        rxBuf.resize(txBuf.size());
+        return (Result) mraa_spi_transfer_buf_word(m_spi, const_cast<uint16_t*>(txBuf.data()),
+                                                   rxBuf.data(), (int) (txBuf.size() * sizeof(uint16_t)));
+    }
 #endif
 
     /**
@@ -234,6 +234,8 @@ typedef enum {
     MRAA_ERROR_UART_OW_SHORTED = 12,              /**< UART OW Short Circuit Detected*/
     MRAA_ERROR_UART_OW_NO_DEVICES = 13,           /**< UART OW No devices detected */
     MRAA_ERROR_UART_OW_DATA_ERROR = 14,           /**< UART OW Data/Bus error detected */
+    MRAA_ERROR_MODBUS_FRAME = 15,                 /**< Modbus response with bad CRC or framing */
+    MRAA_ERROR_MODBUS_EXCEPTION = 16,             /**< Modbus exception response */
 
     MRAA_ERROR_UNSPECIFIED = 99 /**< Unknown Error */
 } mraa_result_t;
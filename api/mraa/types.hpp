@@ -219,6 +219,8 @@ typedef enum {
     ERROR_UART_OW_SHORTED = 12,              /**< UART OW Short Circuit Detected*/
     ERROR_UART_OW_NO_DEVICES = 13,           /**< UART OW No devices detected */
     ERROR_UART_OW_DATA_ERROR = 14,           /**< UART OW Data/Bus error detected */
+    ERROR_MODBUS_FRAME = 15,                 /**< Modbus response with bad CRC or framing */
+    ERROR_MODBUS_EXCEPTION = 16,             /**< Modbus exception response */
 
     ERROR_UNSPECIFIED = 99 /**< Unknown Error */
 } Result;
@@ -46,10 +46,82 @@ extern "C" {
 #include <stdio.h>
 
 #include "common.h"
+#include "gpio.h"
 
 /** Mraa Uart Context */
 typedef struct _uart* mraa_uart_context;
 
+/**
+ * Framing applied by the asynchronous reader
+ */
+typedef enum {
+    MRAA_UART_FRAME_RAW = 0,       /**< bytes as they arrive, no framing */
+    MRAA_UART_FRAME_DELIMITER = 1, /**< frames end with a delimiter byte, which is stripped */
+    MRAA_UART_FRAME_LENGTH = 2,    /**< frames start with a big endian length prefix, which is stripped */
+    MRAA_UART_FRAME_COBS = 3,      /**< COBS encoded frames ending with 0x00 */
+    MRAA_UART_FRAME_SLIP = 4,      /**< SLIP (RFC 1055) frames ending with 0xC0 */
+} mraa_uart_framing_t;
+
+/**
+ * A decoded frame, pointing into the reader ring
+ */
+typedef struct {
+    const uint8_t* data; /**< frame payload */
+    int length;          /**< payload bytes */
+} mraa_uart_frame_t;
+
+/**
+ * Asynchronous reader statistics
+ */
+typedef struct {
+    unsigned long long bytes;  /**< bytes read from the port */
+    unsigned long long frames; /**< frames delivered */
+    unsigned long long errors; /**< frames dropped as malformed or larger than the ring */
+    unsigned long long stalls; /**< times the reader waited on a full ring */
+} mraa_uart_async_stats_t;
+
+/** Set of UARTs and gpios waited on together */
+typedef struct _uart_poll_set* mraa_uart_poll_set;
+
+/**
+ * Readiness flags of a poll set entry
+ */
+typedef enum {
+    MRAA_UART_POLL_READABLE = 1, /**< data can be read, or a gpio edge was seen */
+    MRAA_UART_POLL_WRITABLE = 2, /**< data can be written without blocking */
+    MRAA_UART_POLL_ERROR = 4,    /**< the port reported an error or hangup */
+} mraa_uart_poll_flags_t;
+
+/**
+ * A ready entry reported by mraa_uart_poll_set_wait()
+ */
+typedef struct {
+    mraa_uart_context uart; /**< ready uart, NULL for a gpio entry */
+    mraa_gpio_context gpio; /**< gpio that saw an edge, NULL for a uart entry */
+    unsigned int events;    /**< mraa_uart_poll_flags_t bits */
+    void* user;             /**< pointer given when the entry was added */
+} mraa_uart_poll_event_t;
+
+/**
+ * RS-485 direction control in use on a port
+ */
+typedef enum {
+    MRAA_UART_RS485_OFF = 0,    /**< full duplex, no direction control */
+    MRAA_UART_RS485_KERNEL = 1, /**< the driver toggles RTS as DE (TIOCSRS485) */
+    MRAA_UART_RS485_GPIO = 2,   /**< mraa toggles a GPIO as DE around each write */
+} mraa_uart_rs485_mode_t;
+
+/**
+ * Callback reporting that written bytes have left the transmitter
+ */
+typedef void (*mraa_uart_write_done_cb)(unsigned int bytes, void* args);
+
+/**
+ * Callback receiving a batch of frames from the asynchronous reader. The
+ * frames are only valid until the callback returns.
+ */
+typedef void (*mraa_uart_frame_cb)(const mraa_uart_frame_t* frames, int count, void* args);
+
 /**
  * Initialise uart_context, uses board mapping
  *
@@ -90,7 +162,8 @@ mraa_result_t mraa_uart_sendbreak(mraa_uart_context dev, int duration);
 /**
  * Set the baudrate.
  * Takes an int and will attempt to decide what baudrate  is
- * to be used on the UART hardware.
+ * to be used on the UART hardware. Rates without a standard termios
+ * constant, e.g. 250000, are requested from the driver with termios2.
  *
  * @param dev The UART context
  * @param baud unsigned int of baudrate i.e. 9600
@@ -98,6 +171,60 @@ mraa_result_t mraa_uart_sendbreak(mraa_uart_context dev, int duration);
  */
 mraa_result_t mraa_uart_set_baudrate(mraa_uart_context dev, unsigned int baud);
 
+/**
+ * Read back the baudrate in use. Where the driver supports it this is the
+ * rate it actually programmed, which can differ from the requested one
+ * when the clock divider cannot hit it exactly.
+ *
+ * @param dev The UART context
+ * @param baud set to the baudrate in bits per second
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_get_baudrate(mraa_uart_context dev, unsigned int* baud);
+
+/**
+ * Configure the port for the lowest request/response latency. Sets
+ * ASYNC_LOW_LATENCY on drivers supporting TIOCSSERIAL, so received bytes
+ * are pushed to the tty layer without batching, and makes read() return
+ * as soon as a single byte is available (VMIN 1, VTIME 0). Drivers without
+ * TIOCSSERIAL, such as most USB adapters, only get the termios part.
+ * Disabling puts back the ICANON, VMIN and VTIME settings the port had
+ * when low latency was first enabled.
+ *
+ * @param dev The UART context
+ * @param enable 1 to enable, 0 to clear ASYNC_LOW_LATENCY and restore the
+ * read settings
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_set_low_latency(mraa_uart_context dev, mraa_boolean_t enable);
+
+/**
+ * Switch the port to RS-485 half duplex operation. Direction control is
+ * left to the driver through TIOCSRS485 when it supports it, which drives
+ * RTS as the DE line with no software turnaround delay. Otherwise de_pin is
+ * driven as DE from userspace: asserted before each write and released as
+ * soon as the line status register reports the transmitter empty, without
+ * any fixed sleep. Buffered writes are not available in GPIO mode. When
+ * enabling fails the port keeps the mode it had.
+ *
+ * @param dev The UART context
+ * @param enable 1 to enable RS-485, 0 to return to full duplex
+ * @param de_pin gpio wired to DE, used when the driver has no RS-485
+ * support, -1 if DE is only wired to RTS
+ * @param de_active_low 1 if DE is asserted by driving it low
+ * @return Result of operation, MRAA_ERROR_FEATURE_NOT_SUPPORTED if the
+ * driver has no RS-485 support and no de_pin was given
+ */
+mraa_result_t mraa_uart_set_rs485(mraa_uart_context dev, mraa_boolean_t enable, int de_pin, mraa_boolean_t de_active_low);
+
+/**
+ * Get the RS-485 direction control in use on the port
+ *
+ * @param dev The UART context
+ * @return mode of operation, MRAA_UART_RS485_OFF in case of error
+ */
+mraa_uart_rs485_mode_t mraa_uart_get_rs485_mode(mraa_uart_context dev);
+
 /**
  * Set the transfer mode
  * For example setting the mode to 8N1 would be
@@ -186,6 +313,25 @@ mraa_uart_settings(int index,
     unsigned int* rtscts,
     unsigned int* xonxoff);
 
+/**
+ * Get the RS-485 settings of an UART as held by its driver. Like
+ * mraa_uart_settings() this only reads the values without disturbing the
+ * port, and a negative index selects the UART through *devpath instead.
+ *
+ * @param index uart index to look up, if negative, *devpath will be used instead
+ * @param devpath points to the device path of the UART, eg: /dev/ttyS0
+ * @param enabled will point to non-zero if the driver runs the port in RS-485 mode
+ * @param rts_on_send will point to non-zero if RTS is driven high while sending
+ * @param delay_after_ms will contain the RTS release delay after sending
+ * @return result, MRAA_ERROR_FEATURE_NOT_SUPPORTED if the driver has no
+ * RS-485 support
+ */
+mraa_result_t mraa_uart_rs485_settings(int index,
+    const char **devpath,
+    unsigned int* enabled,
+    unsigned int* rts_on_send,
+    unsigned int* delay_after_ms);
+
 /**
  * Destroy a mraa_uart_context
  *
@@ -214,6 +360,49 @@ int mraa_uart_read(mraa_uart_context dev, char* buf, size_t length);
  */
 int mraa_uart_write(mraa_uart_context dev, const char* buf, size_t length);
 
+/**
+ * Enable buffered writes. mraa_uart_write() then copies small writes into a
+ * queue of size bytes and only calls the driver when the queue is full,
+ * passing the queue and the new data in a single writev(). The queue is
+ * written out by mraa_uart_write_flush(), mraa_uart_flush() and
+ * mraa_uart_stop(). With a non blocking port mraa_uart_write() may accept
+ * fewer bytes than given once both the driver and the queue are full.
+ *
+ * @param dev uart context
+ * @param size queue bytes, 0 flushes and returns to unbuffered writes
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_set_write_buffer(mraa_uart_context dev, unsigned int size);
+
+/**
+ * Hand queued bytes to the driver without waiting for them to be sent
+ *
+ * @param dev uart context
+ * @return bytes still queued, non zero only for non blocking ports, or -1
+ * in case of error
+ */
+int mraa_uart_write_flush(mraa_uart_context dev);
+
+/**
+ * Bytes not sent yet, both in the write queue and in the driver (TIOCOUTQ).
+ * Producers can use this to throttle without blocking in mraa_uart_flush().
+ *
+ * @param dev uart context
+ * @return pending bytes or -1 in case of error
+ */
+int mraa_uart_output_pending(mraa_uart_context dev);
+
+/**
+ * Install a callback run from a helper thread each time bytes handed to the
+ * driver have been physically sent. Requires mraa_uart_set_write_buffer().
+ *
+ * @param dev uart context
+ * @param cb callback, NULL to stop reporting
+ * @param args argument passed to cb
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_set_write_callback(mraa_uart_context dev, mraa_uart_write_done_cb cb, void* args);
+
 /**
  * Check to see if data is available on the device for reading
  *
@@ -223,6 +412,135 @@ int mraa_uart_write(mraa_uart_context dev, const char* buf, size_t length);
  */
 mraa_boolean_t mraa_uart_data_available(mraa_uart_context dev, unsigned int millis);
 
+/**
+ * Create an empty poll set. A poll set waits on any number of UARTs and
+ * gpio edges with a single epoll descriptor, so descriptor numbers are not
+ * limited as with select(). It is not safe to change a set from one thread
+ * while another waits on it.
+ *
+ * @return poll set or NULL
+ */
+mraa_uart_poll_set mraa_uart_poll_set_create();
+
+/**
+ * Add a UART to a poll set. Ports provided by platform hooks without a
+ * descriptor cannot be added.
+ *
+ * @param set poll set
+ * @param uart uart context, must stay open while registered
+ * @param events MRAA_UART_POLL_READABLE and/or MRAA_UART_POLL_WRITABLE
+ * @param user pointer reported back with every event of this entry
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_poll_set_add(mraa_uart_poll_set set, mraa_uart_context uart, unsigned int events, void* user);
+
+/**
+ * Change the events waited for on a registered UART, e.g. to only ask for
+ * writability while output is pending
+ *
+ * @param set poll set
+ * @param uart registered uart context
+ * @param events MRAA_UART_POLL_READABLE and/or MRAA_UART_POLL_WRITABLE
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_poll_set_modify(mraa_uart_poll_set set, mraa_uart_context uart, unsigned int events);
+
+/**
+ * Remove a UART from a poll set
+ *
+ * @param set poll set
+ * @param uart registered uart context
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_poll_set_remove(mraa_uart_poll_set set, mraa_uart_context uart);
+
+/**
+ * Add gpio edges to a poll set. The edge mode must already be set with
+ * mraa_gpio_edge_mode() and the pin must not use mraa_gpio_isr(). Edges are
+ * reported as MRAA_UART_POLL_READABLE and consumed by the wait.
+ *
+ * @param set poll set
+ * @param gpio gpio context, must stay open while registered
+ * @param user pointer reported back with every event of this entry
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_poll_set_add_gpio(mraa_uart_poll_set set, mraa_gpio_context gpio, void* user);
+
+/**
+ * Remove a gpio from a poll set
+ *
+ * @param set poll set
+ * @param gpio registered gpio context
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_poll_set_remove_gpio(mraa_uart_poll_set set, mraa_gpio_context gpio);
+
+/**
+ * Wait until at least one entry of the set is ready
+ *
+ * @param set poll set
+ * @param events array receiving the ready entries
+ * @param max_events size of events, at most 64 are reported per call
+ * @param timeout_ms milliseconds to wait, 0 to return immediately, -1 to wait forever
+ * @return number of ready entries, 0 on timeout or -1 in case of error
+ */
+int mraa_uart_poll_set_wait(mraa_uart_poll_set set, mraa_uart_poll_event_t* events, int max_events, int timeout_ms);
+
+/**
+ * Destroy a poll set. Registered UARTs and gpios are left open.
+ *
+ * @param set poll set
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_poll_set_destroy(mraa_uart_poll_set set);
+
+/**
+ * Start a background thread reading the port into a ring buffer and
+ * splitting the stream into frames. Frames are either passed in batches to
+ * cb from the reader thread or, when cb is NULL, taken with
+ * mraa_uart_async_pop(). Empty frames are dropped. mraa_uart_read() must not
+ * be used while the reader is running.
+ *
+ * @param dev uart context
+ * @param framing how the stream is split into frames
+ * @param option delimiter byte for MRAA_UART_FRAME_DELIMITER, prefix width
+ * in bytes (1-4) for MRAA_UART_FRAME_LENGTH, ignored otherwise
+ * @param ring_size ring buffer bytes, rounded up to a power of two, also the
+ * largest frame that can be received
+ * @param cb frame callback or NULL
+ * @param args argument passed to cb
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_async_start(mraa_uart_context dev, mraa_uart_framing_t framing, unsigned int option, unsigned int ring_size, mraa_uart_frame_cb cb, void* args);
+
+/**
+ * Take the next complete frame without blocking or copying. The frame stays
+ * valid until the next call to mraa_uart_async_pop() or
+ * mraa_uart_async_stop().
+ *
+ * @param dev uart context
+ * @param data set to the frame payload
+ * @return frame length, 0 if no frame is ready or -1 in case of error
+ */
+int mraa_uart_async_pop(mraa_uart_context dev, const uint8_t** data);
+
+/**
+ * Get statistics of the asynchronous reader
+ *
+ * @param dev uart context
+ * @param stats filled with the current counters
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_async_get_stats(mraa_uart_context dev, mraa_uart_async_stats_t* stats);
+
+/**
+ * Stop the asynchronous reader and free its ring
+ *
+ * @param dev uart context
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_async_stop(mraa_uart_context dev);
+
 #ifdef __cplusplus
 }
 #endif
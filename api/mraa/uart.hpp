@@ -228,6 +228,50 @@ class Uart
         return (Result) mraa_uart_set_baudrate(m_uart, baud);
     }
 
+    /**
+     * Read back the baudrate in use, as reported by the driver where
+     * supported
+     *
+     * @throws std::invalid_argument in case of error
+     * @return baudrate in bits per second
+     */
+    unsigned int
+    getBaudRate()
+    {
+        unsigned int baud = 0;
+        if (mraa_uart_get_baudrate(m_uart, &baud) != MRAA_SUCCESS) {
+            throw std::invalid_argument("Error reading baudrate");
+        }
+        return baud;
+    }
+
+    /**
+     * Configure the port for the lowest request/response latency
+     *
+     * @param enable true to enable, false to clear the driver low latency flag
+     * @return Result of operation
+     */
+    Result
+    setLowLatency(bool enable)
+    {
+        return (Result) mraa_uart_set_low_latency(m_uart, enable);
+    }
+
+    /**
+     * Switch the port to RS-485 half duplex operation, using the driver's
+     * RS-485 support when present and the DE gpio otherwise
+     *
+     * @param enable true to enable RS-485, false to return to full duplex
+     * @param dePin gpio wired to DE, -1 if DE is only wired to RTS
+     * @param deActiveLow true if DE is asserted by driving it low
+     * @return Result of operation
+     */
+    Result
+    setRs485(bool enable, int dePin = -1, bool deActiveLow = false)
+    {
+        return (Result) mraa_uart_set_rs485(m_uart, enable, dePin, deActiveLow);
+    }
+
     /**
      * Set the transfer mode
      * For example setting the mode to 8N1 would be
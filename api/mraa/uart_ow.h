@@ -69,6 +69,9 @@ extern "C" {
 /** 8 bytes (64 bits) for a device rom code */
 #define MRAA_UART_OW_ROMCODE_SIZE 8
 
+/** 9 bytes for a temperature sensor scratchpad, the last one is a crc8 */
+#define MRAA_UART_OW_SCRATCHPAD_SIZE 9
+
 /** for now, we simply use the normal MRAA UART context */
 typedef struct _mraa_uart_ow {
     /** Uart Context */
@@ -81,6 +84,14 @@ typedef struct _mraa_uart_ow {
     int LastFamilyDiscrepancy;
     /** Context las device flag */
     mraa_boolean_t LastDeviceFlag;
+    /** time in ms allowed for the presence pulse after a reset */
+    int reset_timeout;
+    /** time in ms allowed for echoes on top of their transmission time */
+    int io_timeout;
+    /** cached line settings for the reset and data speeds */
+    struct _uart_ow_speeds* speeds;
+    /** rom codes found on the bus, NULL until the first mraa_uart_ow_devices() */
+    struct _uart_ow_roms* roms;
 } *mraa_uart_ow_context;
 
 /**
@@ -127,6 +138,19 @@ const char* mraa_uart_ow_get_dev_path(mraa_uart_ow_context dev);
  */
 mraa_result_t mraa_uart_ow_stop(mraa_uart_ow_context dev);
 
+/**
+ * Set how long to wait for the bus to answer. Each time is counted on
+ * top of the time needed to transmit the timeslots, failures return
+ * MRAA_ERROR_NO_DATA_AVAILABLE (or -1) once it has passed. Both default
+ * to 100 ms.
+ *
+ * @param dev uart_ow context
+ * @param reset_ms time in ms allowed for the presence pulse after a reset
+ * @param io_ms time in ms allowed for the echo of data timeslots
+ * @return one of the mraa_result_t values
+ */
+mraa_result_t mraa_uart_ow_set_timeout(mraa_uart_ow_context dev, int reset_ms, int io_ms);
+
 /**
  * Read a byte from the 1-wire bus
  *
@@ -144,6 +168,18 @@ int mraa_uart_ow_read_byte(mraa_uart_ow_context dev);
  */
 int mraa_uart_ow_write_byte(mraa_uart_ow_context dev, uint8_t byte);
 
+/**
+ * Exchange a block of bytes with the 1-wire bus. Every byte is written
+ * and replaced by the byte read back during its time slots, so send 0xff
+ * to read. The time slots of a block are written to the UART in one go.
+ *
+ * @param dev uart_ow context
+ * @param buf bytes to send, overwritten with the bytes read back
+ * @param len number of bytes
+ * @return one of the mraa_result_t values
+ */
+mraa_result_t mraa_uart_ow_block(mraa_uart_ow_context dev, uint8_t* buf, int len);
+
 /**
  * Write a bit to a 1-wire bus and read a bit corresponding to the
  * time slot back.  This is possible due to the way we wired the TX
@@ -189,6 +225,62 @@ mraa_result_t mraa_uart_ow_rom_search(mraa_uart_ow_context dev, mraa_boolean_t s
  */
 mraa_result_t mraa_uart_ow_command(mraa_uart_ow_context dev, uint8_t command, uint8_t* id);
 
+/**
+ * Get the rom codes of all devices on the bus. The result of the search
+ * is cached and reused while the bus looks unchanged: a reset is used to
+ * check that presence still matches the cache, and a device failing to
+ * answer in mraa_uart_ow_read_scratchpads() triggers a new search.
+ *
+ * @param dev uart_ow context
+ * @param ids buffer for max rom codes of MRAA_UART_OW_ROMCODE_SIZE bytes, may be NULL
+ * @param max maximum number of rom codes to copy
+ * @param refresh true to always search the bus again
+ * @return number of devices on the bus, which may exceed max, or -1 for error
+ */
+int mraa_uart_ow_devices(mraa_uart_ow_context dev, uint8_t* ids, int max, mraa_boolean_t refresh);
+
+/**
+ * Start a temperature conversion on every sensor with a single Skip ROM
+ * Convert T and wait until all of them are done. Requires sensors that
+ * are not running on parasite power, as completion is read from the bus.
+ *
+ * @param dev uart_ow context
+ * @param timeout_ms longest time to wait, 750 ms covers 12 bit DS18B20s
+ * @return one of the mraa_result_t values
+ */
+mraa_result_t mraa_uart_ow_convert_all(mraa_uart_ow_context dev, unsigned int timeout_ms);
+
+/**
+ * Read the scratchpad of every device found by mraa_uart_ow_devices(),
+ * in the same order. Each device takes one reset and one block exchange,
+ * and its crc8 is checked. Failed scratchpads are zeroed. Only DS18B20
+ * style thermometers (families 0x10, 0x22, 0x28, 0x3B and 0x42) are read,
+ * other devices are left alone and their scratchpads zeroed.
+ *
+ * @param dev uart_ow context
+ * @param scratchpads buffer for max scratchpads of MRAA_UART_OW_SCRATCHPAD_SIZE bytes
+ * @param results per device result, MRAA_ERROR_UART_OW_DATA_ERROR for a
+ * bad crc, MRAA_ERROR_FEATURE_NOT_SUPPORTED for a device that is not a
+ * thermometer, may be NULL
+ * @param max maximum number of scratchpads to read
+ * @return number of scratchpads read or -1 for error
+ */
+int mraa_uart_ow_read_scratchpads(mraa_uart_ow_context dev, uint8_t* scratchpads, mraa_result_t* results, int max);
+
+/**
+ * Read every DS18B20 style temperature sensor on the bus, converting all
+ * of them in parallel so the whole bus takes a single conversion time.
+ * The order matches mraa_uart_ow_devices().
+ *
+ * @param dev uart_ow context
+ * @param celsius buffer for max temperatures, NAN for a sensor that failed
+ * and for a device that is not a thermometer
+ * @param max maximum number of temperatures to read
+ * @param timeout_ms longest time to wait for the conversion
+ * @return number of temperatures read or -1 for error
+ */
+int mraa_uart_ow_read_temperatures(mraa_uart_ow_context dev, float* celsius, int max, unsigned int timeout_ms);
+
 /**
  * Perform a Dallas 1-wire compliant CRC8 computation on a buffer
  *
@@ -30,6 +30,7 @@
 #include "uart_ow.h"
 #include <cstring>
 #include <stdexcept>
+#include <vector>
 
 namespace mraa
 {
@@ -146,6 +147,34 @@ class UartOW
         return (uint8_t) res;
     }
 
+    /**
+     * Set how long to wait for the bus to answer, on top of the time
+     * needed to transmit the timeslots
+     *
+     * @param resetMs time in ms allowed for the presence pulse after a reset
+     * @param ioMs time in ms allowed for the echo of data timeslots
+     * @return one of the mraa::Result values
+     */
+    mraa::Result
+    setTimeout(int resetMs, int ioMs)
+    {
+        return (mraa::Result) mraa_uart_ow_set_timeout(m_uart, resetMs, ioMs);
+    }
+
+    /**
+     * Exchange a block of bytes with the 1-wire bus, every byte is
+     * replaced by the byte read back during its time slots
+     *
+     * @param buf bytes to send, overwritten with the bytes read back
+     * @param len number of bytes
+     * @return one of the mraa::Result values
+     */
+    mraa::Result
+    block(uint8_t* buf, int len)
+    {
+        return (mraa::Result) mraa_uart_ow_block(m_uart, buf, len);
+    }
+
     /**
      * Write a bit to a 1-wire bus and read a bit corresponding to the
      * time slot back.  This is possible due to the way we wired the TX
@@ -262,6 +291,58 @@ class UartOW
         }
     }
 
+    /**
+     * Get the rom codes of all devices on the bus, cached between calls
+     * while the bus looks unchanged
+     *
+     * @param refresh true to always search the bus again
+     * @throws std::invalid_argument in case of error
+     * @return vector of 8 byte rom code strings
+     */
+    std::vector<std::string>
+    devices(bool refresh = false)
+    {
+        int count = mraa_uart_ow_devices(m_uart, NULL, 0, refresh ? 1 : 0);
+        if (count < 0) {
+            throw std::invalid_argument("Unknown UART_OW error");
+        }
+        int max = count;
+        std::vector<uint8_t> ids(max * MRAA_UART_OW_ROMCODE_SIZE + 1);
+        count = mraa_uart_ow_devices(m_uart, ids.data(), max, 0);
+        if (count < 0) {
+            throw std::invalid_argument("Unknown UART_OW error");
+        }
+        std::vector<std::string> ret;
+        for (int i = 0; i < count && i < max; i++) {
+            ret.push_back(std::string((char*) &ids[i * MRAA_UART_OW_ROMCODE_SIZE], MRAA_UART_OW_ROMCODE_SIZE));
+        }
+        return ret;
+    }
+
+    /**
+     * Convert and read every temperature sensor on the bus in parallel,
+     * in the order returned by devices()
+     *
+     * @param timeoutMs longest time to wait for the conversion
+     * @throws std::invalid_argument in case of error
+     * @return temperatures in degrees Celsius, NAN for failed sensors
+     */
+    std::vector<float>
+    readTemperatures(unsigned int timeoutMs = 750)
+    {
+        int count = mraa_uart_ow_devices(m_uart, NULL, 0, 0);
+        if (count < 0) {
+            throw std::invalid_argument("Unknown UART_OW error");
+        }
+        std::vector<float> temps(count + 1);
+        count = mraa_uart_ow_read_temperatures(m_uart, temps.data(), count, timeoutMs);
+        if (count < 0) {
+            throw std::invalid_argument("Unknown UART_OW error");
+        }
+        temps.resize(count);
+        return temps;
+    }
+
     /**
      * Perform a Dallas 1-wire compliant CRC8 computation on a buffer
      *
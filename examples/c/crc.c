@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Example usage: Checksums a 4 MiB buffer, as read back when verifying an
+ * EEPROM or flash dump, with a bit at a time CRC32 and with mraa's
+ * checksum functions, and prints the throughput of each.
+ *
+ */
+
+/* standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* mraa header */
+#include "mraa/crc.h"
+
+#define BUF_SIZE (4 * 1024 * 1024)
+
+static double
+now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t
+crc32_bitwise(const uint8_t* buf, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    size_t i;
+    int b;
+
+    for (i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (b = 0; b < 8; b++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+int
+main(void)
+{
+    uint8_t* buf = malloc(BUF_SIZE);
+    uint32_t crc;
+    double t;
+    size_t i;
+
+    if (buf == NULL) {
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < BUF_SIZE; i++) {
+        buf[i] = (uint8_t) (i * 2654435761u >> 24);
+    }
+
+    //! [Interesting]
+    t = now();
+    crc = crc32_bitwise(buf, BUF_SIZE);
+    t = now() - t;
+    fprintf(stdout, "crc32 bitwise   %08x %8.1f MB/s\n", crc, BUF_SIZE / t / 1e6);
+
+    t = now();
+    crc = mraa_crc32(buf, BUF_SIZE, 0);
+    t = now() - t;
+    fprintf(stdout, "mraa_crc32      %08x %8.1f MB/s\n", crc, BUF_SIZE / t / 1e6);
+
+    t = now();
+    crc = mraa_crc32c(buf, BUF_SIZE, 0);
+    t = now() - t;
+    fprintf(stdout, "mraa_crc32c     %08x %8.1f MB/s\n", crc, BUF_SIZE / t / 1e6);
+
+    t = now();
+    crc = mraa_crc16_ibm(buf, BUF_SIZE, 0xFFFF);
+    t = now() - t;
+    fprintf(stdout, "mraa_crc16_ibm      %04x %8.1f MB/s\n", crc, BUF_SIZE / t / 1e6);
+    //! [Interesting]
+
+    free(buf);
+    return EXIT_SUCCESS;
+}
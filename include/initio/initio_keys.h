@@ -60,6 +60,8 @@ extern "C" {
 #define U_PARITY_ODD "O"
 #define U_PARITY_MARK "M"
 #define U_PARITY_SPACE "S"
+
+#define U_RS485 "rs485"
 /*---------------------------------------------*/
 
 #ifdef __cplusplus
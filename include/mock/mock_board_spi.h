@@ -17,6 +17,8 @@ extern "C" {
 #define MOCK_SPI_DEFAULT_MODE MRAA_SPI_MODE0
 #define MOCK_SPI_DEFAULT_LSBMODE 0
 #define MOCK_SPI_DEFAULT_BIT_PER_WORD 8
+// Default spidev bufsiz module parameter
+#define MOCK_SPI_BUFSIZ 4096
 // This is XORed with each byte/word of the transmitted message to get the received one
 #define MOCK_SPI_REPLY_DATA_MODIFIER_BYTE 0xAB
 #define MOCK_SPI_REPLY_DATA_MODIFIER_WORD 0xABBA
@@ -63,7 +63,8 @@ mraa_platform_t mraa_mips_platform();
 mraa_platform_t mraa_mock_platform();
 
 /**
- * runtime detect iio subsystem
+ * runtime detect iio subsystem, done on first use by the iio and aio
+ * modules. Later calls return at once.
  *
  * @return mraa_result_t indicating success of iio detection
  */
@@ -154,6 +155,154 @@ int mraa_find_i2c_bus_pci(const char* pci_device, const char *pci_id, const char
  */
 mraa_result_t mraa_find_uart_bus_pci(const char* pci_dev_path, char** dev_name);
 
+/**
+ * Open a descriptor that becomes ready when an edge is seen on a gpio whose
+ * edge mode has already been set. The caller owns and closes the descriptor.
+ *
+ * @param dev gpio context
+ * @param poll_events set to the poll() events to wait for on the descriptor
+ * @return file descriptor or -1 if the pin cannot report edges this way
+ */
+int mraa_gpio_event_fd_open(mraa_gpio_context dev, short* poll_events);
+
+/**
+ * Consume a pending edge from a descriptor returned by mraa_gpio_event_fd_open
+ *
+ * @param fd descriptor to acknowledge
+ * @param poll_events events value returned alongside the descriptor
+ */
+void mraa_gpio_event_fd_ack(int fd, short poll_events);
+
+/**
+ * Set a baudrate that has no Bxxx constant through termios2 and BOTHER
+ *
+ * @param fd open tty descriptor
+ * @param baud rate in bits per second
+ * @return Result of operation, MRAA_ERROR_FEATURE_NOT_SUPPORTED without termios2
+ */
+mraa_result_t mraa_uart_termios2_set_speed(int fd, unsigned int baud);
+
+/**
+ * Read back the output baudrate the driver reports through termios2
+ *
+ * @param fd open tty descriptor
+ * @param baud set to the rate in bits per second
+ * @return Result of operation, MRAA_ERROR_FEATURE_NOT_SUPPORTED without termios2
+ */
+mraa_result_t mraa_uart_termios2_get_speed(int fd, unsigned int* baud);
+
+/**
+ * Convert between caller and wire layout when a spi controller can't do
+ * lsb first or 16 bit words itself. Converting twice gives the input back.
+ *
+ * @param dev spi context
+ * @param dst converted data, may be src
+ * @param src data to convert
+ * @param len bytes in src
+ */
+void mraa_spi_soft_convert(mraa_spi_context dev, uint8_t* dst, const uint8_t* src, int len);
+
+/**
+ * Queue or write data through the buffered writer of a uart
+ *
+ * @param dev uart context with a write buffer
+ * @param buf data to write
+ * @param len bytes in buf
+ * @return bytes accepted or -1 in case of error
+ */
+int mraa_uart_writer_write(mraa_uart_context dev, const char* buf, size_t len);
+
+/**
+ * Block until the write buffer of a uart has been handed to the driver
+ *
+ * @param dev uart context
+ * @return Result of operation
+ */
+mraa_result_t mraa_uart_writer_drain(mraa_uart_context dev);
+
+/**
+ * Flush what can be written and release the buffered writer of a uart
+ *
+ * @param dev uart context
+ */
+void mraa_uart_writer_stop(mraa_uart_context dev);
+
+/**
+ * Write data with the RS-485 DE gpio asserted, releasing it once the
+ * transmitter is empty
+ *
+ * @param dev uart context in gpio RS-485 mode
+ * @param buf data to write
+ * @param len length of data
+ * @return number of bytes written, or -1 if an error occurred
+ */
+int mraa_uart_rs485_write(mraa_uart_context dev, const char* buf, size_t len);
+
+/**
+ * Return a uart to full duplex and release its DE gpio
+ *
+ * @param dev uart context
+ */
+void mraa_uart_rs485_stop(mraa_uart_context dev);
+
+/**
+ * Validate a period and duty pair against each other and the platform
+ * range, as mraa_pwm_config() does
+ *
+ * @param dev pwm context
+ * @param period_ns period in nanoseconds
+ * @param duty_ns pulsewidth in nanoseconds
+ * @return Result of operation
+ */
+mraa_result_t mraa_pwm_config_check(mraa_pwm_context dev, int period_ns, int duty_ns);
+
+/**
+ * Write an already validated period and duty pair, skipping what is
+ * unchanged
+ *
+ * @param dev pwm context
+ * @param period_ns period in nanoseconds
+ * @param duty_ns pulsewidth in nanoseconds
+ * @return Result of operation
+ */
+mraa_result_t mraa_pwm_config_apply(mraa_pwm_context dev, int period_ns, int duty_ns);
+
+/**
+ * Tell whether the sequence player is driving a pwm. Until it finishes or
+ * is stopped, only the player thread may touch the cached period and duty.
+ *
+ * @param dev pwm context
+ * @param out set to the last output written by the player, may be NULL
+ * @return 1 while a sequence plays or is queued
+ */
+mraa_boolean_t mraa_pwm_seq_output(mraa_pwm_context dev, mraa_pwm_step_t* out);
+
+/**
+ * Apply the calibration of an aio context to a raw reading
+ *
+ * @param dev aio context
+ * @param raw raw ADC code, may hold a fraction after averaging
+ * @return value in calibrated units
+ */
+float mraa_aio_calibrate(mraa_aio_context dev, float raw);
+
+#if !defined(PERIPHERALMAN)
+/**
+ * Decode one channel of an IIO scan: shifted, masked and sign extended
+ *
+ * @param scan start of the scan
+ * @param chan channel with its location in the scan
+ * @return channel value
+ */
+int64_t mraa_iio_channel_value(const char* scan, const mraa_iio_channel* chan);
+
+/**
+ * Stop the thread serving every IIO buffer and event callback. Devices
+ * must be closed first.
+ */
+void mraa_iio_reactor_stop();
+#endif
+
 #if defined(IMRAA)
 /**
  * read Imraa subplatform lock file, caller is responsible to free return
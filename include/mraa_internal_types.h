@@ -195,6 +195,13 @@ struct _spi {
     int clock;          /**< clock to run transactions at */
     mraa_boolean_t lsb; /**< least significant bit mode */
     unsigned int bpw;   /**< Bits per word */
+    unsigned int max_xfer; /**< Largest single spidev transfer (bufsiz) */
+    mraa_boolean_t soft_lsb;    /**< lsb first done in software */
+    mraa_boolean_t soft_word16; /**< 16 bit words sent as byte pairs */
+    uint8_t* soft_buf;          /**< tx conversion buffer of one chunk */
+    int stream_priority; /**< SCHED_FIFO priority of the stream thread */
+    int stream_cpu;      /**< CPU the stream thread is pinned to, -1 none */
+    struct _spi_stream* stream; /**< running stream acquisition, if any */
     mraa_adv_func_t* advance_func; /**< override function table */
     /*@}*/
 #ifdef PERIPHERALMAN
@@ -211,6 +218,8 @@ struct _pwm {
     int chipid; /**< the chip id, which the pwm resides */
     int duty_fp; /**< File pointer to duty file */
     int period;  /**< Cache the period to speed up setting duty */
+    struct _pwm_state* state; /**< open sysfs files and cached settings, NULL until used */
+    struct _pwm_seq* seq; /**< running sequence player, if any */
     mraa_boolean_t owner; /**< Owner of pwm context*/
     mraa_adv_func_t* advance_func; /**< override function table */
     /*@}*/
@@ -227,10 +236,46 @@ struct _aio {
     unsigned int channel; /**< the channel as on board and ADC module */
     int adc_in_fp; /**< File Pointer to raw sysfs */
     int value_bit; /**< 10 bits by default. Can be increased if board */
+    int raw_bits; /**< resolution of the ADC */
+    unsigned int shifter_value; /**< shift between raw_bits and value_bit */
+    float max_analog_value; /**< full scale at value_bit */
+    unsigned int oversampling; /**< raw reads averaged into one sample */
+    float cal_scale; /**< units = (raw + cal_offset) * cal_scale */
+    float cal_offset; /**< added to raw before scaling */
+    float* cal_raw; /**< calibration table raw points, NULL when linear */
+    float* cal_units; /**< calibration table value at each raw point */
+    int cal_points; /**< calibration table size */
     mraa_adv_func_t* advance_func; /**< override function table */
     /*@}*/
 };
 
+#if !defined(PERIPHERALMAN)
+/**
+ * A stream over the triggered buffer of the platform ADC. The channel
+ * layout comes from the scan_elements parsing of the iio module.
+ */
+struct _aio_stream {
+    mraa_iio_context iio;
+    int count;          /**< pins in the stream */
+    int* index;         /**< scan index of each pin */
+    int ts_index;       /**< scan index of in_timestamp or -1 */
+    unsigned int* channel; /**< in_voltageN of each pin */
+    char* trigger;      /**< trigger to attach, NULL keeps the current one */
+    unsigned int rate_hz;
+    unsigned int length;
+    unsigned int watermark;
+    int fd;             /**< /dev/iio:deviceN while started, else -1 */
+    uint8_t* buf;
+    int buf_scans;
+    mraa_aio_context* pins; /**< for the calibration of each channel */
+    unsigned int decimation; /**< raw scans averaged into one */
+    int64_t* acc;       /**< per channel sums of the scans so far */
+    unsigned int acc_n; /**< scans summed into acc */
+    int64_t acc_ts_first;
+    int64_t acc_ts_last;
+};
+#endif
+
 /**
  * A structure representing a UART device
  */
@@ -239,6 +284,11 @@ struct _uart {
     int index; /**< the uart index, as known to the os. */
     const char* path; /**< the uart device path. */
     int fd; /**< file descriptor for device. */
+    unsigned int baudrate; /**< last baudrate set */
+    struct _uart_async* async; /**< background reader, NULL when not running */
+    struct _uart_writer* writer; /**< write queue, NULL when writes are unbuffered */
+    struct _uart_rs485* rs485; /**< RS-485 direction control, NULL in full duplex */
+    struct _uart_latency* latency; /**< termios saved by set_low_latency, NULL when off */
     mraa_adv_func_t* advance_func; /**< override function table */
     /*@}*/
 #if defined(PERIPHERALMAN)
@@ -258,12 +308,16 @@ struct _iio {
     void (* isr)(char* data, void* args); /**< the interrupt service request */
     void *isr_args; /**< args return when interrupt service request triggered */
     void (* isr_event)(struct iio_event_data* data, void* args); /**< the event interrupt service request */
+    void *isr_event_args; /**< args return when the event service request triggered */
     int chan_num;
-    pthread_t thread_id; /**< the isr handler thread id */
+    unsigned int sources; /**< fds registered with the shared reader thread */
     mraa_iio_channel* channels;
     int event_num;
     mraa_iio_event* events;
     int datasize;
+    struct _iio_buffer* buffer; /**< triggered buffer reader, NULL until configured */
+    mraa_boolean_t scanned; /**< channels and events have been read from sysfs */
+    struct _iio_cache* cache; /**< open attribute files and scan element names */
 };
 #endif
 
@@ -284,6 +338,32 @@ struct _led {
     /*@}*/
 };
 
+/**
+ * A structure representing a SPI driven addressable LED strip
+ */
+struct _led_strip {
+    /*@{*/
+    mraa_spi_context spi; /**< SPI bus driving the strip */
+    mraa_led_strip_type_t type; /**< LED chip type */
+    int count; /**< number of LEDs */
+    int channels; /**< colour channels per LED */
+    uint8_t* pixels; /**< pixel levels in wire channel order */
+    uint8_t* scratch; /**< pixels after brightness and gamma */
+    uint8_t levels[256]; /**< brightness and gamma lookup */
+    uint8_t brightness; /**< global brightness */
+    float gamma; /**< gamma exponent */
+    int frame_size; /**< encoded frame bytes including reset */
+    uint8_t* frames[2]; /**< double buffered encoded frames */
+    int back; /**< index of the frame being filled */
+    pthread_t thread_id; /**< sender thread */
+    pthread_mutex_t lock; /**< protects the fields below */
+    pthread_cond_t cond; /**< signals pending changes */
+    mraa_boolean_t pending; /**< front frame queued for sending */
+    mraa_boolean_t terminating; /**< sender should exit */
+    mraa_result_t last_result; /**< result of the last transfer */
+    /*@}*/
+};
+
 /**
  * A bitfield representing the capabilities of a pin.
  */
@@ -7,17 +7,33 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 #include "aio.h"
 #include "mraa_internal.h"
 
 #define DEFAULT_BITS 10
+#define MAX_OVERSAMPLING 1024
 
-static int raw_bits;
-static unsigned int shifter_value;
-static float max_analog_value;
+static void
+mraa_aio_update_shift(mraa_aio_context dev)
+{
+    if (dev->raw_bits < dev->value_bit) {
+        dev->shifter_value = dev->value_bit - dev->raw_bits;
+        dev->max_analog_value = ((1 << dev->raw_bits) - 1) << dev->shifter_value;
+    } else {
+        dev->shifter_value = dev->raw_bits - dev->value_bit;
+        dev->max_analog_value = ((1 << dev->raw_bits) - 1) >> dev->shifter_value;
+    }
+}
 
 static mraa_result_t
 aio_get_valid_fp(mraa_aio_context dev)
@@ -144,32 +160,33 @@ mraa_aio_init(unsigned int aio)
         }
     }
 
-    raw_bits = mraa_adc_raw_bits();
-
-    if (raw_bits < dev->value_bit) {
-        shifter_value = dev->value_bit - raw_bits;
-        max_analog_value = ((1 << raw_bits) - 1) << shifter_value;
-    } else {
-        shifter_value = raw_bits - dev->value_bit;
-        max_analog_value = ((1 << raw_bits) - 1) >> shifter_value;
-    }
+    dev->raw_bits = board->aio_count > 0 ? board->adc_raw : 0;
+    dev->oversampling = 1;
+    dev->cal_scale = 1.0f;
+    mraa_aio_update_shift(dev);
 
     return dev;
 }
 
-int
-mraa_aio_read(mraa_aio_context dev)
+/* Adjust the raw analog input reading to supported resolution value */
+static unsigned int
+mraa_aio_adjust(mraa_aio_context dev, unsigned int analog_value)
 {
-    if (dev == NULL) {
-        syslog(LOG_ERR, "aio: read: context is invalid");
-        return -1;
-    }
-
-    if (IS_FUNC_DEFINED(dev, aio_read_replace)) {
-        return dev->advance_func->aio_read_replace(dev);
+    if (dev->raw_bits < dev->value_bit) {
+        return analog_value << dev->shifter_value;
     }
+    return analog_value >> dev->shifter_value;
+}
 
+/*
+ * One pread per sample, sysfs regenerates the attribute on every read at
+ * offset 0 so there is no need to seek back and forth.
+ */
+static int
+mraa_aio_read_raw(mraa_aio_context dev)
+{
     char buffer[17];
+
     if (dev->adc_in_fp == -1) {
         if (aio_get_valid_fp(dev) != MRAA_SUCCESS) {
             syslog(LOG_ERR, "aio: Failed to get to the device");
@@ -177,13 +194,13 @@ mraa_aio_read(mraa_aio_context dev)
         }
     }
 
-    lseek(dev->adc_in_fp, 0, SEEK_SET);
-    if (read(dev->adc_in_fp, buffer, sizeof(buffer)) < 1) {
+    ssize_t len = pread(dev->adc_in_fp, buffer, sizeof(buffer) - 1, 0);
+    if (len < 1) {
         syslog(LOG_ERR, "aio: Failed to read a sensible value");
+        return -1;
     }
     // force NULL termination of string
-    buffer[16] = '\0';
-    lseek(dev->adc_in_fp, 0, SEEK_SET);
+    buffer[len] = '\0';
 
     errno = 0;
     char* end;
@@ -196,14 +213,117 @@ mraa_aio_read(mraa_aio_context dev)
         return -1;
     }
 
-    /* Adjust the raw analog input reading to supported resolution value*/
-    if (raw_bits < dev->value_bit) {
-        analog_value = analog_value << shifter_value;
-    } else {
-        analog_value = analog_value >> shifter_value;
+    return analog_value;
+}
+
+/*
+ * Sum of dev->oversampling raw reads. Replaced platforms already hand out
+ * adjusted values, those are summed as they are.
+ */
+static mraa_result_t
+mraa_aio_read_sum(mraa_aio_context dev, unsigned long long* sum)
+{
+    unsigned int i;
+
+    *sum = 0;
+    for (i = 0; i < dev->oversampling; i++) {
+        int value;
+        if (IS_FUNC_DEFINED(dev, aio_read_replace)) {
+            value = dev->advance_func->aio_read_replace(dev);
+        } else {
+            value = mraa_aio_read_raw(dev);
+        }
+        if (value < 0) {
+            return MRAA_ERROR_UNSPECIFIED;
+        }
+        *sum += value;
     }
+    return MRAA_SUCCESS;
+}
 
-    return analog_value;
+int
+mraa_aio_read(mraa_aio_context dev)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "aio: read: context is invalid");
+        return -1;
+    }
+
+    if (dev->oversampling <= 1) {
+        if (IS_FUNC_DEFINED(dev, aio_read_replace)) {
+            return dev->advance_func->aio_read_replace(dev);
+        }
+
+        int analog_value = mraa_aio_read_raw(dev);
+        if (analog_value < 0) {
+            return -1;
+        }
+        return mraa_aio_adjust(dev, analog_value);
+    }
+
+    unsigned long long sum;
+    if (mraa_aio_read_sum(dev, &sum) != MRAA_SUCCESS) {
+        return -1;
+    }
+    unsigned int analog_value = (sum + dev->oversampling / 2) / dev->oversampling;
+    if (IS_FUNC_DEFINED(dev, aio_read_replace)) {
+        return analog_value;
+    }
+    return mraa_aio_adjust(dev, analog_value);
+}
+
+static int64_t
+mraa_aio_now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+mraa_result_t
+mraa_aio_read_multi(mraa_aio_context* devs, int count, int* values, int64_t* timestamp)
+{
+    int i;
+
+    if (devs == NULL || values == NULL || count < 1) {
+        syslog(LOG_ERR, "aio: read_multi: invalid parameters");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    for (i = 0; i < count; i++) {
+        if (devs[i] == NULL) {
+            syslog(LOG_ERR, "aio: read_multi: context %d is invalid", i);
+            return MRAA_ERROR_INVALID_HANDLE;
+        }
+        // open everything first so the reads below are back to back
+        if (!IS_FUNC_DEFINED(devs[i], aio_read_replace) && devs[i]->adc_in_fp == -1 &&
+            aio_get_valid_fp(devs[i]) != MRAA_SUCCESS) {
+            return MRAA_ERROR_INVALID_RESOURCE;
+        }
+    }
+
+    int64_t start = mraa_aio_now_ns();
+    for (i = 0; i < count; i++) {
+        if (IS_FUNC_DEFINED(devs[i], aio_read_replace)) {
+            values[i] = devs[i]->advance_func->aio_read_replace(devs[i]);
+        } else {
+            values[i] = mraa_aio_read_raw(devs[i]);
+        }
+        if (values[i] < 0) {
+            syslog(LOG_ERR, "aio: read_multi: failed to read context %d", i);
+            return MRAA_ERROR_UNSPECIFIED;
+        }
+    }
+    int64_t end = mraa_aio_now_ns();
+
+    for (i = 0; i < count; i++) {
+        if (!IS_FUNC_DEFINED(devs[i], aio_read_replace)) {
+            values[i] = mraa_aio_adjust(devs[i], values[i]);
+        }
+    }
+    if (timestamp != NULL) {
+        *timestamp = start + (end - start) / 2;
+    }
+    return MRAA_SUCCESS;
 }
 
 float
@@ -214,9 +334,194 @@ mraa_aio_read_float(mraa_aio_context dev)
         return -1.0;
     }
 
-    unsigned int analog_value_int = mraa_aio_read(dev);
+    int analog_value_int = mraa_aio_read(dev);
+    if (analog_value_int < 0) {
+        return -1.0;
+    }
 
-    return analog_value_int / max_analog_value;
+    return analog_value_int / dev->max_analog_value;
+}
+
+float
+mraa_aio_calibrate(mraa_aio_context dev, float raw)
+{
+    if (dev->cal_raw == NULL) {
+        return (raw + dev->cal_offset) * dev->cal_scale;
+    }
+
+    // find the segment holding raw, the end segments extend outwards
+    int lo = 0;
+    int hi = dev->cal_points - 1;
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (raw < dev->cal_raw[mid]) {
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+    float t = (raw - dev->cal_raw[lo]) / (dev->cal_raw[hi] - dev->cal_raw[lo]);
+    return dev->cal_units[lo] + t * (dev->cal_units[hi] - dev->cal_units[lo]);
+}
+
+mraa_result_t
+mraa_aio_read_calibrated(mraa_aio_context dev, float* value)
+{
+    unsigned long long sum;
+
+    if (dev == NULL || value == NULL) {
+        syslog(LOG_ERR, "aio: read_calibrated: invalid parameters");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    mraa_result_t ret = mraa_aio_read_sum(dev, &sum);
+    if (ret != MRAA_SUCCESS) {
+        syslog(LOG_ERR, "aio: read_calibrated: failed to read the input");
+        return ret;
+    }
+    // the mean keeps the fraction oversampling gains over a single read
+    *value = mraa_aio_calibrate(dev, (float) ((double) sum / dev->oversampling));
+    return MRAA_SUCCESS;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse2"))) static int
+mraa_aio_convert_linear_simd(const int32_t* raw, float* units, int count, float scale, float bias)
+{
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 b = _mm_set1_ps(bias);
+    int i;
+
+    for (i = 0; i + 4 <= count; i += 4) {
+        __m128 x = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*) (raw + i)));
+        _mm_storeu_ps(units + i, _mm_add_ps(_mm_mul_ps(x, s), b));
+    }
+    return i;
+}
+#elif defined(__aarch64__)
+static int
+mraa_aio_convert_linear_simd(const int32_t* raw, float* units, int count, float scale, float bias)
+{
+    const float32x4_t b = vdupq_n_f32(bias);
+    int i;
+
+    for (i = 0; i + 4 <= count; i += 4) {
+        float32x4_t x = vcvtq_f32_s32(vld1q_s32(raw + i));
+        vst1q_f32(units + i, vmlaq_n_f32(b, x, scale));
+    }
+    return i;
+}
+#endif
+
+mraa_result_t
+mraa_aio_convert(mraa_aio_context dev, const int32_t* raw, float* units, int count)
+{
+    int i = 0;
+
+    if (dev == NULL || raw == NULL || units == NULL || count < 0) {
+        syslog(LOG_ERR, "aio: convert: invalid parameters");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    if (dev->cal_raw == NULL) {
+        float scale = dev->cal_scale;
+        float bias = dev->cal_offset * dev->cal_scale;
+#if defined(__x86_64__) || defined(__i386__)
+        static int has_sse2 = -1;
+        if (has_sse2 < 0) {
+            __builtin_cpu_init();
+            has_sse2 = __builtin_cpu_supports("sse2");
+        }
+        if (has_sse2) {
+            i = mraa_aio_convert_linear_simd(raw, units, count, scale, bias);
+        }
+#elif defined(__aarch64__)
+        i = mraa_aio_convert_linear_simd(raw, units, count, scale, bias);
+#endif
+        for (; i < count; i++) {
+            units[i] = raw[i] * scale + bias;
+        }
+        return MRAA_SUCCESS;
+    }
+
+    for (; i < count; i++) {
+        units[i] = mraa_aio_calibrate(dev, (float) raw[i]);
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_aio_set_oversampling(mraa_aio_context dev, unsigned int samples)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "aio: set_oversampling: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (samples < 1 || samples > MAX_OVERSAMPLING) {
+        syslog(LOG_ERR, "aio: set_oversampling: %u samples out of range", samples);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    dev->oversampling = samples;
+    return MRAA_SUCCESS;
+}
+
+static void
+mraa_aio_free_table(mraa_aio_context dev)
+{
+    free(dev->cal_raw);
+    free(dev->cal_units);
+    dev->cal_raw = NULL;
+    dev->cal_units = NULL;
+    dev->cal_points = 0;
+}
+
+mraa_result_t
+mraa_aio_set_calibration(mraa_aio_context dev, float scale, float offset)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "aio: set_calibration: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    mraa_aio_free_table(dev);
+    dev->cal_scale = scale;
+    dev->cal_offset = offset;
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_aio_set_calibration_table(mraa_aio_context dev, const float* raw, const float* units, int points)
+{
+    int i;
+
+    if (dev == NULL) {
+        syslog(LOG_ERR, "aio: set_calibration_table: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (raw == NULL || units == NULL || points < 2) {
+        syslog(LOG_ERR, "aio: set_calibration_table: need at least two points");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    for (i = 1; i < points; i++) {
+        if (!(raw[i] > raw[i - 1])) {
+            syslog(LOG_ERR, "aio: set_calibration_table: raw points must be increasing");
+            return MRAA_ERROR_INVALID_PARAMETER;
+        }
+    }
+
+    float* r = malloc(points * sizeof(float));
+    float* u = malloc(points * sizeof(float));
+    if (r == NULL || u == NULL) {
+        free(r);
+        free(u);
+        syslog(LOG_CRIT, "aio: set_calibration_table: Failed to allocate memory for table");
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    memcpy(r, raw, points * sizeof(float));
+    memcpy(u, units, points * sizeof(float));
+    mraa_aio_free_table(dev);
+    dev->cal_raw = r;
+    dev->cal_units = u;
+    dev->cal_points = points;
+    return MRAA_SUCCESS;
 }
 
 mraa_result_t
@@ -227,6 +532,8 @@ mraa_aio_close(mraa_aio_context dev)
         return MRAA_ERROR_INVALID_HANDLE;
     }
 
+    mraa_aio_free_table(dev);
+
     if (IS_FUNC_DEFINED(dev, aio_close_replace)) {
         return dev->advance_func->aio_close_replace(dev);
     }
@@ -248,6 +555,7 @@ mraa_aio_set_bit(mraa_aio_context dev, int bits)
         return MRAA_ERROR_INVALID_RESOURCE;
     }
     dev->value_bit = bits;
+    mraa_aio_update_shift(dev);
     return MRAA_SUCCESS;
 }
 
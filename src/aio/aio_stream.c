@@ -0,0 +1,479 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "aio.h"
+#include "iio.h"
+#include "mraa_internal.h"
+
+#define AIO_STREAM_IIO_DEVICE 0
+#define AIO_STREAM_DEFAULT_SCANS 128
+#define IIO_SYSFS_DEVICES "/sys/bus/iio/devices"
+
+static int
+mraa_aio_stream_find_trigger(const char* name)
+{
+    char path[64];
+    char readbuf[64];
+    const struct dirent* ent;
+    int num = -1;
+
+    DIR* dir = opendir(IIO_SYSFS_DEVICES);
+    if (dir == NULL) {
+        return -1;
+    }
+    while (num < 0 && (ent = readdir(dir)) != NULL) {
+        int n;
+        if (sscanf(ent->d_name, "trigger%d", &n) != 1) {
+            continue;
+        }
+        snprintf(path, sizeof(path), IIO_SYSFS_DEVICES "/trigger%d/name", n);
+        int fd = open(path, O_RDONLY);
+        if (fd == -1) {
+            continue;
+        }
+        ssize_t len = read(fd, readbuf, sizeof(readbuf) - 1);
+        close(fd);
+        if (len > 0) {
+            readbuf[len] = '\0';
+            readbuf[strcspn(readbuf, "\r\n")] = '\0';
+            if (strcmp(readbuf, name) == 0) {
+                num = n;
+            }
+        }
+    }
+    closedir(dir);
+    return num;
+}
+
+static mraa_result_t
+mraa_aio_stream_attach_trigger(mraa_aio_stream_context stream)
+{
+    char buf[64];
+
+    int num = mraa_aio_stream_find_trigger(stream->trigger);
+    if (num < 0) {
+        snprintf(buf, sizeof(buf), "hrtimer/%s", stream->trigger);
+        mraa_iio_create_trigger(stream->iio, buf);
+        num = mraa_aio_stream_find_trigger(stream->trigger);
+    }
+    if (num < 0) {
+        syslog(LOG_ERR, "aio: stream: no trigger named %s", stream->trigger);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    if (stream->rate_hz > 0) {
+        char path[80];
+        snprintf(path, sizeof(path), IIO_SYSFS_DEVICES "/trigger%d/sampling_frequency", num);
+        snprintf(buf, sizeof(buf), "%u", stream->rate_hz);
+        int fd = open(path, O_WRONLY);
+        ssize_t len = fd == -1 ? -1 : write(fd, buf, strlen(buf));
+        if (fd != -1) {
+            close(fd);
+        }
+        if (len != (ssize_t) strlen(buf)) {
+            syslog(LOG_ERR, "aio: stream: failed to set %u Hz on trigger %s", stream->rate_hz, stream->trigger);
+            return MRAA_ERROR_INVALID_PARAMETER;
+        }
+    }
+
+    if (mraa_iio_write_string(stream->iio, "trigger/current_trigger", stream->trigger) != MRAA_SUCCESS) {
+        syslog(LOG_ERR, "aio: stream: failed to attach trigger %s", stream->trigger);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_aio_stream_context
+mraa_aio_stream_init(mraa_aio_context* pins, int count)
+{
+    char attr[64];
+    int i;
+
+    if (pins == NULL || count < 1) {
+        syslog(LOG_ERR, "aio: stream_init: no pins given");
+        return NULL;
+    }
+    for (i = 0; i < count; i++) {
+        if (pins[i] == NULL) {
+            syslog(LOG_ERR, "aio: stream_init: context %d is invalid", i);
+            return NULL;
+        }
+        if (IS_FUNC_DEFINED(pins[i], aio_read_replace)) {
+            syslog(LOG_ERR, "aio: stream_init: platform ADC has no IIO buffer");
+            return NULL;
+        }
+    }
+
+    mraa_iio_context iio = mraa_iio_init(AIO_STREAM_IIO_DEVICE);
+    if (iio == NULL) {
+        syslog(LOG_ERR, "aio: stream_init: no IIO device for the ADC");
+        return NULL;
+    }
+    if (iio->chan_num == 0) {
+        syslog(LOG_ERR, "aio: stream_init: ADC has no scan elements");
+        return NULL;
+    }
+
+    mraa_aio_stream_context stream = calloc(1, sizeof(struct _aio_stream));
+    if (stream == NULL) {
+        syslog(LOG_CRIT, "aio: stream_init: Failed to allocate memory for context");
+        return NULL;
+    }
+    stream->index = calloc(count, sizeof(int));
+    stream->channel = calloc(count, sizeof(unsigned int));
+    stream->pins = calloc(count, sizeof(mraa_aio_context));
+    stream->acc = calloc(count, sizeof(int64_t));
+    if (stream->index == NULL || stream->channel == NULL || stream->pins == NULL || stream->acc == NULL) {
+        syslog(LOG_CRIT, "aio: stream_init: Failed to allocate memory for channels");
+        mraa_aio_stream_close(stream);
+        return NULL;
+    }
+    stream->iio = iio;
+    stream->count = count;
+    stream->fd = -1;
+    stream->decimation = 1;
+
+    for (i = 0; i < count; i++) {
+        int index = -1;
+        stream->pins[i] = pins[i];
+        stream->channel[i] = pins[i]->channel;
+        snprintf(attr, sizeof(attr), "scan_elements/in_voltage%u_index", pins[i]->channel);
+        if (mraa_iio_read_int(iio, attr, &index) != MRAA_SUCCESS || index < 0 || index >= iio->chan_num) {
+            syslog(LOG_ERR, "aio: stream_init: channel %u cannot be buffered", pins[i]->channel);
+            mraa_aio_stream_close(stream);
+            return NULL;
+        }
+        stream->index[i] = index;
+    }
+    if (mraa_iio_read_int(iio, "scan_elements/in_timestamp_index", &stream->ts_index) != MRAA_SUCCESS ||
+        stream->ts_index < 0 || stream->ts_index >= iio->chan_num) {
+        stream->ts_index = -1;
+    }
+
+    return stream;
+}
+
+mraa_result_t
+mraa_aio_stream_set_trigger(mraa_aio_stream_context stream, const char* trigger, unsigned int rate_hz)
+{
+    if (stream == NULL) {
+        syslog(LOG_ERR, "aio: stream_set_trigger: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (stream->fd != -1) {
+        syslog(LOG_ERR, "aio: stream_set_trigger: stream is running");
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    free(stream->trigger);
+    stream->trigger = NULL;
+    if (trigger != NULL) {
+        stream->trigger = strdup(trigger);
+        if (stream->trigger == NULL) {
+            return MRAA_ERROR_NO_RESOURCES;
+        }
+    }
+    stream->rate_hz = rate_hz;
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_aio_stream_set_buffer(mraa_aio_stream_context stream, unsigned int length, unsigned int watermark)
+{
+    if (stream == NULL) {
+        syslog(LOG_ERR, "aio: stream_set_buffer: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (stream->fd != -1) {
+        syslog(LOG_ERR, "aio: stream_set_buffer: stream is running");
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    if (length > 0 && watermark > length) {
+        syslog(LOG_ERR, "aio: stream_set_buffer: watermark above buffer length");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    stream->length = length;
+    stream->watermark = watermark;
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_aio_stream_set_decimation(mraa_aio_stream_context stream, unsigned int factor)
+{
+    if (stream == NULL) {
+        syslog(LOG_ERR, "aio: stream_set_decimation: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (stream->fd != -1) {
+        syslog(LOG_ERR, "aio: stream_set_decimation: stream is running");
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    if (factor < 1) {
+        syslog(LOG_ERR, "aio: stream_set_decimation: factor must be at least 1");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    stream->decimation = factor;
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_aio_stream_start(mraa_aio_stream_context stream)
+{
+    char attr[64];
+    char path[64];
+    mraa_result_t ret;
+    int i;
+
+    if (stream == NULL) {
+        syslog(LOG_ERR, "aio: stream_start: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (stream->fd != -1) {
+        return MRAA_SUCCESS;
+    }
+    mraa_iio_context iio = stream->iio;
+
+    // scan elements and trigger can only change while the buffer is off
+    mraa_iio_write_int(iio, "buffer/enable", 0);
+    for (i = 0; i < stream->count; i++) {
+        snprintf(attr, sizeof(attr), "scan_elements/in_voltage%u_en", stream->channel[i]);
+        if (mraa_iio_write_int(iio, attr, 1) != MRAA_SUCCESS) {
+            syslog(LOG_ERR, "aio: stream_start: failed to enable channel %u", stream->channel[i]);
+            return MRAA_ERROR_INVALID_RESOURCE;
+        }
+    }
+    if (stream->ts_index >= 0) {
+        mraa_iio_write_int(iio, "scan_elements/in_timestamp_en", 1);
+    }
+    if (mraa_iio_update_channels(iio) != MRAA_SUCCESS || iio->datasize <= 0) {
+        syslog(LOG_ERR, "aio: stream_start: failed to read the scan layout");
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    if (stream->trigger != NULL) {
+        ret = mraa_aio_stream_attach_trigger(stream);
+        if (ret != MRAA_SUCCESS) {
+            return ret;
+        }
+    }
+    if (stream->length > 0 && mraa_iio_write_int(iio, "buffer/length", stream->length) != MRAA_SUCCESS) {
+        syslog(LOG_ERR, "aio: stream_start: failed to set buffer length %u", stream->length);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    // watermark appeared in linux 4.2, older kernels wake on every scan
+    if (stream->watermark > 0 && mraa_iio_write_int(iio, "buffer/watermark", stream->watermark) != MRAA_SUCCESS) {
+        syslog(LOG_NOTICE, "aio: stream_start: buffer watermark not supported");
+    }
+
+    int scans = stream->length > 0 ? (int) stream->length : AIO_STREAM_DEFAULT_SCANS;
+    uint8_t* buf = realloc(stream->buf, (size_t) scans * iio->datasize);
+    if (buf == NULL) {
+        syslog(LOG_CRIT, "aio: stream_start: Failed to allocate memory for scans");
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    stream->buf = buf;
+    stream->buf_scans = scans;
+    memset(stream->acc, 0, stream->count * sizeof(int64_t));
+    stream->acc_n = 0;
+
+    snprintf(path, sizeof(path), "/dev/iio:device%d", iio->num);
+    stream->fd = open(path, O_RDONLY | O_NONBLOCK);
+    if (stream->fd == -1) {
+        syslog(LOG_ERR, "aio: stream_start: failed to open %s: %s", path, strerror(errno));
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    if (mraa_iio_write_int(iio, "buffer/enable", 1) != MRAA_SUCCESS) {
+        syslog(LOG_ERR, "aio: stream_start: failed to enable the buffer, is a trigger attached?");
+        close(stream->fd);
+        stream->fd = -1;
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    return MRAA_SUCCESS;
+}
+
+/* Mean of a decimated sum, rounded to nearest */
+static inline int32_t
+mraa_aio_stream_mean(int64_t sum, unsigned int n)
+{
+    if (sum >= 0) {
+        return (int32_t) ((sum + n / 2) / n);
+    }
+    return (int32_t) -((-sum + n / 2) / n);
+}
+
+/*
+ * Decode raw scans from the read buffer. Without decimation every scan is
+ * one output, otherwise scans are summed until decimation of them can be
+ * averaged into an output stamped halfway between the first and the last.
+ * Returns the outputs written to either ivals or fvals.
+ */
+static int
+mraa_aio_stream_decode(mraa_aio_stream_context stream, int scans, int32_t* ivals, float* fvals, int64_t* timestamps)
+{
+    const mraa_iio_channel* chans = stream->iio->channels;
+    const char* scan = (const char*) stream->buf;
+    int out = 0;
+    int s, i;
+
+    for (s = 0; s < scans; s++, scan += stream->iio->datasize) {
+        int64_t ts = stream->ts_index >= 0 ? mraa_iio_channel_value(scan, &chans[stream->ts_index]) : 0;
+
+        if (stream->decimation == 1) {
+            for (i = 0; i < stream->count; i++) {
+                int32_t v = (int32_t) mraa_iio_channel_value(scan, &chans[stream->index[i]]);
+                if (ivals != NULL) {
+                    *ivals++ = v;
+                } else {
+                    *fvals++ = mraa_aio_calibrate(stream->pins[i], (float) v);
+                }
+            }
+            if (timestamps != NULL) {
+                timestamps[out] = ts;
+            }
+            out++;
+            continue;
+        }
+
+        if (stream->acc_n == 0) {
+            stream->acc_ts_first = ts;
+        }
+        stream->acc_ts_last = ts;
+        for (i = 0; i < stream->count; i++) {
+            stream->acc[i] += (int32_t) mraa_iio_channel_value(scan, &chans[stream->index[i]]);
+        }
+        if (++stream->acc_n < stream->decimation) {
+            continue;
+        }
+        for (i = 0; i < stream->count; i++) {
+            if (ivals != NULL) {
+                *ivals++ = mraa_aio_stream_mean(stream->acc[i], stream->decimation);
+            } else {
+                *fvals++ = mraa_aio_calibrate(stream->pins[i], (float) ((double) stream->acc[i] / stream->decimation));
+            }
+            stream->acc[i] = 0;
+        }
+        if (timestamps != NULL) {
+            timestamps[out] = stream->acc_ts_first + (stream->acc_ts_last - stream->acc_ts_first) / 2;
+        }
+        stream->acc_n = 0;
+        out++;
+    }
+    return out;
+}
+
+static int
+mraa_aio_stream_fill(mraa_aio_stream_context stream, int32_t* ivals, float* fvals, int64_t* timestamps, int scans, int timeout_ms)
+{
+    int done = 0;
+
+    if (stream->fd == -1) {
+        syslog(LOG_ERR, "aio: stream_read: stream is not started");
+        return -1;
+    }
+
+    int size = stream->iio->datasize;
+    while (done < scans) {
+        // never read more raw scans than the outputs left can take
+        long long want = (long long) (scans - done) * stream->decimation - stream->acc_n;
+        if (want > stream->buf_scans) {
+            want = stream->buf_scans;
+        }
+        // the kernel only hands out whole scans
+        ssize_t n = read(stream->fd, stream->buf, (size_t) want * size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && errno == EAGAIN) {
+            if (done > 0) {
+                break;
+            }
+            struct pollfd pfd;
+            pfd.fd = stream->fd;
+            pfd.events = POLLIN;
+            int ready = poll(&pfd, 1, timeout_ms);
+            if (ready == 0) {
+                return 0;
+            }
+            if (ready < 0 && errno != EINTR) {
+                syslog(LOG_ERR, "aio: stream_read: poll failed: %s", strerror(errno));
+                return -1;
+            }
+            continue;
+        }
+        if (n <= 0) {
+            syslog(LOG_ERR, "aio: stream_read: read failed: %s", strerror(errno));
+            return done > 0 ? done : -1;
+        }
+        size_t offset = (size_t) done * stream->count;
+        done += mraa_aio_stream_decode(stream, (int) (n / size), ivals != NULL ? ivals + offset : NULL,
+                                       fvals != NULL ? fvals + offset : NULL,
+                                       timestamps != NULL ? timestamps + done : NULL);
+    }
+    return done;
+}
+
+int
+mraa_aio_stream_read(mraa_aio_stream_context stream, int32_t* values, int64_t* timestamps, int scans, int timeout_ms)
+{
+    if (stream == NULL || values == NULL || scans < 0) {
+        syslog(LOG_ERR, "aio: stream_read: invalid parameters");
+        return -1;
+    }
+    return mraa_aio_stream_fill(stream, values, NULL, timestamps, scans, timeout_ms);
+}
+
+int
+mraa_aio_stream_read_calibrated(mraa_aio_stream_context stream, float* values, int64_t* timestamps, int scans, int timeout_ms)
+{
+    if (stream == NULL || values == NULL || scans < 0) {
+        syslog(LOG_ERR, "aio: stream_read_calibrated: invalid parameters");
+        return -1;
+    }
+    return mraa_aio_stream_fill(stream, NULL, values, timestamps, scans, timeout_ms);
+}
+
+mraa_result_t
+mraa_aio_stream_stop(mraa_aio_stream_context stream)
+{
+    if (stream == NULL) {
+        syslog(LOG_ERR, "aio: stream_stop: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (stream->fd == -1) {
+        return MRAA_SUCCESS;
+    }
+    mraa_result_t ret = mraa_iio_write_int(stream->iio, "buffer/enable", 0);
+    close(stream->fd);
+    stream->fd = -1;
+    return ret;
+}
+
+mraa_result_t
+mraa_aio_stream_close(mraa_aio_stream_context stream)
+{
+    if (stream == NULL) {
+        syslog(LOG_ERR, "aio: stream_close: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (stream->iio != NULL) {
+        mraa_aio_stream_stop(stream);
+    }
+    free(stream->buf);
+    free(stream->trigger);
+    free(stream->acc);
+    free(stream->pins);
+    free(stream->channel);
+    free(stream->index);
+    free(stream);
+    return MRAA_SUCCESS;
+}
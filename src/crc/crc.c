@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <pthread.h>
+#include <string.h>
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#endif
+
+#include "crc.h"
+
+#define CRC8_MAXIM_POLY 0x8C
+#define CRC16_IBM_POLY 0xA001
+#define CRC16_CCITT_POLY 0x1021
+#define CRC32_POLY 0xEDB88320
+#define CRC32C_POLY 0x82F63B78
+
+static uint8_t crc8_maxim_table[256];
+static uint16_t crc16_ibm_table[256];
+static uint16_t crc16_ccitt_table[256];
+/* table[k][b] is the crc of byte b followed by k zero bytes */
+static uint32_t crc32_table[8][256];
+static uint32_t crc32c_table[8][256];
+
+static pthread_once_t crc_tables_once = PTHREAD_ONCE_INIT;
+#if defined(__aarch64__)
+static int crc32_hw;
+#endif
+#if defined(__x86_64__) || defined(__aarch64__)
+static int crc32c_hw;
+#endif
+
+static void
+mraa_crc32_build(uint32_t table[8][256], uint32_t poly)
+{
+    for (int i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+        }
+        table[0][i] = crc;
+    }
+    for (int i = 0; i < 256; i++) {
+        for (int k = 1; k < 8; k++) {
+            table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+        }
+    }
+}
+
+static void
+mraa_crc_init_tables(void)
+{
+    for (int i = 0; i < 256; i++) {
+        uint8_t c8 = i;
+        uint16_t ibm = i;
+        uint16_t ccitt = i << 8;
+        for (int b = 0; b < 8; b++) {
+            c8 = (c8 & 1) ? (c8 >> 1) ^ CRC8_MAXIM_POLY : c8 >> 1;
+            ibm = (ibm & 1) ? (ibm >> 1) ^ CRC16_IBM_POLY : ibm >> 1;
+            ccitt = (ccitt & 0x8000) ? (ccitt << 1) ^ CRC16_CCITT_POLY : ccitt << 1;
+        }
+        crc8_maxim_table[i] = c8;
+        crc16_ibm_table[i] = ibm;
+        crc16_ccitt_table[i] = ccitt;
+    }
+    mraa_crc32_build(crc32_table, CRC32_POLY);
+    mraa_crc32_build(crc32c_table, CRC32C_POLY);
+
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    crc32c_hw = __builtin_cpu_supports("sse4.2");
+#elif defined(__aarch64__)
+    crc32_hw = crc32c_hw = (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#endif
+}
+
+static inline void
+mraa_crc_tables(void)
+{
+    pthread_once(&crc_tables_once, mraa_crc_init_tables);
+}
+
+uint8_t
+mraa_crc8_maxim(const uint8_t* buf, size_t len, uint8_t crc)
+{
+    mraa_crc_tables();
+    while (len--) {
+        crc = crc8_maxim_table[crc ^ *buf++];
+    }
+    return crc;
+}
+
+uint16_t
+mraa_crc16_ibm(const uint8_t* buf, size_t len, uint16_t crc)
+{
+    mraa_crc_tables();
+    while (len--) {
+        crc = (crc >> 8) ^ crc16_ibm_table[(crc ^ *buf++) & 0xFF];
+    }
+    return crc;
+}
+
+uint16_t
+mraa_crc16_ccitt(const uint8_t* buf, size_t len, uint16_t crc)
+{
+    mraa_crc_tables();
+    while (len--) {
+        crc = (crc << 8) ^ crc16_ccitt_table[((crc >> 8) ^ *buf++) & 0xFF];
+    }
+    return crc;
+}
+
+/* Slicing-by-8 on an already inverted crc */
+static uint32_t
+mraa_crc32_slice8(uint32_t table[8][256], const uint8_t* buf, size_t len, uint32_t crc)
+{
+    // byte steps up to 8 byte alignment so the main loop loads aligned words
+    while (len && ((uintptr_t) buf & 7)) {
+        crc = (crc >> 8) ^ table[0][(crc ^ *buf++) & 0xFF];
+        len--;
+    }
+    while (len >= 8) {
+        uint32_t lo, hi;
+        memcpy(&lo, buf, 4);
+        memcpy(&hi, buf + 4, 4);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        lo = __builtin_bswap32(lo);
+        hi = __builtin_bswap32(hi);
+#endif
+        lo ^= crc;
+        crc = table[7][lo & 0xFF] ^ table[6][(lo >> 8) & 0xFF] ^ table[5][(lo >> 16) & 0xFF] ^
+              table[4][lo >> 24] ^ table[3][hi & 0xFF] ^ table[2][(hi >> 8) & 0xFF] ^
+              table[1][(hi >> 16) & 0xFF] ^ table[0][hi >> 24];
+        buf += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = (crc >> 8) ^ table[0][(crc ^ *buf++) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) static uint32_t
+mraa_crc32c_sse42(const uint8_t* buf, size_t len, uint32_t crc)
+{
+    while (len && ((uintptr_t) buf & 7)) {
+        crc = _mm_crc32_u8(crc, *buf++);
+        len--;
+    }
+    uint64_t c = crc;
+    while (len >= 8) {
+        uint64_t v;
+        memcpy(&v, buf, 8);
+        c = _mm_crc32_u64(c, v);
+        buf += 8;
+        len -= 8;
+    }
+    crc = (uint32_t) c;
+    while (len--) {
+        crc = _mm_crc32_u8(crc, *buf++);
+    }
+    return crc;
+}
+#elif defined(__aarch64__)
+__attribute__((target("+crc"))) static uint32_t
+mraa_crc32_armv8(const uint8_t* buf, size_t len, uint32_t crc, int castagnoli)
+{
+    while (len && ((uintptr_t) buf & 7)) {
+        crc = castagnoli ? __crc32cb(crc, *buf) : __crc32b(crc, *buf);
+        buf++;
+        len--;
+    }
+    while (len >= 8) {
+        uint64_t v;
+        memcpy(&v, buf, 8);
+        crc = castagnoli ? __crc32cd(crc, v) : __crc32d(crc, v);
+        buf += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = castagnoli ? __crc32cb(crc, *buf) : __crc32b(crc, *buf);
+        buf++;
+    }
+    return crc;
+}
+#endif
+
+uint32_t
+mraa_crc32(const uint8_t* buf, size_t len, uint32_t crc)
+{
+    mraa_crc_tables();
+#if defined(__aarch64__)
+    if (crc32_hw) {
+        return ~mraa_crc32_armv8(buf, len, ~crc, 0);
+    }
+#endif
+    return ~mraa_crc32_slice8(crc32_table, buf, len, ~crc);
+}
+
+uint32_t
+mraa_crc32c(const uint8_t* buf, size_t len, uint32_t crc)
+{
+    mraa_crc_tables();
+#if defined(__x86_64__)
+    if (crc32c_hw) {
+        return ~mraa_crc32c_sse42(buf, len, ~crc);
+    }
+#elif defined(__aarch64__)
+    if (crc32c_hw) {
+        return ~mraa_crc32_armv8(buf, len, ~crc, 1);
+    }
+#endif
+    return ~mraa_crc32_slice8(crc32c_table, buf, len, ~crc);
+}
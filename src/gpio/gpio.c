@@ -807,6 +807,59 @@ mraa_gpio_interrupt_handler(void* arg)
     }
 }
 
+int
+mraa_gpio_event_fd_open(mraa_gpio_context dev, short* poll_events)
+{
+    if (dev == NULL || poll_events == NULL) {
+        syslog(LOG_ERR, "gpio: event_fd_open: context is invalid");
+        return -1;
+    }
+
+    if (IS_FUNC_DEFINED(dev, gpio_wait_interrupt_replace) || IS_FUNC_DEFINED(dev, gpio_isr_replace) ||
+        mraa_is_sub_platform_id(dev->pin)) {
+        syslog(LOG_ERR, "gpio%i: event_fd_open: not supported on this pin", dev->pin);
+        return -1;
+    }
+
+    if (plat->chardev_capable) {
+        mraa_gpiod_group_t gpio_group;
+
+        for_each_gpio_group(gpio_group, dev)
+        {
+            if (gpio_group->event_handles != NULL && gpio_group->num_gpio_lines > 0) {
+                *poll_events = POLLIN;
+                return dup(gpio_group->event_handles[0]);
+            }
+        }
+        syslog(LOG_ERR, "gpio%i: event_fd_open: edge mode not set", dev->pin);
+        return -1;
+    }
+
+    char bu[MAX_SIZE];
+    snprintf(bu, MAX_SIZE, SYSFS_CLASS_GPIO "/gpio%d/value", dev->pin);
+    int fd = open(bu, O_RDONLY);
+    if (fd < 0) {
+        syslog(LOG_ERR, "gpio%i: event_fd_open: failed to open 'value' : %s", dev->pin, strerror(errno));
+        return -1;
+    }
+    *poll_events = POLLPRI;
+    mraa_gpio_event_fd_ack(fd, POLLPRI);
+    return fd;
+}
+
+void
+mraa_gpio_event_fd_ack(int fd, short poll_events)
+{
+    if (poll_events == POLLIN) {
+        struct gpioevent_data event_data;
+        read(fd, &event_data, sizeof(event_data));
+    } else {
+        unsigned char c;
+        lseek(fd, 0, SEEK_SET);
+        read(fd, &c, 1);
+    }
+}
+
 mraa_result_t
 mraa_gpio_chardev_edge_mode(mraa_gpio_context dev, mraa_gpio_edge_t mode)
 {
@@ -9,12 +9,21 @@
 #include "mraa_internal.h"
 #include "dirent.h"
 #include <string.h>
-#include <poll.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <time.h>
 #if defined(MSYS)
 #define __USE_LINUX_IOCTL_DEFS
 #endif
 #include <sys/ioctl.h>
 #include <sys/stat.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 #define MAX_SIZE 128
 #define IIO_DEVICE "iio:device"
@@ -23,18 +32,265 @@
 #define IIO_SYSFS_DEVICE "/sys/bus/iio/devices/" IIO_DEVICE
 #define IIO_EVENTS "events"
 #define IIO_CONFIGFS_TRIGGER "/sys/kernel/config/iio/triggers/"
+#define IIO_DEFAULT_READ_SCANS 128
+#define IIO_ATTR_CACHE 16
+#define IIO_REACTOR_BATCH 16
+#define IIO_REACTOR_WAKE UINT64_MAX
+#define IIO_SOURCE_BUFFER 0x1
+#define IIO_SOURCE_EVENT 0x2
+
+/**
+ * Triggered buffer reader state. The ring is single producer (the reader
+ * thread) and single consumer (mraa_iio_ring_read), head and tail count
+ * modulo twice the depth so a full ring differs from an empty one and the
+ * slot stays continuous for any depth.
+ */
+struct _iio_buffer {
+    unsigned int length;     /**< buffer/length set, 0 when left to the driver */
+    char* data;              /**< read buffer of scans whole scans */
+    int scans;
+    void (*batch)(char* data, int scans, int64_t timestamp, void* args);
+    char* ring;              /**< depth scans, NULL unless the ring is used */
+    int64_t* stamps;         /**< read time of each ring slot */
+    unsigned int depth;
+    unsigned int head;
+    unsigned int tail;
+    unsigned long long overruns;
+};
+
+/*
+ * Open sysfs files of a device, read and written at offset 0. Kept until
+ * the slot is reused round robin or the device is invalidated.
+ */
+struct _iio_attr {
+    char name[MAX_SIZE];
+    int flags; /**< O_RDONLY or O_WRONLY */
+    int fd;
+};
+
+/**
+ * Per device sysfs cache. The scan element names and their _en files are
+ * kept open so picking up enabled channels costs one pread each.
+ */
+struct _iio_cache {
+    pthread_mutex_t lock; /**< guards attrs and next */
+    struct _iio_attr attrs[IIO_ATTR_CACHE];
+    unsigned int next;
+    char** prefix; /**< in_voltage0 style name by channel index, NULL for gaps */
+    int* en_fd;    /**< scan_elements/<prefix>_en by channel index */
+};
+
+/* Serialises creating caches and scanning sysfs */
+static pthread_mutex_t iio_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t iio_scan_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct _iio_cache*
+mraa_iio_cache(mraa_iio_context dev)
+{
+    struct _iio_cache* cache = __atomic_load_n(&dev->cache, __ATOMIC_ACQUIRE);
+    int i;
+
+    if (cache != NULL) {
+        return cache;
+    }
+    pthread_mutex_lock(&iio_cache_lock);
+    cache = dev->cache;
+    if (cache == NULL) {
+        cache = calloc(1, sizeof(struct _iio_cache));
+        if (cache != NULL) {
+            pthread_mutex_init(&cache->lock, NULL);
+            for (i = 0; i < IIO_ATTR_CACHE; i++) {
+                cache->attrs[i].fd = -1;
+            }
+            __atomic_store_n(&dev->cache, cache, __ATOMIC_RELEASE);
+        } else {
+            syslog(LOG_CRIT, "iio: device %d: Failed to allocate memory for sysfs cache", dev->num);
+        }
+    }
+    pthread_mutex_unlock(&iio_cache_lock);
+    return cache;
+}
+
+static void
+mraa_iio_drop_channels(mraa_iio_context dev)
+{
+    struct _iio_cache* cache = dev->cache;
+    int i;
+
+    if (cache != NULL) {
+        for (i = 0; i < dev->chan_num; i++) {
+            if (cache->prefix != NULL) {
+                free(cache->prefix[i]);
+            }
+            if (cache->en_fd != NULL && cache->en_fd[i] >= 0) {
+                close(cache->en_fd[i]);
+            }
+        }
+        free(cache->prefix);
+        free(cache->en_fd);
+        cache->prefix = NULL;
+        cache->en_fd = NULL;
+    }
+    free(dev->channels);
+    dev->channels = NULL;
+    dev->chan_num = 0;
+    dev->datasize = 0;
+}
+
+static void
+mraa_iio_drop_events(mraa_iio_context dev)
+{
+    int i;
+
+    for (i = 0; i < dev->event_num; i++) {
+        free(dev->events[i].name);
+    }
+    free(dev->events);
+    dev->events = NULL;
+    dev->event_num = 0;
+}
+
+static mraa_boolean_t
+mraa_iio_has_suffix(const char* name, const char* suffix)
+{
+    size_t n = strlen(name);
+    size_t len = strlen(suffix);
+    return n > len && strcmp(name + n - len, suffix) == 0;
+}
+
+/* One shot read of a small sysfs file, NUL terminated */
+static mraa_result_t
+mraa_iio_read_sysfs(const char* path, char* data, size_t len)
+{
+    int fd = open(path, O_RDONLY);
+    ssize_t n;
+
+    if (fd == -1) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    n = read(fd, data, len - 1);
+    close(fd);
+    if (n <= 0) {
+        return MRAA_ERROR_UNSPECIFIED;
+    }
+    data[n] = '\0';
+    return MRAA_SUCCESS;
+}
+
+/*
+ * Read or write an attribute through its cached fd, opening it on first
+ * use. A cached fd that went stale with the device is reopened once.
+ */
+static ssize_t
+mraa_iio_attr_io(mraa_iio_context dev, const char* attr_name, void* data, size_t len, int flags)
+{
+    struct _iio_cache* cache = mraa_iio_cache(dev);
+    struct _iio_attr* attr = NULL;
+    char path[MAX_SIZE];
+    mraa_boolean_t cached = 0;
+    ssize_t ret = -1;
+    int i;
+
+    if (cache == NULL) {
+        return -1;
+    }
+    pthread_mutex_lock(&cache->lock);
+    for (i = 0; i < IIO_ATTR_CACHE; i++) {
+        if (cache->attrs[i].fd >= 0 && cache->attrs[i].flags == flags &&
+            strcmp(cache->attrs[i].name, attr_name) == 0) {
+            attr = &cache->attrs[i];
+            cached = 1;
+            break;
+        }
+    }
+    for (;;) {
+        if (attr == NULL) {
+            snprintf(path, MAX_SIZE, IIO_SYSFS_DEVICE "%d/%s", dev->num, attr_name);
+            int fd = open(path, flags);
+            if (fd == -1) {
+                break;
+            }
+            attr = &cache->attrs[cache->next];
+            cache->next = (cache->next + 1) % IIO_ATTR_CACHE;
+            if (attr->fd >= 0) {
+                close(attr->fd);
+            }
+            attr->fd = fd;
+            attr->flags = flags;
+            snprintf(attr->name, MAX_SIZE, "%s", attr_name);
+        }
+        if (flags == O_RDONLY) {
+            ret = pread(attr->fd, data, len, 0);
+        } else {
+            ret = pwrite(attr->fd, data, len, 0);
+        }
+        if (ret >= 0 || (errno != ENODEV && errno != EBADF)) {
+            break;
+        }
+        close(attr->fd);
+        attr->fd = -1;
+        attr = NULL;
+        if (!cached) {
+            break;
+        }
+        cached = 0;
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return ret;
+}
 
 mraa_iio_context
 mraa_iio_init(int device)
 {
-    if (plat_iio->iio_device_count == 0 || device >= plat_iio->iio_device_count) {
+    mraa_iio_context dev;
+
+    mraa_iio_detect();
+    if (plat_iio == NULL || device < 0 || device >= plat_iio->iio_device_count) {
         return NULL;
     }
 
-    mraa_iio_get_channel_data(&plat_iio->iio_devices[device]);
-    mraa_iio_get_event_data(&plat_iio->iio_devices[device]);
+    dev = &plat_iio->iio_devices[device];
+    pthread_mutex_lock(&iio_scan_lock);
+    if (!dev->scanned) {
+        mraa_iio_get_channel_data(dev);
+        mraa_iio_get_event_data(dev);
+        dev->scanned = 1;
+    } else {
+        mraa_iio_update_channels(dev);
+    }
+    pthread_mutex_unlock(&iio_scan_lock);
+
+    return dev;
+}
+
+mraa_result_t
+mraa_iio_invalidate(mraa_iio_context dev)
+{
+    struct _iio_cache* cache;
+    int i;
 
-    return &plat_iio->iio_devices[device];
+    if (dev == NULL) {
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    pthread_mutex_lock(&iio_scan_lock);
+    mraa_iio_drop_channels(dev);
+    mraa_iio_drop_events(dev);
+    dev->scanned = 0;
+    pthread_mutex_lock(&iio_cache_lock);
+    cache = dev->cache;
+    dev->cache = NULL;
+    pthread_mutex_unlock(&iio_cache_lock);
+    if (cache != NULL) {
+        for (i = 0; i < IIO_ATTR_CACHE; i++) {
+            if (cache->attrs[i].fd >= 0) {
+                close(cache->attrs[i].fd);
+            }
+        }
+        pthread_mutex_destroy(&cache->lock);
+        free(cache);
+    }
+    pthread_mutex_unlock(&iio_scan_lock);
+    return MRAA_SUCCESS;
 }
 
 int
@@ -55,126 +311,174 @@ mraa_iio_get_channel_count(mraa_iio_context dev)
     return dev->chan_num;
 }
 
+/*
+ * Place the enabled channels in a scan the way the kernel does: each one
+ * aligned to its own storage size, in index order, and the scan padded to
+ * the largest of them. Disabled channels take no room.
+ */
+static void
+mraa_iio_scan_layout(mraa_iio_context dev)
+{
+    unsigned int curr_bytes = 0;
+    unsigned int align = 1;
+    int i;
+
+    for (i = 0; i < dev->chan_num; i++) {
+        mraa_iio_channel* chan = &dev->channels[i];
+        if (!chan->enabled || chan->bytes == 0) {
+            continue;
+        }
+        if (curr_bytes % chan->bytes != 0) {
+            curr_bytes += chan->bytes - curr_bytes % chan->bytes;
+        }
+        chan->location = curr_bytes;
+        curr_bytes += chan->bytes;
+        if (chan->bytes > align) {
+            align = chan->bytes;
+        }
+    }
+    if (curr_bytes % align != 0) {
+        curr_bytes += align - curr_bytes % align;
+    }
+    dev->datasize = curr_bytes;
+}
+
+/* Pick up the _en flag of every channel and redo the scan layout */
+static mraa_result_t
+mraa_iio_read_enables(mraa_iio_context dev)
+{
+    struct _iio_cache* cache = dev->cache;
+    char readbuf[8];
+    ssize_t n;
+    int i;
+
+    for (i = 0; i < dev->chan_num; i++) {
+        if (cache->en_fd[i] < 0) {
+            continue;
+        }
+        n = pread(cache->en_fd[i], readbuf, sizeof(readbuf) - 1, 0);
+        if (n <= 0) {
+            syslog(LOG_ERR, "iio: device %d: failed to read %s_en", dev->num, cache->prefix[i]);
+            return MRAA_IO_SETUP_FAILURE;
+        }
+        readbuf[n] = '\0';
+        dev->channels[i].enabled = (int) strtol(readbuf, NULL, 10);
+    }
+    mraa_iio_scan_layout(dev);
+    return MRAA_SUCCESS;
+}
+
 mraa_result_t
 mraa_iio_get_channel_data(mraa_iio_context dev)
 {
     const struct dirent* ent;
-    DIR* dir;
-    int chan_num = 0;
+    struct _iio_cache* cache;
     char buf[MAX_SIZE];
     char readbuf[32];
-    int fd;
-    int ret = 0;
-    int padint = 0;
-    int curr_bytes = 0;
-    char shortbuf, signchar;
-    int i = 0;
+    int chan_num = 0;
+    DIR* dir;
+    int i;
 
-    dev->datasize = 0;
+    cache = mraa_iio_cache(dev);
+    if (cache == NULL) {
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    mraa_iio_drop_channels(dev);
 
-    memset(buf, 0, MAX_SIZE);
     snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/" IIO_SCAN_ELEM, dev->num);
     dir = opendir(buf);
-    if (dir != NULL) {
-        while ((ent = readdir(dir)) != NULL) {
-            if (strcmp(ent->d_name + strlen(ent->d_name) - strlen("_en"), "_en") == 0) {
-                chan_num++;
-            }
+    if (dir == NULL) {
+        // device without a buffer
+        return MRAA_SUCCESS;
+    }
+    while ((ent = readdir(dir)) != NULL) {
+        if (mraa_iio_has_suffix(ent->d_name, "_index")) {
+            chan_num++;
         }
     }
-    dev->chan_num = chan_num;
     // no need proceed if no channel found
     if (chan_num == 0) {
         closedir(dir);
         return MRAA_SUCCESS;
     }
-    mraa_iio_channel* chan;
     dev->channels = calloc(chan_num, sizeof(mraa_iio_channel));
-    seekdir(dir, 0);
+    cache->prefix = calloc(chan_num, sizeof(char*));
+    cache->en_fd = malloc(chan_num * sizeof(int));
+    if (dev->channels == NULL || cache->prefix == NULL || cache->en_fd == NULL) {
+        syslog(LOG_CRIT, "iio: device %d: Failed to allocate memory for channels", dev->num);
+        closedir(dir);
+        mraa_iio_drop_channels(dev);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    for (i = 0; i < chan_num; i++) {
+        cache->en_fd[i] = -1;
+    }
+    dev->chan_num = chan_num;
+
+    rewinddir(dir);
     while ((ent = readdir(dir)) != NULL) {
-        if (strcmp(ent->d_name + strlen(ent->d_name) - strlen("_index"), "_index") == 0) {
-            snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/" IIO_SCAN_ELEM "/%s", dev->num, ent->d_name);
-            fd = open(buf, O_RDONLY);
-            if (fd != -1) {
-                if (read(fd, readbuf, 2 * sizeof(char)) != 2) {
-                    close(fd);
-                    break;
-                }
-                chan_num = ((int) strtol(readbuf, NULL, 10));
-                chan = &dev->channels[chan_num];
-                chan->index = chan_num;
-                close(fd);
-
-                buf[(strlen(buf) - 5)] = '\0';
-                char* str = strdup(buf);
-                // grab the type of the buffer
-                snprintf(buf, MAX_SIZE, "%stype", str);
-                fd = open(buf, O_RDONLY);
-                if (fd != -1) {
-                    read(fd, readbuf, 31 * sizeof(char));
-                    ret = sscanf(readbuf, "%ce:%c%u/%u>>%u", &shortbuf, &signchar, &chan->bits_used,
-                                 &padint, &chan->shift);
-                    // probably should be 5?
-                    if (ret < 0) {
-                        // cleanup
-                        free(str);
-                        close(fd);
-                        return MRAA_IO_SETUP_FAILURE;
-                    }
-                    chan->bytes = padint / 8;
-                    chan->signedd = (signchar == 's');
-                    chan->lendian = (shortbuf == 'l');
-                    if (chan->bits_used == 64) {
-                        chan->mask = ~0;
-                    } else {
-                        chan->mask = (1 << chan->bits_used) - 1;
-                    }
-                    close(fd);
-                }
-                // grab the enable flag of channel
-                snprintf(buf, MAX_SIZE, "%sen", str);
-                fd = open(buf, O_RDONLY);
-                if (fd != -1) {
-                    if (read(fd, readbuf, 2 * sizeof(char)) != 2) {
-                        syslog(LOG_ERR, "iio: Failed to read a sensible value from sysfs");
-                        free(str);
-                        close(fd);
-                        return -1;
-                    }
-                    chan->enabled = (int) strtol(readbuf, NULL, 10);
-                    // only calculate enable buffer size for trigger buffer extract data
-                    if (chan->enabled) {
-                        dev->datasize += chan->bytes;
-                    }
-                    close(fd);
-                }
-                // clean up str var
-                free(str);
-            }
+        size_t n = strlen(ent->d_name) - strlen("_index");
+        char endian, sign;
+        unsigned int bits, storage, shift;
+        mraa_iio_channel* chan;
+        char* prefix;
+        int index;
+
+        if (!mraa_iio_has_suffix(ent->d_name, "_index")) {
+            continue;
+        }
+        snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/" IIO_SCAN_ELEM "/%s", dev->num, ent->d_name);
+        if (mraa_iio_read_sysfs(buf, readbuf, sizeof(readbuf)) != MRAA_SUCCESS ||
+            sscanf(readbuf, "%d", &index) != 1) {
+            continue;
+        }
+        if (index < 0 || index >= chan_num || cache->prefix[index] != NULL) {
+            syslog(LOG_ERR, "iio: device %d: %s has unexpected index %d", dev->num, ent->d_name, index);
+            continue;
+        }
+        prefix = malloc(n + 1);
+        if (prefix == NULL) {
+            closedir(dir);
+            mraa_iio_drop_channels(dev);
+            return MRAA_ERROR_NO_RESOURCES;
         }
+        memcpy(prefix, ent->d_name, n);
+        prefix[n] = '\0';
+        cache->prefix[index] = prefix;
+
+        // grab the type of the buffer, le:s12/16>>4
+        snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/" IIO_SCAN_ELEM "/%s_type", dev->num, prefix);
+        if (mraa_iio_read_sysfs(buf, readbuf, sizeof(readbuf)) != MRAA_SUCCESS ||
+            sscanf(readbuf, "%ce:%c%u/%u>>%u", &endian, &sign, &bits, &storage, &shift) != 5) {
+            syslog(LOG_ERR, "iio: device %d: unreadable %s_type", dev->num, prefix);
+            closedir(dir);
+            mraa_iio_drop_channels(dev);
+            return MRAA_IO_SETUP_FAILURE;
+        }
+        chan = &dev->channels[index];
+        chan->index = index;
+        chan->bits_used = bits;
+        chan->bytes = storage / 8;
+        chan->shift = shift;
+        chan->signedd = (sign == 's');
+        chan->lendian = (endian == 'l');
+        chan->mask = bits >= 64 ? ~0ULL : (1ULL << bits) - 1;
+
+        // the enable flag is read again on every update
+        snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/" IIO_SCAN_ELEM "/%s_en", dev->num, prefix);
+        cache->en_fd[index] = open(buf, O_RDONLY);
     }
     closedir(dir);
 
-    // channel location has to be done in channel index order so do it after we
-    // have grabbed all the correct info
     for (i = 0; i < dev->chan_num; i++) {
-        chan = &dev->channels[i];
-
-        if(chan->bytes <= 0)
-        {
-            syslog(LOG_ERR, "iio: Channel %d with channel bytes value <= 0");
+        if (dev->channels[i].bytes == 0) {
+            syslog(LOG_ERR, "iio: Channel %d with channel bytes value <= 0", i);
+            mraa_iio_drop_channels(dev);
             return MRAA_IO_SETUP_FAILURE;
         }
-
-        if (curr_bytes % chan->bytes == 0) {
-            chan->location = curr_bytes;
-        } else {
-            chan->location = curr_bytes - curr_bytes % chan->bytes + chan->bytes;
-        }
-        curr_bytes = chan->location + chan->bytes;
     }
 
-    return MRAA_SUCCESS;
+    return mraa_iio_read_enables(dev);
 }
 
 const char*
@@ -188,6 +492,7 @@ mraa_iio_get_device_num_by_name(const char* name)
 {
     int i;
 
+    mraa_iio_detect();
     if (plat_iio == NULL) {
         syslog(LOG_ERR, "iio: platform IIO structure is not initialized");
         return -1;
@@ -202,7 +507,7 @@ mraa_iio_get_device_num_by_name(const char* name)
         struct _iio* device;
         device = &plat_iio->iio_devices[i];
         // we want to check for exact match
-        if (strncmp(device->name, name, strlen(device->name) + 1) == 0) {
+        if (device->name != NULL && strcmp(device->name, name) == 0) {
             return device->num;
         }
     }
@@ -238,18 +543,19 @@ mraa_iio_read_int(mraa_iio_context dev, const char* attr_name, int* data)
 mraa_result_t
 mraa_iio_read_string(mraa_iio_context dev, const char* attr_name, char* data, int max_len)
 {
-    char buf[MAX_SIZE];
-    mraa_result_t result = MRAA_ERROR_UNSPECIFIED;
-    snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/%s", dev->num, attr_name);
-    int fd = open(buf, O_RDONLY);
-    if (fd != -1) {
-        ssize_t len = read(fd, data, max_len);
-        if (len > 0)
-            result = MRAA_SUCCESS;
-        close(fd);
-    }
-    return result;
+    ssize_t len;
 
+    if (max_len <= 0) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    len = mraa_iio_attr_io(dev, attr_name, data, max_len, O_RDONLY);
+    if (len <= 0) {
+        return MRAA_ERROR_UNSPECIFIED;
+    }
+    if (len < max_len) {
+        data[len] = '\0';
+    }
+    return MRAA_SUCCESS;
 }
 
 mraa_result_t
@@ -271,178 +577,562 @@ mraa_iio_write_int(mraa_iio_context dev, const char* attr_name, const int data)
 mraa_result_t
 mraa_iio_write_string(mraa_iio_context dev, const char* attr_name, const char* data)
 {
-    char buf[MAX_SIZE];
-    mraa_result_t result = MRAA_ERROR_UNSPECIFIED;
-    snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/%s", dev->num, attr_name);
-    int fd = open(buf, O_WRONLY);
-    if (fd != -1) {
-        int len = strlen(data);
-        ssize_t status = write(fd, data, len);
-        if (status == len)
-             result = MRAA_SUCCESS;
-        close(fd);
+    ssize_t len = strlen(data);
+
+    if (mraa_iio_attr_io(dev, attr_name, (void*) data, len, O_WRONLY) != len) {
+        return MRAA_ERROR_UNSPECIFIED;
     }
-    return result;
+    return MRAA_SUCCESS;
 }
 
-static mraa_result_t
-mraa_iio_wait_event(int fd, char* data, int* read_size)
+static int64_t
+mraa_iio_now_ns()
 {
-    struct pollfd pfd;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
 
-    if (fd < 0) {
-        return MRAA_ERROR_INVALID_RESOURCE;
+static struct _iio_buffer*
+mraa_iio_buffer(mraa_iio_context dev)
+{
+    if (dev->buffer == NULL) {
+        dev->buffer = calloc(1, sizeof(struct _iio_buffer));
     }
+    return dev->buffer;
+}
 
-    pfd.fd = fd;
-    pfd.events = POLLIN;
-
-    // Wait for it forever or until pthread_cancel
-    // poll is a cancelable point like sleep()
-    poll(&pfd, 1, -1);
+mraa_result_t
+mraa_iio_set_buffer(mraa_iio_context dev, unsigned int length, unsigned int watermark)
+{
+    if (dev == NULL) {
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (dev->sources & IIO_SOURCE_BUFFER) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    struct _iio_buffer* buf = mraa_iio_buffer(dev);
+    if (buf == NULL) {
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    if (length > 0 && mraa_iio_write_int(dev, "buffer/length", length) != MRAA_SUCCESS) {
+        syslog(LOG_ERR, "iio: device %d: failed to set buffer length %u", dev->num, length);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    // older kernels have no watermark and wake the reader for every scan
+    if (watermark > 0 && mraa_iio_write_int(dev, "buffer/watermark", watermark) != MRAA_SUCCESS) {
+        syslog(LOG_NOTICE, "iio: device %d: buffer watermark not supported", dev->num);
+    }
+    buf->length = length;
+    return MRAA_SUCCESS;
+}
 
-    memset(data, 0, 100);
-    *read_size = read(fd, data, 100);
+static unsigned int
+mraa_iio_ring_used(struct _iio_buffer* buf, unsigned int head, unsigned int tail)
+{
+    return head >= tail ? head - tail : head + 2 * buf->depth - tail;
+}
 
-    return MRAA_SUCCESS;
+static unsigned int
+mraa_iio_ring_next(struct _iio_buffer* buf, unsigned int pos)
+{
+    return pos + 1 == 2 * buf->depth ? 0 : pos + 1;
 }
 
-static void*
-mraa_iio_trigger_handler(void* arg)
+/* Copy scans into the ring, single producer so only head moves here */
+static void
+mraa_iio_ring_push(struct _iio_buffer* buf, int size, int scans, int64_t timestamp)
 {
-    mraa_iio_context dev = (mraa_iio_context) arg;
+    unsigned int head = buf->head;
+    unsigned int tail = __atomic_load_n(&buf->tail, __ATOMIC_ACQUIRE);
     int i;
-    char data[MAX_SIZE * 100];
-    int read_size;
 
-    for (;;) {
-        if (mraa_iio_wait_event(dev->fp, &data[0], &read_size) == MRAA_SUCCESS) {
-#ifdef HAVE_PTHREAD_CANCEL
-            pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
-#endif
-            // only can process if readsize >= enabled channel's datasize
-            for (i = 0; i < (read_size / dev->datasize); i++) {
-                dev->isr((char*)&data, (void*)dev->isr_args);
-            }
-#ifdef HAVE_PTHREAD_CANCEL
-            pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
-#endif
-        } else {
-            // we must have got an error code so die nicely
-#ifdef HAVE_PTHREAD_CANCEL
-            pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
-#endif
-            return NULL;
+    for (i = 0; i < scans; i++) {
+        if (mraa_iio_ring_used(buf, head, tail) == buf->depth) {
+            __atomic_fetch_add(&buf->overruns, scans - i, __ATOMIC_RELAXED);
+            break;
         }
+        unsigned int slot = head % buf->depth;
+        memcpy(buf->ring + (size_t) slot * size, buf->data + (size_t) i * size, size);
+        buf->stamps[slot] = timestamp;
+        head = mraa_iio_ring_next(buf, head);
     }
+    __atomic_store_n(&buf->head, head, __ATOMIC_RELEASE);
 }
 
-mraa_result_t
-mraa_iio_trigger_buffer(mraa_iio_context dev, void (*fptr)(char*, void*), void* args)
+/*
+ * One thread waits on the buffer and event fds of every device with
+ * epoll, so sensors sharing a trigger are served in the same wakeup.
+ * Sources are keyed by context pointer with the kind in its low bits.
+ * epoch counts dispatch rounds: a source is only torn down once the round
+ * that may be using it has finished.
+ */
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t round;
+    int epfd;
+    int wakefd;
+    pthread_t thread;
+    mraa_boolean_t started; /**< thread created and not joined yet */
+    mraa_boolean_t alive;   /**< thread is dispatching */
+    mraa_boolean_t stop;
+    unsigned long epoch;
+} iio_reactor = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, -1, -1 };
+
+static uint64_t
+mraa_iio_reactor_key(mraa_iio_context dev, unsigned int kind)
 {
-    char bu[MAX_SIZE];
-    if (dev->thread_id != 0) {
-        return MRAA_ERROR_NO_RESOURCES;
-    }
-
-    snprintf(bu, MAX_SIZE, IIO_SLASH_DEV "%d", dev->num);
-    dev->fp = open(bu, O_RDONLY | O_NONBLOCK);
-    if (dev->fp == -1) {
-        return MRAA_ERROR_INVALID_RESOURCE;
-    }
+    return (uint64_t) (uintptr_t) dev | kind;
+}
 
-    dev->isr = fptr;
-    dev->isr_args = args;
-    pthread_create(&dev->thread_id, NULL, mraa_iio_trigger_handler, (void*) dev);
+/* Read everything the kernel has, it hands out whole scans only */
+static mraa_boolean_t
+mraa_iio_dispatch_buffer(mraa_iio_context dev)
+{
+    struct _iio_buffer* buf = dev->buffer;
+    int size = dev->datasize;
+    size_t want = (size_t) buf->scans * size;
+    ssize_t n;
+    int i;
 
-    return MRAA_SUCCESS;
+    do {
+        n = read(dev->fp, buf->data, want);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                return 1;
+            }
+            syslog(LOG_ERR, "iio: device %d: buffer read failed: %s", dev->num, strerror(errno));
+            return 0;
+        }
+        int scans = (int) (n / size);
+        if (scans > 0) {
+            int64_t timestamp = mraa_iio_now_ns();
+            if (buf->ring != NULL) {
+                mraa_iio_ring_push(buf, size, scans, timestamp);
+            } else if (buf->batch != NULL) {
+                buf->batch(buf->data, scans, timestamp, dev->isr_args);
+            } else {
+                for (i = 0; i < scans && (dev->sources & IIO_SOURCE_BUFFER); i++) {
+                    dev->isr(buf->data + (size_t) i * size, dev->isr_args);
+                }
+            }
+        }
+        // a callback may have closed its device
+    } while ((size_t) n == want && (dev->sources & IIO_SOURCE_BUFFER));
+    return 1;
 }
 
-mraa_result_t
-mraa_iio_get_event_data(mraa_iio_context dev)
+static mraa_boolean_t
+mraa_iio_dispatch_events(mraa_iio_context dev)
 {
-    const struct dirent* ent;
-    DIR* dir;
-    int event_num = 0;
-    char buf[MAX_SIZE];
-    char readbuf[32];
-    int fd;
+    struct iio_event_data data[IIO_REACTOR_BATCH];
+    ssize_t n;
+    int i;
 
-    memset(buf, 0, MAX_SIZE);
-    memset(readbuf, 0, 32);
-    snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/" IIO_EVENTS, dev->num);
-    dir = opendir(buf);
-    if (dir != NULL) {
-        while ((ent = readdir(dir)) != NULL) {
-            if (strcmp(ent->d_name + strlen(ent->d_name) - strlen("_en"), "_en") == 0) {
-                event_num++;
+    do {
+        n = read(dev->fp_event, data, sizeof(data));
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                return 1;
             }
+            syslog(LOG_ERR, "iio: device %d: event read failed: %s", dev->num, strerror(errno));
+            return 0;
         }
-        dev->event_num = event_num;
-        // no need proceed if no event found
-        if (event_num == 0) {
-            closedir(dir);
-            return MRAA_SUCCESS;
+        for (i = 0; i < (int) (n / sizeof(struct iio_event_data)) && (dev->sources & IIO_SOURCE_EVENT); i++) {
+            dev->isr_event(&data[i], dev->isr_event_args);
         }
-        mraa_iio_event* event;
-        dev->events = calloc(event_num, sizeof(mraa_iio_event));
-        if (dev->events == NULL) {
-            closedir(dir);
-            return MRAA_ERROR_UNSPECIFIED;
+    } while ((size_t) n == sizeof(data) && (dev->sources & IIO_SOURCE_EVENT));
+    return 1;
+}
+
+static void*
+mraa_iio_reactor_run(void* arg)
+{
+    struct epoll_event evs[IIO_REACTOR_BATCH];
+    mraa_boolean_t stop = 0;
+    uint64_t wake;
+    int n, i;
+
+    while (!stop) {
+        n = epoll_wait(iio_reactor.epfd, evs, IIO_REACTOR_BATCH, -1);
+        if (n < 0 && errno != EINTR) {
+            syslog(LOG_ERR, "iio: reactor: epoll_wait failed: %s", strerror(errno));
+            stop = 1;
         }
-        rewinddir(dir);
-        event_num = 0;
-        while ((ent = readdir(dir)) != NULL) {
-            if (strcmp(ent->d_name + strlen(ent->d_name) - strlen("_en"), "_en") == 0) {
-                event = &dev->events[event_num];
-                event->name = strdup(ent->d_name);
-                snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/" IIO_EVENTS "/%s", dev->num, ent->d_name);
-                fd = open(buf, O_RDONLY);
-                if (fd != -1) {
-                    if (read(fd, readbuf, 2 * sizeof(char)) != 2) {
-                        close(fd);
-                        break;
-                    }
-                    close(fd);
+        for (i = 0; i < n; i++) {
+            if (evs[i].data.u64 == IIO_REACTOR_WAKE) {
+                if (read(iio_reactor.wakefd, &wake, sizeof(wake)) < 0) {
+                    // nothing pending, another round already consumed it
                 }
-                event->enabled = ((int) strtol(readbuf, NULL, 10));
-                // Todo, read other event info.
-                event_num++;
+                continue;
+            }
+            mraa_iio_context dev = (mraa_iio_context) (uintptr_t) (evs[i].data.u64 & ~(uint64_t) 3);
+            unsigned int kind = evs[i].data.u64 & 3;
+            // removed earlier in this round
+            if (!(__atomic_load_n(&dev->sources, __ATOMIC_ACQUIRE) & kind)) {
+                continue;
+            }
+            mraa_boolean_t ok = kind == IIO_SOURCE_BUFFER ? mraa_iio_dispatch_buffer(dev) :
+                                                            mraa_iio_dispatch_events(dev);
+            if (!ok) {
+                pthread_mutex_lock(&iio_reactor.lock);
+                if (dev->sources & kind) {
+                    __atomic_and_fetch(&dev->sources, ~kind, __ATOMIC_RELEASE);
+                    epoll_ctl(iio_reactor.epfd, EPOLL_CTL_DEL, kind == IIO_SOURCE_BUFFER ? dev->fp : dev->fp_event, NULL);
+                }
+                pthread_mutex_unlock(&iio_reactor.lock);
             }
         }
-        closedir(dir);
+        pthread_mutex_lock(&iio_reactor.lock);
+        iio_reactor.epoch++;
+        stop = stop || iio_reactor.stop;
+        if (stop) {
+            iio_reactor.alive = 0;
+        }
+        pthread_cond_broadcast(&iio_reactor.round);
+        pthread_mutex_unlock(&iio_reactor.lock);
     }
-    return MRAA_SUCCESS;
+    return NULL;
 }
 
+/* Called with the reactor lock held */
 static mraa_result_t
-mraa_iio_event_poll_nonblock(int fd, struct iio_event_data* data)
+mraa_iio_reactor_start()
 {
-    struct pollfd pfd;
+    struct epoll_event ev;
 
-    if (fd < 0) {
-        return MRAA_ERROR_INVALID_RESOURCE;
+    if (iio_reactor.started) {
+        // the previous thread died on an error, it no longer holds the lock
+        pthread_join(iio_reactor.thread, NULL);
+        iio_reactor.started = 0;
     }
-
-    pfd.fd = fd;
-    pfd.events = POLLIN;
-
-    // Wait for it forever or until pthread_cancel
-    // poll is a cancelable point like sleep()
-    poll(&pfd, 1, -1);
-
-    read(fd, data, sizeof(struct iio_event_data));
-
+    if (iio_reactor.epfd < 0) {
+        iio_reactor.epfd = epoll_create1(EPOLL_CLOEXEC);
+        iio_reactor.wakefd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.u64 = IIO_REACTOR_WAKE;
+        if (iio_reactor.epfd < 0 || iio_reactor.wakefd < 0 ||
+            epoll_ctl(iio_reactor.epfd, EPOLL_CTL_ADD, iio_reactor.wakefd, &ev) != 0) {
+            syslog(LOG_ERR, "iio: reactor: failed to set up epoll: %s", strerror(errno));
+            if (iio_reactor.epfd >= 0) {
+                close(iio_reactor.epfd);
+            }
+            if (iio_reactor.wakefd >= 0) {
+                close(iio_reactor.wakefd);
+            }
+            iio_reactor.epfd = iio_reactor.wakefd = -1;
+            return MRAA_ERROR_NO_RESOURCES;
+        }
+    }
+    iio_reactor.stop = 0;
+    iio_reactor.alive = 1;
+    if (pthread_create(&iio_reactor.thread, NULL, mraa_iio_reactor_run, NULL) != 0) {
+        iio_reactor.alive = 0;
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    iio_reactor.started = 1;
     return MRAA_SUCCESS;
 }
 
-mraa_result_t
-mraa_iio_event_poll(mraa_iio_context dev, struct iio_event_data* data)
+static mraa_result_t
+mraa_iio_reactor_add(mraa_iio_context dev, int fd, unsigned int kind)
 {
-    char bu[MAX_SIZE];
-    int ret;
-    int event_fd;
-    int fd;
+    struct epoll_event ev;
+    mraa_result_t ret = MRAA_SUCCESS;
+
+    pthread_mutex_lock(&iio_reactor.lock);
+    if (!iio_reactor.alive) {
+        ret = mraa_iio_reactor_start();
+    }
+    if (ret == MRAA_SUCCESS) {
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.u64 = mraa_iio_reactor_key(dev, kind);
+        // set first so data already waiting is not skipped
+        __atomic_or_fetch(&dev->sources, kind, __ATOMIC_RELEASE);
+        if (epoll_ctl(iio_reactor.epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            syslog(LOG_ERR, "iio: device %d: epoll_ctl failed: %s", dev->num, strerror(errno));
+            __atomic_and_fetch(&dev->sources, ~kind, __ATOMIC_RELEASE);
+            ret = MRAA_ERROR_INVALID_RESOURCE;
+        }
+    }
+    pthread_mutex_unlock(&iio_reactor.lock);
+    return ret;
+}
+
+/* Once this returns no callback of the source is running, except the caller */
+static void
+mraa_iio_reactor_remove(mraa_iio_context dev, int fd, unsigned int kind)
+{
+    unsigned long epoch;
+    uint64_t one = 1;
+
+    pthread_mutex_lock(&iio_reactor.lock);
+    if (dev->sources & kind) {
+        __atomic_and_fetch(&dev->sources, ~kind, __ATOMIC_RELEASE);
+        epoll_ctl(iio_reactor.epfd, EPOLL_CTL_DEL, fd, NULL);
+    }
+    // callbacks may close their own device
+    if (iio_reactor.alive && !pthread_equal(pthread_self(), iio_reactor.thread)) {
+        epoch = iio_reactor.epoch;
+        if (write(iio_reactor.wakefd, &one, sizeof(one)) != sizeof(one)) {
+            syslog(LOG_ERR, "iio: reactor: failed to wake: %s", strerror(errno));
+        }
+        while (iio_reactor.alive && iio_reactor.epoch == epoch) {
+            pthread_cond_wait(&iio_reactor.round, &iio_reactor.lock);
+        }
+    }
+    pthread_mutex_unlock(&iio_reactor.lock);
+}
+
+void
+mraa_iio_reactor_stop()
+{
+    uint64_t one = 1;
+
+    pthread_mutex_lock(&iio_reactor.lock);
+    if (iio_reactor.started) {
+        iio_reactor.stop = 1;
+        if (write(iio_reactor.wakefd, &one, sizeof(one)) != sizeof(one)) {
+            syslog(LOG_ERR, "iio: reactor: failed to wake: %s", strerror(errno));
+        }
+        pthread_mutex_unlock(&iio_reactor.lock);
+        pthread_join(iio_reactor.thread, NULL);
+        pthread_mutex_lock(&iio_reactor.lock);
+        iio_reactor.started = 0;
+    }
+    if (iio_reactor.epfd >= 0) {
+        close(iio_reactor.epfd);
+        close(iio_reactor.wakefd);
+        iio_reactor.epfd = iio_reactor.wakefd = -1;
+    }
+    pthread_mutex_unlock(&iio_reactor.lock);
+}
+
+/*
+ * Scan elements may have been enabled since init, so the layout is read
+ * again. A context handed an open buffer fd instead of /dev/iio:deviceN,
+ * as the unit tests do, keeps the layout it came with.
+ */
+static mraa_result_t
+mraa_iio_trigger_layout(mraa_iio_context dev)
+{
+    if (dev->fp < 0) {
+        mraa_iio_update_channels(dev);
+    }
+    if (dev->datasize <= 0) {
+        syslog(LOG_ERR, "iio: device %d: no scan elements enabled", dev->num);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    return MRAA_SUCCESS;
+}
+
+static mraa_result_t
+mraa_iio_trigger_start(mraa_iio_context dev)
+{
+    char bu[MAX_SIZE];
+    struct _iio_buffer* buf = dev->buffer;
+
+    mraa_result_t ret = mraa_iio_trigger_layout(dev);
+    if (ret != MRAA_SUCCESS) {
+        return ret;
+    }
+    buf->scans = buf->length > 0 ? (int) buf->length : IIO_DEFAULT_READ_SCANS;
+    free(buf->data);
+    buf->data = malloc((size_t) buf->scans * dev->datasize);
+    if (buf->data == NULL) {
+        syslog(LOG_CRIT, "iio: device %d: Failed to allocate memory for scans", dev->num);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+
+    if (dev->fp < 0) {
+        snprintf(bu, MAX_SIZE, IIO_SLASH_DEV "%d", dev->num);
+        dev->fp = open(bu, O_RDONLY | O_NONBLOCK);
+        if (dev->fp == -1) {
+            return MRAA_ERROR_INVALID_RESOURCE;
+        }
+    }
+
+    ret = mraa_iio_reactor_add(dev, dev->fp, IIO_SOURCE_BUFFER);
+    if (ret != MRAA_SUCCESS) {
+        close(dev->fp);
+        dev->fp = -1;
+    }
+    return ret;
+}
+
+mraa_result_t
+mraa_iio_trigger_buffer(mraa_iio_context dev, void (*fptr)(char*, void*), void* args)
+{
+    if (dev->sources & IIO_SOURCE_BUFFER) {
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    struct _iio_buffer* buf = mraa_iio_buffer(dev);
+    if (buf == NULL) {
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+
+    dev->isr = fptr;
+    dev->isr_args = args;
+    buf->batch = NULL;
+    return mraa_iio_trigger_start(dev);
+}
+
+mraa_result_t
+mraa_iio_trigger_buffer_batch(mraa_iio_context dev, void (*fptr)(char* data, int scans, int64_t timestamp, void* args), void* args)
+{
+    if (dev == NULL || fptr == NULL) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    if (dev->sources & IIO_SOURCE_BUFFER) {
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    struct _iio_buffer* buf = mraa_iio_buffer(dev);
+    if (buf == NULL) {
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+
+    buf->batch = fptr;
+    dev->isr_args = args;
+    return mraa_iio_trigger_start(dev);
+}
+
+mraa_result_t
+mraa_iio_trigger_buffer_ring(mraa_iio_context dev, unsigned int scans)
+{
+    if (dev == NULL || scans == 0 || scans > INT_MAX) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    if (dev->sources & IIO_SOURCE_BUFFER) {
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    struct _iio_buffer* buf = mraa_iio_buffer(dev);
+    if (buf == NULL) {
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    mraa_result_t ret = mraa_iio_trigger_layout(dev);
+    if (ret != MRAA_SUCCESS) {
+        return ret;
+    }
+
+    free(buf->ring);
+    free(buf->stamps);
+    buf->ring = malloc((size_t) scans * dev->datasize);
+    buf->stamps = malloc(scans * sizeof(int64_t));
+    if (buf->ring == NULL || buf->stamps == NULL) {
+        free(buf->ring);
+        free(buf->stamps);
+        buf->ring = NULL;
+        buf->stamps = NULL;
+        syslog(LOG_CRIT, "iio: device %d: Failed to allocate memory for ring", dev->num);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    buf->depth = scans;
+    buf->head = buf->tail = 0;
+    buf->overruns = 0;
+    buf->batch = NULL;
+
+    ret = mraa_iio_trigger_start(dev);
+    if (ret != MRAA_SUCCESS) {
+        free(buf->ring);
+        free(buf->stamps);
+        buf->ring = NULL;
+        buf->stamps = NULL;
+    }
+    return ret;
+}
+
+int
+mraa_iio_ring_read(mraa_iio_context dev, char* data, int64_t* timestamps, int scans)
+{
+    if (dev == NULL || dev->buffer == NULL || dev->buffer->ring == NULL || data == NULL || scans < 0) {
+        return -1;
+    }
+    struct _iio_buffer* buf = dev->buffer;
+    int size = dev->datasize;
+    unsigned int tail = buf->tail;
+    unsigned int head = __atomic_load_n(&buf->head, __ATOMIC_ACQUIRE);
+    int avail = (int) mraa_iio_ring_used(buf, head, tail);
+    int i;
+
+    if (avail > scans) {
+        avail = scans;
+    }
+    for (i = 0; i < avail; i++) {
+        unsigned int slot = tail % buf->depth;
+        memcpy(data + (size_t) i * size, buf->ring + (size_t) slot * size, size);
+        if (timestamps != NULL) {
+            timestamps[i] = buf->stamps[slot];
+        }
+        tail = mraa_iio_ring_next(buf, tail);
+    }
+    __atomic_store_n(&buf->tail, tail, __ATOMIC_RELEASE);
+    return avail;
+}
+
+unsigned long long
+mraa_iio_ring_overruns(mraa_iio_context dev)
+{
+    if (dev == NULL || dev->buffer == NULL) {
+        return 0;
+    }
+    return __atomic_load_n(&dev->buffer->overruns, __ATOMIC_RELAXED);
+}
+
+mraa_result_t
+mraa_iio_get_event_data(mraa_iio_context dev)
+{
+    const struct dirent* ent;
+    DIR* dir;
+    int event_num = 0;
+    char buf[MAX_SIZE];
+    char readbuf[32];
+
+    mraa_iio_drop_events(dev);
+    snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/" IIO_EVENTS, dev->num);
+    dir = opendir(buf);
+    if (dir == NULL) {
+        return MRAA_SUCCESS;
+    }
+    while ((ent = readdir(dir)) != NULL) {
+        if (mraa_iio_has_suffix(ent->d_name, "_en")) {
+            event_num++;
+        }
+    }
+    // no need proceed if no event found
+    if (event_num == 0) {
+        closedir(dir);
+        return MRAA_SUCCESS;
+    }
+    dev->events = calloc(event_num, sizeof(mraa_iio_event));
+    if (dev->events == NULL) {
+        closedir(dir);
+        return MRAA_ERROR_UNSPECIFIED;
+    }
+    rewinddir(dir);
+    while ((ent = readdir(dir)) != NULL && dev->event_num < event_num) {
+        if (mraa_iio_has_suffix(ent->d_name, "_en")) {
+            mraa_iio_event* event = &dev->events[dev->event_num++];
+            event->name = strdup(ent->d_name);
+            snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/" IIO_EVENTS "/%s", dev->num, ent->d_name);
+            if (mraa_iio_read_sysfs(buf, readbuf, sizeof(readbuf)) == MRAA_SUCCESS) {
+                event->enabled = ((int) strtol(readbuf, NULL, 10));
+            }
+            // Todo, read other event info.
+        }
+    }
+    closedir(dir);
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_iio_event_poll(mraa_iio_context dev, struct iio_event_data* data)
+{
+    char bu[MAX_SIZE];
+    int ret;
+    int event_fd;
+    int fd;
 
     snprintf(bu, MAX_SIZE, IIO_SLASH_DEV "%d", dev->num);
     fd = open(bu, 0);
@@ -462,57 +1152,39 @@ mraa_iio_event_poll(mraa_iio_context dev, struct iio_event_data* data)
     return MRAA_SUCCESS;
 }
 
-static void*
-mraa_iio_event_handler(void* arg)
-{
-    struct iio_event_data data;
-    mraa_iio_context dev = (mraa_iio_context) arg;
-
-    for (;;) {
-        if (mraa_iio_event_poll_nonblock(dev->fp_event, &data) == MRAA_SUCCESS) {
-#ifdef HAVE_PTHREAD_CANCEL
-            pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
-#endif
-            dev->isr_event(&data, dev->isr_args);
-#ifdef HAVE_PTHREAD_CANCEL
-            pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
-#endif
-        } else {
-            // we must have got an error code so die nicely
-#ifdef HAVE_PTHREAD_CANCEL
-            pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
-#endif
-            return NULL;
-        }
-    }
-}
-
 mraa_result_t
 mraa_iio_event_setup_callback(mraa_iio_context dev, void (*fptr)(struct iio_event_data* data, void* args), void* args)
 {
     int ret;
+    int fd, event_fd = -1;
     char bu[MAX_SIZE];
-    if (dev->thread_id != 0) {
+    if (dev->sources & IIO_SOURCE_EVENT) {
         return MRAA_ERROR_NO_RESOURCES;
     }
 
     snprintf(bu, MAX_SIZE, IIO_SLASH_DEV "%d", dev->num);
-    dev->fp = open(bu, O_RDONLY | O_NONBLOCK);
-    if (dev->fp == -1) {
+    fd = open(bu, O_RDONLY | O_NONBLOCK);
+    if (fd == -1) {
         return MRAA_ERROR_INVALID_RESOURCE;
     }
-    ret = ioctl(dev->fp, IIO_GET_EVENT_FD_IOCTL, &dev->fp_event);
-    close(dev->fp);
+    ret = ioctl(fd, IIO_GET_EVENT_FD_IOCTL, &event_fd);
+    close(fd);
 
-    if (ret == -1 || dev->fp_event == -1) {
+    if (ret == -1 || event_fd == -1) {
         return MRAA_ERROR_UNSPECIFIED;
     }
+    // the reactor drains it until EAGAIN
+    fcntl(event_fd, F_SETFL, O_NONBLOCK);
 
+    dev->fp_event = event_fd;
     dev->isr_event = fptr;
-    dev->isr_args = args;
-    pthread_create(&dev->thread_id, NULL, mraa_iio_event_handler, (void*) dev);
-
-    return MRAA_SUCCESS;
+    dev->isr_event_args = args;
+    ret = mraa_iio_reactor_add(dev, event_fd, IIO_SOURCE_EVENT);
+    if (ret != MRAA_SUCCESS) {
+        close(event_fd);
+        dev->fp_event = -1;
+    }
+    return ret;
 }
 
 mraa_result_t
@@ -557,6 +1229,438 @@ mraa_iio_get_mount_matrix(mraa_iio_context dev, const char *sysfs_name, float mm
     return MRAA_ERROR_UNSPECIFIED;
 }
 
+int64_t
+mraa_iio_channel_value(const char* scan, const mraa_iio_channel* chan)
+{
+    const unsigned char* p = (const unsigned char*) scan + chan->location;
+    uint64_t v = 0;
+    unsigned int i;
+
+    if (chan->lendian) {
+        for (i = chan->bytes; i-- > 0;) {
+            v = (v << 8) | p[i];
+        }
+    } else {
+        for (i = 0; i < chan->bytes; i++) {
+            v = (v << 8) | p[i];
+        }
+    }
+    v >>= chan->shift;
+    if (chan->bits_used > 0 && chan->bits_used < 64) {
+        uint64_t mask = ((uint64_t) 1 << chan->bits_used) - 1;
+        v &= mask;
+        if (chan->signedd && (v >> (chan->bits_used - 1)) & 1) {
+            v |= ~mask;
+        }
+    }
+    return (int64_t) v;
+}
+
+/* Channels stored as le:sN/N>>0 are plain native integers on little endian hosts */
+static int
+mraa_iio_native_signed(const mraa_iio_channel* chan, unsigned int bytes)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return chan->lendian && chan->signedd && chan->bytes == bytes && chan->bits_used == bytes * 8 && chan->shift == 0;
+#else
+    return 0;
+#endif
+}
+
+static inline int32_t
+mraa_iio_load_s16(const char* p)
+{
+    int16_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline int32_t
+mraa_iio_load_s32(const char* p)
+{
+    int32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/* pinsrw gathers eight strided samples, then they are widened and scaled */
+__attribute__((target("sse2"))) static int
+mraa_iio_demux_s16_simd(const char* p, size_t stride, int scans, float scale, float bias, float* out)
+{
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 b = _mm_set1_ps(bias);
+    int i;
+
+    for (i = 0; i + 8 <= scans; i += 8) {
+        const char* q = p + i * stride;
+        __m128i v = _mm_setzero_si128();
+        v = _mm_insert_epi16(v, mraa_iio_load_s16(q), 0);
+        v = _mm_insert_epi16(v, mraa_iio_load_s16(q + stride), 1);
+        v = _mm_insert_epi16(v, mraa_iio_load_s16(q + 2 * stride), 2);
+        v = _mm_insert_epi16(v, mraa_iio_load_s16(q + 3 * stride), 3);
+        v = _mm_insert_epi16(v, mraa_iio_load_s16(q + 4 * stride), 4);
+        v = _mm_insert_epi16(v, mraa_iio_load_s16(q + 5 * stride), 5);
+        v = _mm_insert_epi16(v, mraa_iio_load_s16(q + 6 * stride), 6);
+        v = _mm_insert_epi16(v, mraa_iio_load_s16(q + 7 * stride), 7);
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(lo), s), b));
+        _mm_storeu_ps(out + i + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(hi), s), b));
+    }
+    return i;
+}
+
+__attribute__((target("sse2"))) static int
+mraa_iio_demux_s32_simd(const char* p, size_t stride, int scans, float scale, float bias, float* out)
+{
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 b = _mm_set1_ps(bias);
+    int i;
+
+    for (i = 0; i + 4 <= scans; i += 4) {
+        const char* q = p + i * stride;
+        __m128i v = _mm_set_epi32(mraa_iio_load_s32(q + 3 * stride), mraa_iio_load_s32(q + 2 * stride),
+                                  mraa_iio_load_s32(q + stride), mraa_iio_load_s32(q));
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(v), s), b));
+    }
+    return i;
+}
+
+__attribute__((target("sse2"))) static int
+mraa_iio_mount_simd(const float mm[9], float* x, float* y, float* z, int scans)
+{
+    int i;
+
+    for (i = 0; i + 4 <= scans; i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 vy = _mm_loadu_ps(y + i);
+        __m128 vz = _mm_loadu_ps(z + i);
+        __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(mm[0])), _mm_mul_ps(vy, _mm_set1_ps(mm[1]))),
+                               _mm_mul_ps(vz, _mm_set1_ps(mm[2])));
+        __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(mm[3])), _mm_mul_ps(vy, _mm_set1_ps(mm[4]))),
+                               _mm_mul_ps(vz, _mm_set1_ps(mm[5])));
+        __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(mm[6])), _mm_mul_ps(vy, _mm_set1_ps(mm[7]))),
+                               _mm_mul_ps(vz, _mm_set1_ps(mm[8])));
+        _mm_storeu_ps(x + i, rx);
+        _mm_storeu_ps(y + i, ry);
+        _mm_storeu_ps(z + i, rz);
+    }
+    return i;
+}
+
+static int
+mraa_iio_has_simd()
+{
+    static int has_sse2 = -1;
+    if (has_sse2 < 0) {
+        __builtin_cpu_init();
+        has_sse2 = __builtin_cpu_supports("sse2");
+    }
+    return has_sse2;
+}
+#elif defined(__aarch64__)
+static int
+mraa_iio_demux_s16_simd(const char* p, size_t stride, int scans, float scale, float bias, float* out)
+{
+    const float32x4_t b = vdupq_n_f32(bias);
+    int i;
+
+    for (i = 0; i + 8 <= scans; i += 8) {
+        const char* q = p + i * stride;
+        int16x8_t v = vdupq_n_s16(0);
+        v = vsetq_lane_s16(mraa_iio_load_s16(q), v, 0);
+        v = vsetq_lane_s16(mraa_iio_load_s16(q + stride), v, 1);
+        v = vsetq_lane_s16(mraa_iio_load_s16(q + 2 * stride), v, 2);
+        v = vsetq_lane_s16(mraa_iio_load_s16(q + 3 * stride), v, 3);
+        v = vsetq_lane_s16(mraa_iio_load_s16(q + 4 * stride), v, 4);
+        v = vsetq_lane_s16(mraa_iio_load_s16(q + 5 * stride), v, 5);
+        v = vsetq_lane_s16(mraa_iio_load_s16(q + 6 * stride), v, 6);
+        v = vsetq_lane_s16(mraa_iio_load_s16(q + 7 * stride), v, 7);
+        vst1q_f32(out + i, vmlaq_n_f32(b, vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(out + i + 4, vmlaq_n_f32(b, vcvtq_f32_s32(vmovl_high_s16(v)), scale));
+    }
+    return i;
+}
+
+static int
+mraa_iio_demux_s32_simd(const char* p, size_t stride, int scans, float scale, float bias, float* out)
+{
+    const float32x4_t b = vdupq_n_f32(bias);
+    int i;
+
+    for (i = 0; i + 4 <= scans; i += 4) {
+        const char* q = p + i * stride;
+        int32x4_t v = vdupq_n_s32(0);
+        v = vsetq_lane_s32(mraa_iio_load_s32(q), v, 0);
+        v = vsetq_lane_s32(mraa_iio_load_s32(q + stride), v, 1);
+        v = vsetq_lane_s32(mraa_iio_load_s32(q + 2 * stride), v, 2);
+        v = vsetq_lane_s32(mraa_iio_load_s32(q + 3 * stride), v, 3);
+        vst1q_f32(out + i, vmlaq_n_f32(b, vcvtq_f32_s32(v), scale));
+    }
+    return i;
+}
+
+static int
+mraa_iio_mount_simd(const float mm[9], float* x, float* y, float* z, int scans)
+{
+    int i;
+
+    for (i = 0; i + 4 <= scans; i += 4) {
+        float32x4_t vx = vld1q_f32(x + i);
+        float32x4_t vy = vld1q_f32(y + i);
+        float32x4_t vz = vld1q_f32(z + i);
+        float32x4_t rx = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(vx, mm[0]), vy, mm[1]), vz, mm[2]);
+        float32x4_t ry = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(vx, mm[3]), vy, mm[4]), vz, mm[5]);
+        float32x4_t rz = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(vx, mm[6]), vy, mm[7]), vz, mm[8]);
+        vst1q_f32(x + i, rx);
+        vst1q_f32(y + i, ry);
+        vst1q_f32(z + i, rz);
+    }
+    return i;
+}
+
+static int
+mraa_iio_has_simd()
+{
+    return 1;
+}
+#endif
+
+static mraa_result_t
+mraa_iio_demux_check(mraa_iio_context dev, const char* data, int scans, const int* channels, int count, void* out)
+{
+    int i;
+
+    if (dev == NULL) {
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (data == NULL || channels == NULL || out == NULL || scans < 0 || count < 1 || dev->datasize <= 0) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    for (i = 0; i < count; i++) {
+        if (channels[i] < 0 || channels[i] >= dev->chan_num || !dev->channels[channels[i]].enabled) {
+            syslog(LOG_ERR, "iio: demux: channel %d is not in the scan", channels[i]);
+            return MRAA_ERROR_INVALID_PARAMETER;
+        }
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_iio_demux(mraa_iio_context dev, const char* data, int scans, const int* channels, int count, int32_t** out)
+{
+    mraa_result_t ret = mraa_iio_demux_check(dev, data, scans, channels, count, out);
+    size_t stride;
+    int c, i;
+
+    if (ret != MRAA_SUCCESS) {
+        return ret;
+    }
+    stride = dev->datasize;
+    for (c = 0; c < count; c++) {
+        const mraa_iio_channel* chan = &dev->channels[channels[c]];
+        const char* p = data + chan->location;
+        int32_t* o = out[c];
+
+        if (mraa_iio_native_signed(chan, 2)) {
+            for (i = 0; i < scans; i++) {
+                o[i] = mraa_iio_load_s16(p + i * stride);
+            }
+        } else if (mraa_iio_native_signed(chan, 4)) {
+            for (i = 0; i < scans; i++) {
+                o[i] = mraa_iio_load_s32(p + i * stride);
+            }
+        } else {
+            for (i = 0; i < scans; i++) {
+                o[i] = (int32_t) mraa_iio_channel_value(data + i * stride, chan);
+            }
+        }
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_iio_demux_float(mraa_iio_context dev,
+                     const char* data,
+                     int scans,
+                     const int* channels,
+                     int count,
+                     const float* scale,
+                     const float* offset,
+                     float** out)
+{
+    mraa_result_t ret = mraa_iio_demux_check(dev, data, scans, channels, count, out);
+    size_t stride;
+    int c, i;
+
+    if (ret != MRAA_SUCCESS) {
+        return ret;
+    }
+    stride = dev->datasize;
+    for (c = 0; c < count; c++) {
+        const mraa_iio_channel* chan = &dev->channels[channels[c]];
+        const char* p = data + chan->location;
+        float sc = scale != NULL ? scale[c] : 1.0f;
+        float bias = offset != NULL ? offset[c] * sc : 0.0f;
+        float* o = out[c];
+
+        i = 0;
+        if (mraa_iio_native_signed(chan, 2)) {
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+            if (mraa_iio_has_simd()) {
+                i = mraa_iio_demux_s16_simd(p, stride, scans, sc, bias, o);
+            }
+#endif
+            for (; i < scans; i++) {
+                o[i] = mraa_iio_load_s16(p + i * stride) * sc + bias;
+            }
+        } else if (mraa_iio_native_signed(chan, 4)) {
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+            if (mraa_iio_has_simd()) {
+                i = mraa_iio_demux_s32_simd(p, stride, scans, sc, bias, o);
+            }
+#endif
+            for (; i < scans; i++) {
+                o[i] = mraa_iio_load_s32(p + i * stride) * sc + bias;
+            }
+        } else {
+            for (; i < scans; i++) {
+                o[i] = (float) mraa_iio_channel_value(data + i * stride, chan) * sc + bias;
+            }
+        }
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_iio_apply_mount_matrix(const float mm[9], float* x, float* y, float* z, int scans)
+{
+    int i = 0;
+
+    if (mm == NULL || x == NULL || y == NULL || z == NULL || scans < 0) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+    if (mraa_iio_has_simd()) {
+        i = mraa_iio_mount_simd(mm, x, y, z, scans);
+    }
+#endif
+    for (; i < scans; i++) {
+        float vx = x[i], vy = y[i], vz = z[i];
+        x[i] = mm[0] * vx + mm[1] * vy + mm[2] * vz;
+        y[i] = mm[3] * vx + mm[4] * vy + mm[5] * vz;
+        z[i] = mm[6] * vx + mm[7] * vy + mm[8] * vz;
+    }
+    return MRAA_SUCCESS;
+}
+
+/* Find the in_<type>[N][_<modifier>] prefix of a scan element by its index */
+static mraa_result_t
+mraa_iio_channel_prefix(mraa_iio_context dev, int index, char* prefix, size_t len)
+{
+    const struct dirent* ent;
+    char buf[MAX_SIZE];
+    mraa_result_t ret = MRAA_ERROR_INVALID_PARAMETER;
+    DIR* dir;
+
+    if (dev->cache != NULL && dev->cache->prefix != NULL && index >= 0 && index < dev->chan_num &&
+        dev->cache->prefix[index] != NULL) {
+        if (strlen(dev->cache->prefix[index]) >= len) {
+            return MRAA_ERROR_INVALID_PARAMETER;
+        }
+        strcpy(prefix, dev->cache->prefix[index]);
+        return MRAA_SUCCESS;
+    }
+
+    snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/" IIO_SCAN_ELEM, dev->num);
+    dir = opendir(buf);
+    if (dir == NULL) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    while ((ent = readdir(dir)) != NULL) {
+        size_t n = strlen(ent->d_name);
+        int value;
+        if (n <= strlen("_index") || strcmp(ent->d_name + n - strlen("_index"), "_index") != 0) {
+            continue;
+        }
+        if (snprintf(buf, MAX_SIZE, IIO_SCAN_ELEM "/%s", ent->d_name) >= MAX_SIZE) {
+            continue;
+        }
+        if (mraa_iio_read_int(dev, buf, &value) == MRAA_SUCCESS && value == index &&
+            n - strlen("_index") < len) {
+            memcpy(prefix, ent->d_name, n - strlen("_index"));
+            prefix[n - strlen("_index")] = '\0';
+            ret = MRAA_SUCCESS;
+            break;
+        }
+    }
+    closedir(dir);
+    return ret;
+}
+
+/*
+ * Read <prefix>_<info>, falling back to the attribute shared by all
+ * channels of the type: in_accel_x_scale, then in_accel_scale.
+ */
+static mraa_result_t
+mraa_iio_channel_info(mraa_iio_context dev, const char* prefix, const char* info, float* value)
+{
+    char name[MAX_SIZE];
+    char attr[MAX_SIZE];
+    size_t base = prefix[0] == 'o' ? strlen("out_") : strlen("in_");
+
+    snprintf(name, MAX_SIZE, "%s", prefix);
+    for (;;) {
+        int len = snprintf(attr, MAX_SIZE, "%s_%s", name, info);
+        if (len > 0 && len < MAX_SIZE && mraa_iio_read_float(dev, attr, value) == MRAA_SUCCESS) {
+            return MRAA_SUCCESS;
+        }
+        size_t n = strlen(name);
+        char* dash = strchr(name, '-');
+        if (dash != NULL) {
+            // differential channel, in_voltage0-voltage1
+            *dash = '\0';
+        } else if (n > base && name[n - 1] >= '0' && name[n - 1] <= '9') {
+            while (n > base && name[n - 1] >= '0' && name[n - 1] <= '9') {
+                name[--n] = '\0';
+            }
+        } else {
+            char* us = strrchr(name, '_');
+            if (us == NULL || (size_t) (us - name) < base) {
+                return MRAA_ERROR_INVALID_RESOURCE;
+            }
+            *us = '\0';
+        }
+    }
+}
+
+mraa_result_t
+mraa_iio_get_channel_scale(mraa_iio_context dev, int index, float* scale, float* offset)
+{
+    char prefix[MAX_SIZE];
+
+    if (dev == NULL) {
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (scale == NULL || offset == NULL) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    mraa_result_t ret = mraa_iio_channel_prefix(dev, index, prefix, sizeof(prefix));
+    if (ret != MRAA_SUCCESS) {
+        syslog(LOG_ERR, "iio: device %d: no scan element with index %d", dev->num, index);
+        return ret;
+    }
+    // channels without the attributes are already in their units
+    if (mraa_iio_channel_info(dev, prefix, "scale", scale) != MRAA_SUCCESS) {
+        *scale = 1.0f;
+    }
+    if (mraa_iio_channel_info(dev, prefix, "offset", offset) != MRAA_SUCCESS) {
+        *offset = 0.0f;
+    }
+    return MRAA_SUCCESS;
+}
+
 mraa_result_t
 mraa_iio_create_trigger(mraa_iio_context dev, const char* trigger)
 {
@@ -577,73 +1681,38 @@ mraa_iio_create_trigger(mraa_iio_context dev, const char* trigger)
 mraa_result_t
 mraa_iio_update_channels(mraa_iio_context dev)
 {
-    const struct dirent* ent;
-    DIR* dir;
-    int chan_num = 0;
-    char buf[MAX_SIZE];
-    char readbuf[32];
-    int fd;
-    mraa_iio_channel* chan;
-
-    dev->datasize = 0;
-    memset(buf, 0, MAX_SIZE);
-    snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/" IIO_SCAN_ELEM, dev->num);
-    dir = opendir(buf);
-    if (dir != NULL) {
-        while ((ent = readdir(dir)) != NULL) {
-            if (strcmp(ent->d_name + strlen(ent->d_name) - strlen("_index"), "_index") == 0) {
-                snprintf(buf, MAX_SIZE, IIO_SYSFS_DEVICE "%d/" IIO_SCAN_ELEM "/%s", dev->num, ent->d_name);
-                fd = open(buf, O_RDONLY);
-                if (fd != -1) {
-                    if (read(fd, readbuf, 2 * sizeof(char)) != 2) {
-                        close(fd);
-                        break;
-                    }
-                    chan_num = ((int) strtol(readbuf, NULL, 10));
-                    if (chan_num >= 0 && chan_num < dev->chan_num) {
-                        chan = &dev->channels[chan_num];
-                        chan->index = chan_num;
-                        close(fd);
-
-                        buf[(strlen(buf) - 5)] = '\0';
-                        char* str = strdup(buf);
-                        // grab the enable flag of channel
-                        snprintf(buf, MAX_SIZE, "%sen", str);
-                        fd = open(buf, O_RDONLY);
-                        if (fd != -1) {
-                            if (read(fd, readbuf, 2 * sizeof(char)) != 2) {
-                                syslog(LOG_ERR, "iio: Failed to read a sensible value from sysfs");
-                                free(str);
-                                close(fd);
-                                closedir(dir);
-                                return -1;
-                            }
-                            chan->enabled = (int) strtol(readbuf, NULL, 10);
-                            // only calculate enable buffer size for trigger buffer extract data
-                            if (chan->enabled) {
-                                dev->datasize += chan->bytes;
-                            }
-                            close(fd);
-                        }
-                        // clean up str var
-                        free(str);
-                    }
-                    else {
-                        close(fd);
-                    }
-                }
-            }
-        }
-        closedir(dir);
+    // the _en files stay open, rescan only when they went away
+    if (dev->cache != NULL && dev->cache->en_fd != NULL && mraa_iio_read_enables(dev) == MRAA_SUCCESS) {
         return MRAA_SUCCESS;
     }
-
-    return MRAA_ERROR_INVALID_HANDLE;
+    return mraa_iio_get_channel_data(dev);
 }
 
 mraa_result_t
 mraa_iio_close(mraa_iio_context dev)
 {
-    free(dev->channels);
+    struct _iio_buffer* buf = dev->buffer;
+
+    if (dev->sources & IIO_SOURCE_EVENT) {
+        mraa_iio_reactor_remove(dev, dev->fp_event, IIO_SOURCE_EVENT);
+    }
+    if (dev->fp_event >= 0) {
+        close(dev->fp_event);
+        dev->fp_event = -1;
+    }
+    if (buf != NULL) {
+        if (dev->sources & IIO_SOURCE_BUFFER) {
+            mraa_iio_reactor_remove(dev, dev->fp, IIO_SOURCE_BUFFER);
+        }
+        if (dev->fp >= 0) {
+            close(dev->fp);
+            dev->fp = -1;
+        }
+        free(buf->data);
+        free(buf->ring);
+        free(buf->stamps);
+        free(buf);
+        dev->buffer = NULL;
+    }
     return MRAA_SUCCESS;
 }
@@ -0,0 +1,585 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "iio.h"
+#include "mraa_internal.h"
+
+#define IIO_SYNC_MAX_STREAMS 8
+#define IIO_SYNC_CHUNK 64
+#define IIO_SYNC_PULL 64
+#define IIO_SYNC_OFFSET_WINDOW 64
+
+/**
+ * Decoded samples of one device, kept as one contiguous array per channel
+ * so resampling runs over plain float arrays. Consumed samples are
+ * dropped from the front with memmove, the arrays never wrap.
+ */
+struct _iio_sync_stream {
+    mraa_iio_context dev;
+    int count;             /**< channels taken from each scan */
+    int* channels;         /**< their scan indexes */
+    int ts_channel;        /**< scan index of in_timestamp or -1 */
+    float* scale;
+    float* offset;
+    unsigned int depth;
+    int n;                 /**< samples held */
+    int64_t* t;
+    float** v;             /**< count arrays of depth samples */
+    float** out;           /**< decode targets, count pointers into v */
+    int64_t last_read;     /**< read time of the previous batch */
+    char* raw;             /**< ring pull scratch, IIO_SYNC_PULL scans */
+    int64_t raw_stamps[IIO_SYNC_PULL];
+    int raw_size;
+    int64_t delay_min;     /**< lowest read time - timestamp in this window */
+    int64_t delay_prev;    /**< the same over the previous window */
+    int delay_batches;
+    mraa_boolean_t has_offset;
+    unsigned long long overruns;
+};
+
+struct _iio_sync {
+    double period_ns;
+    mraa_iio_sync_mode_t mode;
+    mraa_boolean_t correct;  /**< move timestamps onto the host clock */
+    int nstreams;
+    int width;               /**< floats per output tuple */
+    struct _iio_sync_stream streams[IIO_SYNC_MAX_STREAMS];
+    mraa_boolean_t started;
+    int64_t origin;          /**< time of output tuple 0 */
+    int64_t next;            /**< index of the next output tuple */
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse2"))) static int
+mraa_iio_sync_lerp_simd(const float* a, const float* b, const float* w, float* out, int n)
+{
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128 va = _mm_loadu_ps(a + i);
+        __m128 d = _mm_sub_ps(_mm_loadu_ps(b + i), va);
+        _mm_storeu_ps(out + i, _mm_add_ps(va, _mm_mul_ps(_mm_loadu_ps(w + i), d)));
+    }
+    return i;
+}
+
+static int
+mraa_iio_sync_has_simd()
+{
+    static int has_sse2 = -1;
+    if (has_sse2 < 0) {
+        __builtin_cpu_init();
+        has_sse2 = __builtin_cpu_supports("sse2");
+    }
+    return has_sse2;
+}
+#elif defined(__aarch64__)
+static int
+mraa_iio_sync_lerp_simd(const float* a, const float* b, const float* w, float* out, int n)
+{
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        float32x4_t va = vld1q_f32(a + i);
+        float32x4_t d = vsubq_f32(vld1q_f32(b + i), va);
+        vst1q_f32(out + i, vmlaq_f32(va, vld1q_f32(w + i), d));
+    }
+    return i;
+}
+
+static int
+mraa_iio_sync_has_simd()
+{
+    return 1;
+}
+#endif
+
+/* out = a + w (b - a), w is 0 for nearest so a comes through unchanged */
+static void
+mraa_iio_sync_lerp(const float* a, const float* b, const float* w, float* out, int n)
+{
+    int i = 0;
+
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+    if (mraa_iio_sync_has_simd()) {
+        i = mraa_iio_sync_lerp_simd(a, b, w, out, n);
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = a[i] + w[i] * (b[i] - a[i]);
+    }
+}
+
+static struct _iio_sync_stream*
+mraa_iio_sync_stream(mraa_iio_sync_context sync, int stream)
+{
+    if (sync == NULL || stream < 0 || stream >= sync->nstreams) {
+        return NULL;
+    }
+    return &sync->streams[stream];
+}
+
+static void
+mraa_iio_sync_free_stream(struct _iio_sync_stream* st)
+{
+    int c;
+
+    if (st->v != NULL) {
+        for (c = 0; c < st->count; c++) {
+            free(st->v[c]);
+        }
+    }
+    free(st->v);
+    free(st->out);
+    free(st->t);
+    free(st->channels);
+    free(st->scale);
+    free(st->offset);
+    free(st->raw);
+    memset(st, 0, sizeof(*st));
+}
+
+/* Drop the oldest drop samples of a stream */
+static void
+mraa_iio_sync_discard(struct _iio_sync_stream* st, int drop)
+{
+    int c;
+
+    if (drop <= 0) {
+        return;
+    }
+    if (drop > st->n) {
+        drop = st->n;
+    }
+    st->n -= drop;
+    memmove(st->t, st->t + drop, st->n * sizeof(int64_t));
+    for (c = 0; c < st->count; c++) {
+        memmove(st->v[c], st->v[c] + drop, st->n * sizeof(float));
+    }
+}
+
+static void
+mraa_iio_sync_update_offset(struct _iio_sync_stream* st, int64_t delay)
+{
+    if (!st->has_offset) {
+        st->delay_min = st->delay_prev = delay;
+        st->has_offset = 1;
+    } else if (delay < st->delay_min) {
+        st->delay_min = delay;
+    }
+    // restart the window so the estimate follows drift between the clocks
+    if (++st->delay_batches == IIO_SYNC_OFFSET_WINDOW) {
+        st->delay_prev = st->delay_min;
+        st->delay_min = INT64_MAX;
+        st->delay_batches = 0;
+    }
+}
+
+/* Output times come from the tuple index so rounding never accumulates */
+static int64_t
+mraa_iio_sync_time(mraa_iio_sync_context sync, int64_t index)
+{
+    return sync->origin + (int64_t) (index * sync->period_ns + 0.5);
+}
+
+static int64_t
+mraa_iio_sync_offset(const struct _iio_sync_stream* st)
+{
+    return st->delay_min < st->delay_prev ? st->delay_min : st->delay_prev;
+}
+
+mraa_iio_sync_context
+mraa_iio_sync_init(double rate_hz, mraa_iio_sync_mode_t mode)
+{
+    if (!(rate_hz > 0.0) || (mode != MRAA_IIO_SYNC_LINEAR && mode != MRAA_IIO_SYNC_NEAREST)) {
+        syslog(LOG_ERR, "iio: sync_init: invalid rate or mode");
+        return NULL;
+    }
+    mraa_iio_sync_context sync = calloc(1, sizeof(struct _iio_sync));
+    if (sync == NULL) {
+        syslog(LOG_CRIT, "iio: sync_init: Failed to allocate memory for context");
+        return NULL;
+    }
+    sync->period_ns = 1e9 / rate_hz;
+    sync->mode = mode;
+    return sync;
+}
+
+int
+mraa_iio_sync_add_stream(mraa_iio_sync_context sync,
+                         mraa_iio_context dev,
+                         const int* channels,
+                         int count,
+                         int ts_channel,
+                         unsigned int depth)
+{
+    struct _iio_sync_stream* st;
+    int c;
+
+    if (sync == NULL || dev == NULL || channels == NULL || count < 1 || depth < 2) {
+        return -1;
+    }
+    if (sync->started || sync->nstreams == IIO_SYNC_MAX_STREAMS) {
+        syslog(LOG_ERR, "iio: sync_add_stream: streams are fixed once reading started, at most %d",
+               IIO_SYNC_MAX_STREAMS);
+        return -1;
+    }
+    if (ts_channel >= dev->chan_num) {
+        syslog(LOG_ERR, "iio: sync_add_stream: no timestamp channel %d", ts_channel);
+        return -1;
+    }
+    for (c = 0; c < count; c++) {
+        if (channels[c] < 0 || channels[c] >= dev->chan_num) {
+            syslog(LOG_ERR, "iio: sync_add_stream: no channel %d", channels[c]);
+            return -1;
+        }
+    }
+
+    st = &sync->streams[sync->nstreams];
+    st->dev = dev;
+    st->count = count;
+    st->ts_channel = ts_channel;
+    st->depth = depth;
+    st->channels = malloc(count * sizeof(int));
+    st->scale = malloc(count * sizeof(float));
+    st->offset = malloc(count * sizeof(float));
+    st->v = calloc(count, sizeof(float*));
+    st->out = calloc(count, sizeof(float*));
+    st->t = malloc(depth * sizeof(int64_t));
+    if (st->channels == NULL || st->scale == NULL || st->offset == NULL || st->v == NULL ||
+        st->out == NULL || st->t == NULL) {
+        goto nomem;
+    }
+    for (c = 0; c < count; c++) {
+        st->v[c] = malloc(depth * sizeof(float));
+        if (st->v[c] == NULL) {
+            goto nomem;
+        }
+        st->channels[c] = channels[c];
+        // raw counts when the driver has no scale
+        if (mraa_iio_get_channel_scale(dev, channels[c], &st->scale[c], &st->offset[c]) != MRAA_SUCCESS) {
+            st->scale[c] = 1.0f;
+            st->offset[c] = 0.0f;
+        }
+    }
+
+    sync->width += count;
+    return sync->nstreams++;
+
+nomem:
+    syslog(LOG_CRIT, "iio: sync_add_stream: Failed to allocate memory for stream");
+    mraa_iio_sync_free_stream(st);
+    return -1;
+}
+
+mraa_result_t
+mraa_iio_sync_set_scale(mraa_iio_sync_context sync, int stream, const float* scale, const float* offset)
+{
+    struct _iio_sync_stream* st = mraa_iio_sync_stream(sync, stream);
+    int c;
+
+    if (st == NULL) {
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    for (c = 0; c < st->count; c++) {
+        st->scale[c] = scale != NULL ? scale[c] : 1.0f;
+        st->offset[c] = offset != NULL ? offset[c] : 0.0f;
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_iio_sync_set_clock_correction(mraa_iio_sync_context sync, mraa_boolean_t enable)
+{
+    if (sync == NULL) {
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    sync->correct = enable;
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_iio_sync_push(mraa_iio_sync_context sync, int stream, const char* data, int scans, int64_t read_time)
+{
+    struct _iio_sync_stream* st = mraa_iio_sync_stream(sync, stream);
+    float** out;
+    int size, c, i, kept;
+    int64_t last;
+
+    if (st == NULL) {
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (data == NULL || scans < 0) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    if (scans == 0) {
+        return MRAA_SUCCESS;
+    }
+    size = st->dev->datasize;
+    if (size <= 0) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    // more than fits, keep the newest
+    if ((unsigned int) scans > st->depth) {
+        st->overruns += scans - st->depth;
+        data += (size_t) (scans - st->depth) * size;
+        scans = st->depth;
+    }
+    if (st->n + scans > (int) st->depth) {
+        st->overruns += st->n + scans - st->depth;
+        mraa_iio_sync_discard(st, st->n + scans - st->depth);
+    }
+
+    out = st->out;
+    for (c = 0; c < st->count; c++) {
+        out[c] = st->v[c] + st->n;
+    }
+    mraa_result_t ret = mraa_iio_demux_float(st->dev, data, scans, st->channels, st->count, st->scale, st->offset, out);
+    if (ret != MRAA_SUCCESS) {
+        return ret;
+    }
+
+    int64_t* t = st->t + st->n;
+    if (st->ts_channel >= 0) {
+        const mraa_iio_channel* ts = &st->dev->channels[st->ts_channel];
+        for (i = 0; i < scans; i++) {
+            t[i] = mraa_iio_channel_value(data + (size_t) i * size, ts);
+        }
+        mraa_iio_sync_update_offset(st, read_time - t[scans - 1]);
+        if (sync->correct) {
+            int64_t offset = mraa_iio_sync_offset(st);
+            for (i = 0; i < scans; i++) {
+                t[i] += offset;
+            }
+        }
+    } else {
+        // no device timestamps, spread the scans over the time since the last read
+        int64_t from = st->last_read != 0 && st->last_read < read_time ? st->last_read : read_time;
+        for (i = 0; i < scans; i++) {
+            t[i] = from + (read_time - from) * (i + 1) / scans;
+        }
+    }
+    st->last_read = read_time;
+
+    // samples going back in time cannot be interpolated, drop them
+    last = st->n > 0 ? st->t[st->n - 1] : INT64_MIN;
+    for (i = 0, kept = 0; i < scans; i++) {
+        if (t[i] < last) {
+            continue;
+        }
+        last = t[i];
+        if (kept != i) {
+            t[kept] = t[i];
+            for (c = 0; c < st->count; c++) {
+                out[c][kept] = out[c][i];
+            }
+        }
+        kept++;
+    }
+    st->overruns += scans - kept;
+    st->n += kept;
+    return MRAA_SUCCESS;
+}
+
+/* Move what the reader thread put in a device ring into its stream */
+static void
+mraa_iio_sync_pull(mraa_iio_sync_context sync, int stream)
+{
+    struct _iio_sync_stream* st = &sync->streams[stream];
+    int size = st->dev->datasize;
+    int got, i, run;
+
+    if (size <= 0) {
+        return;
+    }
+    if (st->raw == NULL || st->raw_size != size) {
+        free(st->raw);
+        st->raw = malloc((size_t) IIO_SYNC_PULL * size);
+        st->raw_size = st->raw != NULL ? size : 0;
+        if (st->raw == NULL) {
+            return;
+        }
+    }
+    do {
+        got = mraa_iio_ring_read(st->dev, st->raw, st->raw_stamps, IIO_SYNC_PULL);
+        // one push per read batch, they share a read time
+        for (i = 0; i < got; i += run) {
+            for (run = 1; i + run < got && st->raw_stamps[i + run] == st->raw_stamps[i]; run++) {
+            }
+            mraa_iio_sync_push(sync, stream, st->raw + (size_t) i * size, run, st->raw_stamps[i]);
+        }
+    } while (got == IIO_SYNC_PULL);
+}
+
+int
+mraa_iio_sync_read(mraa_iio_sync_context sync, float* values, int64_t* timestamps, int max)
+{
+    int idx[IIO_SYNC_CHUNK];
+    float w[IIO_SYNC_CHUNK];
+    float a[IIO_SYNC_CHUNK];
+    float b[IIO_SYNC_CHUNK];
+    float r[IIO_SYNC_CHUNK];
+    int64_t when[IIO_SYNC_CHUNK];
+    int emitted = 0;
+    int s, c, k, kn;
+
+    if (sync == NULL || values == NULL || max < 0 || sync->nstreams == 0) {
+        return -1;
+    }
+    for (s = 0; s < sync->nstreams; s++) {
+        mraa_iio_sync_pull(sync, s);
+    }
+
+    if (!sync->started) {
+        int64_t first = INT64_MIN;
+        for (s = 0; s < sync->nstreams; s++) {
+            if (sync->streams[s].n == 0) {
+                return 0;
+            }
+            if (sync->streams[s].t[0] > first) {
+                first = sync->streams[s].t[0];
+            }
+        }
+        sync->origin = first;
+        sync->next = 0;
+        sync->started = 1;
+    }
+
+    while (emitted < max) {
+        int64_t lo = INT64_MIN;
+        int64_t hi = INT64_MAX;
+
+        for (s = 0; s < sync->nstreams; s++) {
+            struct _iio_sync_stream* st = &sync->streams[s];
+            if (st->n == 0) {
+                return emitted;
+            }
+            if (st->t[0] > lo) {
+                lo = st->t[0];
+            }
+            if (st->t[st->n - 1] < hi) {
+                hi = st->t[st->n - 1];
+            }
+        }
+        // samples were dropped under the output, skip ahead over the gap
+        while (mraa_iio_sync_time(sync, sync->next) < lo) {
+            int64_t gap = (int64_t) ((lo - mraa_iio_sync_time(sync, sync->next)) / sync->period_ns);
+            sync->next += gap > 0 ? gap : 1;
+        }
+        kn = max - emitted < IIO_SYNC_CHUNK ? max - emitted : IIO_SYNC_CHUNK;
+        for (k = 0; k < kn; k++) {
+            when[k] = mraa_iio_sync_time(sync, sync->next + k);
+            if (when[k] > hi) {
+                break;
+            }
+        }
+        kn = k;
+        if (kn == 0) {
+            break;
+        }
+
+        int col = 0;
+        for (s = 0; s < sync->nstreams; s++) {
+            struct _iio_sync_stream* st = &sync->streams[s];
+            int j = 0;
+
+            // both times and samples ascend, so one pass finds every bracket
+            for (k = 0; k < kn; k++) {
+                while (j + 1 < st->n && st->t[j + 1] <= when[k]) {
+                    j++;
+                }
+                int64_t dt = j + 1 < st->n ? st->t[j + 1] - st->t[j] : 0;
+                float frac = dt > 0 ? (float) ((double) (when[k] - st->t[j]) / dt) : 0.0f;
+                if (sync->mode == MRAA_IIO_SYNC_NEAREST) {
+                    idx[k] = frac >= 0.5f ? j + 1 : j;
+                    w[k] = 0.0f;
+                } else {
+                    idx[k] = j;
+                    w[k] = frac;
+                }
+            }
+            for (c = 0; c < st->count; c++) {
+                const float* v = st->v[c];
+                for (k = 0; k < kn; k++) {
+                    a[k] = v[idx[k]];
+                    b[k] = v[idx[k] + 1 < st->n ? idx[k] + 1 : idx[k]];
+                }
+                mraa_iio_sync_lerp(a, b, w, r, kn);
+                for (k = 0; k < kn; k++) {
+                    values[(size_t) (emitted + k) * sync->width + col + c] = r[k];
+                }
+            }
+            col += st->count;
+            // later outputs only need the bracket of the last one onwards
+            mraa_iio_sync_discard(st, j);
+        }
+        if (timestamps != NULL) {
+            memcpy(timestamps + emitted, when, kn * sizeof(int64_t));
+        }
+        emitted += kn;
+        sync->next += kn;
+    }
+    return emitted;
+}
+
+int
+mraa_iio_sync_width(mraa_iio_sync_context sync)
+{
+    return sync != NULL ? sync->width : -1;
+}
+
+mraa_result_t
+mraa_iio_sync_clock_offset(mraa_iio_sync_context sync, int stream, int64_t* offset_ns)
+{
+    struct _iio_sync_stream* st = mraa_iio_sync_stream(sync, stream);
+
+    if (st == NULL) {
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (offset_ns == NULL) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    if (st->ts_channel < 0) {
+        // stamped with read times, already on the host clock
+        *offset_ns = 0;
+        return MRAA_SUCCESS;
+    }
+    if (!st->has_offset) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    *offset_ns = mraa_iio_sync_offset(st);
+    return MRAA_SUCCESS;
+}
+
+unsigned long long
+mraa_iio_sync_overruns(mraa_iio_sync_context sync, int stream)
+{
+    struct _iio_sync_stream* st = mraa_iio_sync_stream(sync, stream);
+    return st != NULL ? st->overruns : 0;
+}
+
+mraa_result_t
+mraa_iio_sync_close(mraa_iio_sync_context sync)
+{
+    int s;
+
+    if (sync == NULL) {
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    for (s = 0; s < sync->nstreams; s++) {
+        mraa_iio_sync_free_stream(&sync->streams[s]);
+    }
+    free(sync);
+    return MRAA_SUCCESS;
+}
@@ -201,6 +201,30 @@ parse_uart(char** proto, size_t n, const char* proto_full)
         return NULL;
     }
 
+    if (++idx == n) {
+        return dev;
+    }
+
+    /* Check for RS-485 with an optional DE gpio. */
+    if (strncmp(proto[idx], U_RS485, strlen(U_RS485)) != 0 || strlen(proto[idx]) != strlen(U_RS485)) {
+        syslog(LOG_ERR, "parse_uart: invalid uart option '%s' from '%s'", proto[idx], proto_full);
+        mraa_uart_stop(dev);
+        return NULL;
+    }
+
+    int de_pin = -1;
+    if (++idx < n && mraa_atoi_x(proto[idx], NULL, &de_pin, 0) != MRAA_SUCCESS) {
+        syslog(LOG_ERR, "parse_uart: invalid rs485 DE gpio '%s' from '%s'", proto[idx], proto_full);
+        mraa_uart_stop(dev);
+        return NULL;
+    }
+
+    if (mraa_uart_set_rs485(dev, 1, de_pin, 0) != MRAA_SUCCESS) {
+        syslog(LOG_ERR, "parse_uart: error enabling rs485 from '%s'", proto_full);
+        mraa_uart_stop(dev);
+        return NULL;
+    }
+
     return dev;
 }
 
@@ -0,0 +1,390 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "led_strip.h"
+#include "spi.h"
+#include "mraa_internal.h"
+
+// four spi bits per data bit at 3.2MHz gives 312ns/937ns high times
+#define LED_STRIP_SPI_FREQ 3200000
+// latch needs the line low for >280us on current WS2812B parts
+#define LED_STRIP_RESET_BYTES 120
+
+/* Encoded byte for two data bits, 00 -> 1000 1000 ... 11 -> 1110 1110 */
+static const uint8_t led_strip_bit_pairs[4] = { 0x88, 0x8E, 0xE8, 0xEE };
+
+static void
+mraa_led_strip_encode_scalar(uint8_t* out, const uint8_t* in, int len)
+{
+    for (int i = 0; i < len; i++) {
+        uint8_t v = in[i];
+        out[0] = led_strip_bit_pairs[(v >> 6) & 3];
+        out[1] = led_strip_bit_pairs[(v >> 4) & 3];
+        out[2] = led_strip_bit_pairs[(v >> 2) & 3];
+        out[3] = led_strip_bit_pairs[v & 3];
+        out += 4;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("ssse3"))) static void
+mraa_led_strip_encode_ssse3(uint8_t* out, const uint8_t* in, int len)
+{
+    const __m128i pairs = _mm_setr_epi8(0x88, 0x8E, 0xE8, 0xEE, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask = _mm_set1_epi8(0x03);
+
+    int i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*) (in + i));
+        __m128i b0 = _mm_shuffle_epi8(pairs, _mm_and_si128(_mm_srli_epi16(v, 6), mask));
+        __m128i b1 = _mm_shuffle_epi8(pairs, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        __m128i b2 = _mm_shuffle_epi8(pairs, _mm_and_si128(_mm_srli_epi16(v, 2), mask));
+        __m128i b3 = _mm_shuffle_epi8(pairs, _mm_and_si128(v, mask));
+
+        __m128i lo01 = _mm_unpacklo_epi8(b0, b1);
+        __m128i lo23 = _mm_unpacklo_epi8(b2, b3);
+        __m128i hi01 = _mm_unpackhi_epi8(b0, b1);
+        __m128i hi23 = _mm_unpackhi_epi8(b2, b3);
+        _mm_storeu_si128((__m128i*) (out + 0), _mm_unpacklo_epi16(lo01, lo23));
+        _mm_storeu_si128((__m128i*) (out + 16), _mm_unpackhi_epi16(lo01, lo23));
+        _mm_storeu_si128((__m128i*) (out + 32), _mm_unpacklo_epi16(hi01, hi23));
+        _mm_storeu_si128((__m128i*) (out + 48), _mm_unpackhi_epi16(hi01, hi23));
+        out += 64;
+    }
+    mraa_led_strip_encode_scalar(out, in + i, len - i);
+}
+#elif defined(__aarch64__)
+static void
+mraa_led_strip_encode_neon(uint8_t* out, const uint8_t* in, int len)
+{
+    const uint8_t table[16] = { 0x88, 0x8E, 0xE8, 0xEE };
+    const uint8x16_t pairs = vld1q_u8(table);
+    const uint8x16_t mask = vdupq_n_u8(0x03);
+
+    int i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8(in + i);
+        uint8x16x4_t bits;
+        bits.val[0] = vqtbl1q_u8(pairs, vandq_u8(vshrq_n_u8(v, 6), mask));
+        bits.val[1] = vqtbl1q_u8(pairs, vandq_u8(vshrq_n_u8(v, 4), mask));
+        bits.val[2] = vqtbl1q_u8(pairs, vandq_u8(vshrq_n_u8(v, 2), mask));
+        bits.val[3] = vqtbl1q_u8(pairs, vandq_u8(v, mask));
+        vst4q_u8(out, bits);
+        out += 64;
+    }
+    mraa_led_strip_encode_scalar(out, in + i, len - i);
+}
+#endif
+
+static void
+mraa_led_strip_encode(uint8_t* out, const uint8_t* in, int len)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    static int has_ssse3 = -1;
+    if (has_ssse3 < 0) {
+        __builtin_cpu_init();
+        has_ssse3 = __builtin_cpu_supports("ssse3");
+    }
+    if (has_ssse3) {
+        mraa_led_strip_encode_ssse3(out, in, len);
+        return;
+    }
+#elif defined(__aarch64__)
+    mraa_led_strip_encode_neon(out, in, len);
+    return;
+#endif
+    mraa_led_strip_encode_scalar(out, in, len);
+}
+
+static void
+mraa_led_strip_update_levels(mraa_led_strip_context dev)
+{
+    for (int i = 0; i < 256; i++) {
+        float level = powf(i / 255.0f, dev->gamma) * dev->brightness;
+        dev->levels[i] = (uint8_t) (level + 0.5f);
+    }
+}
+
+static void*
+mraa_led_strip_sender(void* arg)
+{
+    mraa_led_strip_context dev = (mraa_led_strip_context) arg;
+
+    for (;;) {
+        pthread_mutex_lock(&dev->lock);
+        while (!dev->pending && !dev->terminating) {
+            pthread_cond_wait(&dev->cond, &dev->lock);
+        }
+        if (!dev->pending) {
+            pthread_mutex_unlock(&dev->lock);
+            return NULL;
+        }
+        uint8_t* frame = dev->frames[1 - dev->back];
+        pthread_mutex_unlock(&dev->lock);
+
+        // init made sure the frame fits one spidev message, a gap between
+        // messages would latch the pixels half way through
+        mraa_result_t ret = mraa_spi_transfer_buf(dev->spi, frame, NULL, dev->frame_size);
+
+        pthread_mutex_lock(&dev->lock);
+        dev->last_result = ret;
+        dev->pending = 0;
+        pthread_cond_broadcast(&dev->cond);
+        pthread_mutex_unlock(&dev->lock);
+    }
+}
+
+static void
+mraa_led_strip_free(mraa_led_strip_context dev)
+{
+    if (dev->spi != NULL) {
+        mraa_spi_stop(dev->spi);
+    }
+    free(dev->pixels);
+    free(dev->scratch);
+    free(dev->frames[0]);
+    free(dev->frames[1]);
+    free(dev);
+}
+
+mraa_led_strip_context
+mraa_led_strip_init(int bus, int count, mraa_led_strip_type_t type)
+{
+    if (count <= 0 || count > (INT_MAX - LED_STRIP_RESET_BYTES) / 16) {
+        syslog(LOG_ERR, "led_strip: invalid LED count %d", count);
+        return NULL;
+    }
+    if (type != MRAA_LED_STRIP_WS2812 && type != MRAA_LED_STRIP_SK6812_RGBW) {
+        syslog(LOG_ERR, "led_strip: unknown strip type %d", type);
+        return NULL;
+    }
+
+    mraa_led_strip_context dev = (mraa_led_strip_context) calloc(1, sizeof(struct _led_strip));
+    if (dev == NULL) {
+        syslog(LOG_CRIT, "led_strip: Failed to allocate memory for context");
+        return NULL;
+    }
+    dev->type = type;
+    dev->count = count;
+    dev->channels = type == MRAA_LED_STRIP_SK6812_RGBW ? 4 : 3;
+    dev->frame_size = count * dev->channels * 4 + LED_STRIP_RESET_BYTES;
+    dev->brightness = 255;
+    dev->gamma = 1.0f;
+    mraa_led_strip_update_levels(dev);
+
+    dev->pixels = calloc(count, dev->channels);
+    dev->scratch = malloc((size_t) count * dev->channels);
+    // the reset tail stays zero, only the pixel part is rewritten
+    dev->frames[0] = calloc(1, dev->frame_size);
+    dev->frames[1] = calloc(1, dev->frame_size);
+    if (dev->pixels == NULL || dev->scratch == NULL || dev->frames[0] == NULL || dev->frames[1] == NULL) {
+        syslog(LOG_CRIT, "led_strip: Failed to allocate memory for frames");
+        mraa_led_strip_free(dev);
+        return NULL;
+    }
+
+    dev->spi = mraa_spi_init(bus);
+    if (dev->spi == NULL) {
+        syslog(LOG_ERR, "led_strip: failed to initialise spi bus %d", bus);
+        mraa_led_strip_free(dev);
+        return NULL;
+    }
+    if (mraa_spi_frequency(dev->spi, LED_STRIP_SPI_FREQ) != MRAA_SUCCESS ||
+        mraa_spi_mode(dev->spi, MRAA_SPI_MODE0) != MRAA_SUCCESS) {
+        syslog(LOG_ERR, "led_strip: failed to configure spi bus %d", bus);
+        mraa_led_strip_free(dev);
+        return NULL;
+    }
+    if (dev->spi->max_xfer > 0 && (unsigned int) dev->frame_size > dev->spi->max_xfer) {
+        syslog(LOG_ERR, "led_strip: %d byte frame exceeds spidev bufsiz %u, load spidev with bufsiz=%d or more",
+               dev->frame_size, dev->spi->max_xfer, dev->frame_size);
+        mraa_led_strip_free(dev);
+        return NULL;
+    }
+
+    pthread_mutex_init(&dev->lock, NULL);
+    pthread_cond_init(&dev->cond, NULL);
+    if (pthread_create(&dev->thread_id, NULL, mraa_led_strip_sender, (void*) dev) != 0) {
+        syslog(LOG_ERR, "led_strip: failed to create sender thread");
+        pthread_mutex_destroy(&dev->lock);
+        pthread_cond_destroy(&dev->cond);
+        mraa_led_strip_free(dev);
+        return NULL;
+    }
+
+    return dev;
+}
+
+mraa_result_t
+mraa_led_strip_set_pixel(mraa_led_strip_context dev, int index, uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "led_strip: set_pixel: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (index < 0 || index >= dev->count) {
+        syslog(LOG_ERR, "led_strip: set_pixel: index %d out of range", index);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    uint8_t* px = dev->pixels + index * dev->channels;
+    px[0] = g;
+    px[1] = r;
+    px[2] = b;
+    if (dev->channels == 4) {
+        px[3] = w;
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_led_strip_fill(mraa_led_strip_context dev, uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "led_strip: fill: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    for (int i = 0; i < dev->count; i++) {
+        mraa_led_strip_set_pixel(dev, i, r, g, b, w);
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_led_strip_set_brightness(mraa_led_strip_context dev, uint8_t brightness)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "led_strip: set_brightness: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    dev->brightness = brightness;
+    mraa_led_strip_update_levels(dev);
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_led_strip_set_gamma(mraa_led_strip_context dev, float gamma)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "led_strip: set_gamma: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (!(gamma > 0.0f)) {
+        syslog(LOG_ERR, "led_strip: set_gamma: gamma must be positive");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    dev->gamma = gamma;
+    mraa_led_strip_update_levels(dev);
+    return MRAA_SUCCESS;
+}
+
+int
+mraa_led_strip_frame_size(mraa_led_strip_context dev)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "led_strip: frame_size: context is invalid");
+        return -1;
+    }
+
+    return dev->frame_size;
+}
+
+mraa_result_t
+mraa_led_strip_render(mraa_led_strip_context dev, uint8_t* buf)
+{
+    if (dev == NULL || buf == NULL) {
+        syslog(LOG_ERR, "led_strip: render: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    int len = dev->count * dev->channels;
+    for (int i = 0; i < len; i++) {
+        dev->scratch[i] = dev->levels[dev->pixels[i]];
+    }
+    mraa_led_strip_encode(buf, dev->scratch, len);
+    memset(buf + len * 4, 0, LED_STRIP_RESET_BYTES);
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_led_strip_show(mraa_led_strip_context dev)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "led_strip: show: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    // the back frame is never touched by the sender, encode while it works
+    mraa_led_strip_render(dev, dev->frames[dev->back]);
+
+    pthread_mutex_lock(&dev->lock);
+    while (dev->pending) {
+        pthread_cond_wait(&dev->cond, &dev->lock);
+    }
+    mraa_result_t ret = dev->last_result;
+    dev->back = 1 - dev->back;
+    dev->pending = 1;
+    pthread_cond_signal(&dev->cond);
+    pthread_mutex_unlock(&dev->lock);
+
+    return ret;
+}
+
+mraa_result_t
+mraa_led_strip_flush(mraa_led_strip_context dev)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "led_strip: flush: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    pthread_mutex_lock(&dev->lock);
+    while (dev->pending) {
+        pthread_cond_wait(&dev->cond, &dev->lock);
+    }
+    mraa_result_t ret = dev->last_result;
+    pthread_mutex_unlock(&dev->lock);
+
+    return ret;
+}
+
+mraa_result_t
+mraa_led_strip_close(mraa_led_strip_context dev)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "led_strip: close: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    pthread_mutex_lock(&dev->lock);
+    dev->terminating = 1;
+    pthread_cond_signal(&dev->cond);
+    pthread_mutex_unlock(&dev->lock);
+
+    mraa_result_t ret = MRAA_SUCCESS;
+    if (pthread_join(dev->thread_id, NULL) != 0) {
+        ret = MRAA_ERROR_INVALID_RESOURCE;
+    }
+    pthread_mutex_destroy(&dev->lock);
+    pthread_cond_destroy(&dev->cond);
+
+    mraa_led_strip_free(dev);
+    return ret;
+}
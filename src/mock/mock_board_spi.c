@@ -27,6 +27,7 @@ mraa_result_t
 mraa_mock_spi_init_raw_replace(mraa_spi_context dev, unsigned int bus, unsigned int cs)
 {
     dev->clock = MOCK_SPI_DEFAULT_FREQ;
+    dev->max_xfer = MOCK_SPI_BUFSIZ;
 
     if ((mraa_spi_mode(dev, MOCK_SPI_DEFAULT_MODE) != MRAA_SUCCESS) ||
         (mraa_spi_lsbmode(dev, MOCK_SPI_DEFAULT_LSBMODE) != MRAA_SUCCESS) ||
@@ -0,0 +1,665 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "crc.h"
+#include "modbus.h"
+#include "mraa_internal.h"
+
+#define NSEC_PER_SEC 1000000000LL
+#define NSEC_PER_USEC 1000LL
+
+#define MODBUS_MAX_ADU 256
+#define MODBUS_MAX_PDU 253
+#define MODBUS_MAX_READ_REGS 125
+#define MODBUS_MAX_WRITE_REGS 123
+#define MODBUS_DEFAULT_TIMEOUT_MS 200
+// bits per character on the wire: start, 8 data, parity or second stop, stop
+#define MODBUS_CHAR_BITS 11
+
+struct _modbus_poll {
+    uint8_t slave;
+    uint8_t function;
+    uint16_t address;
+    int count;
+    long long period_ns;
+    long long next_due;
+    mraa_modbus_poll_cb cb;
+    void* args;
+};
+
+struct _modbus_slave_stats {
+    mraa_modbus_stats_t pub;
+    unsigned long long latency_sum_us;
+};
+
+struct _modbus {
+    mraa_uart_context uart;
+    long long char_ns;    /**< time to send one character */
+    long long t35_ns;     /**< minimum silence between frames */
+    long long timeout_ns; /**< wait for the first response byte */
+    long long idle_at;    /**< bus is free for the next request from here */
+    int last_exception;
+    pthread_mutex_t bus;  /**< serialises transactions */
+
+    struct _modbus_poll* polls;
+    int poll_count;
+    pthread_t poll_thread;
+    int polling;
+    pthread_mutex_t poll_lock;
+    pthread_cond_t poll_cond;
+    int terminating;
+
+    struct _modbus_slave_stats stats[MRAA_MODBUS_MAX_SLAVE + 1];
+};
+
+/* CRC-16/MODBUS */
+static uint16_t
+mraa_modbus_crc16(const uint8_t* buf, int len)
+{
+    return mraa_crc16_ibm(buf, len, 0xFFFF);
+}
+
+static long long
+mraa_modbus_now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static void
+mraa_modbus_sleep_until(long long when)
+{
+    struct timespec ts;
+    ts.tv_sec = when / NSEC_PER_SEC;
+    ts.tv_nsec = when % NSEC_PER_SEC;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+/* Wait until the uart is readable or deadline passes, returns 1 if readable */
+static int
+mraa_modbus_wait_readable(mraa_modbus_context dev, long long deadline)
+{
+    long long left = deadline - mraa_modbus_now();
+    if (left < 0) {
+        left = 0;
+    }
+
+    if (dev->uart->fd < 0) {
+        // ports run by platform hooks only offer millisecond waits
+        return mraa_uart_data_available(dev->uart, (unsigned int) ((left + 999999) / 1000000));
+    }
+
+    struct pollfd pfd;
+    pfd.fd = dev->uart->fd;
+    pfd.events = POLLIN;
+    struct timespec ts;
+    ts.tv_sec = left / NSEC_PER_SEC;
+    ts.tv_nsec = left % NSEC_PER_SEC;
+    int ret = ppoll(&pfd, 1, &ts, NULL);
+    return ret > 0 && (pfd.revents & POLLIN);
+}
+
+/* Full ADU length once enough of the header is in, -1 when not known yet */
+static int
+mraa_modbus_expected_length(const uint8_t* adu, int n)
+{
+    if (n < 2) {
+        return -1;
+    }
+    uint8_t function = adu[1];
+    if (function & 0x80) {
+        return 5;
+    }
+    switch (function) {
+        case 0x01:
+        case 0x02:
+        case 0x03:
+        case 0x04:
+        case 0x17:
+            return n < 3 ? -1 : 3 + adu[2] + 2;
+        case 0x05:
+        case 0x06:
+        case 0x0F:
+        case 0x10:
+            return 8;
+        default:
+            return -1;
+    }
+}
+
+mraa_result_t
+mraa_modbus_update_timing(mraa_modbus_context dev)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "modbus: update_timing: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    unsigned int baud = 0;
+    if (mraa_uart_get_baudrate(dev->uart, &baud) != MRAA_SUCCESS || baud == 0) {
+        syslog(LOG_ERR, "modbus: update_timing: cannot read uart baudrate");
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    dev->char_ns = MODBUS_CHAR_BITS * NSEC_PER_SEC / baud;
+    // the spec fixes the gap above 19200 baud instead of letting it shrink
+    dev->t35_ns = baud > 19200 ? 1750 * NSEC_PER_USEC : dev->char_ns * 7 / 2;
+    return MRAA_SUCCESS;
+}
+
+mraa_modbus_context
+mraa_modbus_init(mraa_uart_context uart)
+{
+    if (uart == NULL) {
+        syslog(LOG_ERR, "modbus: init: uart context is NULL");
+        return NULL;
+    }
+
+    mraa_modbus_context dev = calloc(1, sizeof(struct _modbus));
+    if (dev == NULL) {
+        syslog(LOG_CRIT, "modbus: init: Failed to allocate memory for context");
+        return NULL;
+    }
+    dev->uart = uart;
+    dev->timeout_ns = MODBUS_DEFAULT_TIMEOUT_MS * 1000000LL;
+    if (mraa_modbus_update_timing(dev) != MRAA_SUCCESS) {
+        free(dev);
+        return NULL;
+    }
+
+    pthread_mutex_init(&dev->bus, NULL);
+    pthread_mutex_init(&dev->poll_lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&dev->poll_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    return dev;
+}
+
+mraa_result_t
+mraa_modbus_set_timeout(mraa_modbus_context dev, unsigned int timeout_ms)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "modbus: set_timeout: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (timeout_ms == 0) {
+        syslog(LOG_ERR, "modbus: set_timeout: timeout cannot be zero");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    dev->timeout_ns = timeout_ms * 1000000LL;
+    return MRAA_SUCCESS;
+}
+
+static void
+mraa_modbus_record(mraa_modbus_context dev, uint8_t slave, mraa_result_t result, long long latency_ns)
+{
+    struct _modbus_slave_stats* st = &dev->stats[slave];
+
+    switch (result) {
+        case MRAA_SUCCESS:
+        case MRAA_ERROR_MODBUS_EXCEPTION: {
+            unsigned int us = (unsigned int) (latency_ns / NSEC_PER_USEC);
+            if (result == MRAA_SUCCESS) {
+                st->pub.responses++;
+            } else {
+                st->pub.exceptions++;
+            }
+            if (st->pub.responses + st->pub.exceptions == 1 || us < st->pub.min_latency_us) {
+                st->pub.min_latency_us = us;
+            }
+            if (us > st->pub.max_latency_us) {
+                st->pub.max_latency_us = us;
+            }
+            st->latency_sum_us += us;
+            st->pub.mean_latency_us =
+            (unsigned int) (st->latency_sum_us / (st->pub.responses + st->pub.exceptions));
+            break;
+        }
+        case MRAA_ERROR_NO_DATA_AVAILABLE:
+            st->pub.timeouts++;
+            break;
+        case MRAA_ERROR_MODBUS_FRAME:
+            st->pub.crc_errors++;
+            break;
+        default:
+            break;
+    }
+}
+
+/* One request/response exchange with the bus lock held, returns the response ADU length */
+static mraa_result_t
+mraa_modbus_exchange(mraa_modbus_context dev, uint8_t slave, const uint8_t* pdu, int length, uint8_t* adu, int* adu_len)
+{
+    uint8_t req[MODBUS_MAX_ADU];
+    req[0] = slave;
+    memcpy(req + 1, pdu, length);
+    uint16_t crc = mraa_modbus_crc16(req, length + 1);
+    req[length + 1] = crc & 0xFF;
+    req[length + 2] = crc >> 8;
+    int req_len = length + 3;
+
+    // honour the inter-frame gap after whatever was last on the bus
+    if (mraa_modbus_now() < dev->idle_at) {
+        mraa_modbus_sleep_until(dev->idle_at);
+    }
+    if (dev->uart->fd >= 0) {
+        tcflush(dev->uart->fd, TCIFLUSH);
+    }
+
+    long long start = mraa_modbus_now();
+    int sent = 0;
+    while (sent < req_len) {
+        int n = mraa_uart_write(dev->uart, (const char*) req + sent, req_len - sent);
+        if (n <= 0) {
+            syslog(LOG_ERR, "modbus: slave %d: write failed", slave);
+            return MRAA_ERROR_INVALID_RESOURCE;
+        }
+        sent += n;
+    }
+    mraa_uart_write_flush(dev->uart);
+    dev->stats[slave].pub.requests++;
+    // the last character is on the wire once this much time has passed
+    long long tx_done = start + req_len * dev->char_ns;
+
+    if (slave == 0) {
+        dev->idle_at = tx_done + dev->t35_ns;
+        *adu_len = 0;
+        return MRAA_SUCCESS;
+    }
+
+    int n = 0;
+    int expected = -1;
+    long long deadline = tx_done + dev->timeout_ns;
+    while (expected < 0 || n < expected) {
+        if (!mraa_modbus_wait_readable(dev, deadline)) {
+            break;
+        }
+        int want = (expected > 0 ? expected : MODBUS_MAX_ADU) - n;
+        int got = mraa_uart_read(dev->uart, (char*) adu + n, want);
+        if (got <= 0) {
+            break;
+        }
+        n += got;
+        expected = mraa_modbus_expected_length(adu, n);
+        if (expected > MODBUS_MAX_ADU) {
+            break;
+        }
+        if (expected > 0) {
+            // adapters deliver in bursts, give the rest its time on the wire
+            deadline = mraa_modbus_now() + (long long) (expected - n) * dev->char_ns + dev->timeout_ns;
+        } else {
+            // length unknown, a silence of 3.5 characters ends the frame
+            deadline = mraa_modbus_now() + dev->t35_ns;
+        }
+    }
+
+    long long end = mraa_modbus_now();
+    dev->idle_at = end + dev->t35_ns;
+    *adu_len = n;
+
+    if (n == 0) {
+        return MRAA_ERROR_NO_DATA_AVAILABLE;
+    }
+    if (n < 5 || (expected > 0 && n != expected) || adu[0] != slave ||
+        mraa_modbus_crc16(adu, n) != 0) {
+        syslog(LOG_NOTICE, "modbus: slave %d: corrupt response of %d bytes", slave, n);
+        return MRAA_ERROR_MODBUS_FRAME;
+    }
+    if ((adu[1] & 0x7F) != pdu[0]) {
+        return MRAA_ERROR_MODBUS_FRAME;
+    }
+    mraa_modbus_record(dev, slave, adu[1] & 0x80 ? MRAA_ERROR_MODBUS_EXCEPTION : MRAA_SUCCESS, end - start);
+    return MRAA_SUCCESS;
+}
+
+static mraa_result_t
+mraa_modbus_request(mraa_modbus_context dev, uint8_t slave, const uint8_t* pdu, int length, uint8_t* response, int* response_len)
+{
+    uint8_t adu[MODBUS_MAX_ADU];
+    int adu_len = 0;
+
+    pthread_mutex_lock(&dev->bus);
+    mraa_result_t ret = mraa_modbus_exchange(dev, slave, pdu, length, adu, &adu_len);
+    if (ret != MRAA_SUCCESS) {
+        mraa_modbus_record(dev, slave, ret, 0);
+    }
+    // set under the bus lock so a poll request can't overwrite it in between
+    __atomic_store_n(&dev->last_exception, ret == MRAA_SUCCESS && adu_len > 0 && (adu[1] & 0x80) ? adu[2] : 0,
+                     __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&dev->bus);
+
+    if (ret != MRAA_SUCCESS || adu_len == 0) {
+        *response_len = 0;
+        return ret;
+    }
+
+    // strip address and CRC
+    *response_len = adu_len - 3;
+    memcpy(response, adu + 1, *response_len);
+    if (response[0] & 0x80) {
+        return MRAA_ERROR_MODBUS_EXCEPTION;
+    }
+    return MRAA_SUCCESS;
+}
+
+int
+mraa_modbus_transact(mraa_modbus_context dev, uint8_t slave, const uint8_t* request, int length, uint8_t* response, int max_length)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "modbus: transact: context is NULL");
+        return -1;
+    }
+    if (request == NULL || length < 1 || length > MODBUS_MAX_PDU || slave > MRAA_MODBUS_MAX_SLAVE ||
+        (slave != 0 && response == NULL)) {
+        syslog(LOG_ERR, "modbus: transact: invalid parameters");
+        return -1;
+    }
+
+    uint8_t pdu[MODBUS_MAX_ADU];
+    int pdu_len = 0;
+    mraa_result_t ret = mraa_modbus_request(dev, slave, request, length, pdu, &pdu_len);
+    if (ret != MRAA_SUCCESS && ret != MRAA_ERROR_MODBUS_EXCEPTION) {
+        return -1;
+    }
+    if (pdu_len > max_length) {
+        syslog(LOG_ERR, "modbus: transact: response of %d bytes does not fit", pdu_len);
+        return -1;
+    }
+    if (pdu_len > 0) {
+        memcpy(response, pdu, pdu_len);
+    }
+    return pdu_len;
+}
+
+static mraa_result_t
+mraa_modbus_read_registers(mraa_modbus_context dev, uint8_t function, uint8_t slave, uint16_t address, int count, uint16_t* values)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "modbus: read_registers: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (values == NULL || count < 1 || count > MODBUS_MAX_READ_REGS || slave == 0 || slave > MRAA_MODBUS_MAX_SLAVE) {
+        syslog(LOG_ERR, "modbus: read_registers: invalid parameters");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    uint8_t pdu[5] = { function, address >> 8, address & 0xFF, count >> 8, count & 0xFF };
+    uint8_t resp[MODBUS_MAX_ADU];
+    int len = 0;
+    mraa_result_t ret = mraa_modbus_request(dev, slave, pdu, sizeof(pdu), resp, &len);
+    if (ret != MRAA_SUCCESS) {
+        return ret;
+    }
+    if (len != 2 + count * 2 || resp[1] != count * 2) {
+        syslog(LOG_NOTICE, "modbus: slave %d: unexpected register count in response", slave);
+        return MRAA_ERROR_MODBUS_FRAME;
+    }
+    for (int i = 0; i < count; i++) {
+        values[i] = (uint16_t) (resp[2 + 2 * i] << 8 | resp[3 + 2 * i]);
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_modbus_read_holding_registers(mraa_modbus_context dev, uint8_t slave, uint16_t address, int count, uint16_t* values)
+{
+    return mraa_modbus_read_registers(dev, 0x03, slave, address, count, values);
+}
+
+mraa_result_t
+mraa_modbus_read_input_registers(mraa_modbus_context dev, uint8_t slave, uint16_t address, int count, uint16_t* values)
+{
+    return mraa_modbus_read_registers(dev, 0x04, slave, address, count, values);
+}
+
+mraa_result_t
+mraa_modbus_write_register(mraa_modbus_context dev, uint8_t slave, uint16_t address, uint16_t value)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "modbus: write_register: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (slave > MRAA_MODBUS_MAX_SLAVE) {
+        syslog(LOG_ERR, "modbus: write_register: invalid slave %d", slave);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    uint8_t pdu[5] = { 0x06, address >> 8, address & 0xFF, value >> 8, value & 0xFF };
+    uint8_t resp[MODBUS_MAX_ADU];
+    int len = 0;
+    mraa_result_t ret = mraa_modbus_request(dev, slave, pdu, sizeof(pdu), resp, &len);
+    if (ret != MRAA_SUCCESS || slave == 0) {
+        return ret;
+    }
+    // the reply echoes the request
+    if (len != sizeof(pdu) || memcmp(resp, pdu, sizeof(pdu)) != 0) {
+        return MRAA_ERROR_MODBUS_FRAME;
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_modbus_write_registers(mraa_modbus_context dev, uint8_t slave, uint16_t address, int count, const uint16_t* values)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "modbus: write_registers: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (values == NULL || count < 1 || count > MODBUS_MAX_WRITE_REGS || slave > MRAA_MODBUS_MAX_SLAVE) {
+        syslog(LOG_ERR, "modbus: write_registers: invalid parameters");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    uint8_t pdu[MODBUS_MAX_PDU];
+    pdu[0] = 0x10;
+    pdu[1] = address >> 8;
+    pdu[2] = address & 0xFF;
+    pdu[3] = count >> 8;
+    pdu[4] = count & 0xFF;
+    pdu[5] = count * 2;
+    for (int i = 0; i < count; i++) {
+        pdu[6 + 2 * i] = values[i] >> 8;
+        pdu[7 + 2 * i] = values[i] & 0xFF;
+    }
+
+    uint8_t resp[MODBUS_MAX_ADU];
+    int len = 0;
+    mraa_result_t ret = mraa_modbus_request(dev, slave, pdu, 6 + count * 2, resp, &len);
+    if (ret != MRAA_SUCCESS || slave == 0) {
+        return ret;
+    }
+    if (len != 5 || memcmp(resp, pdu, 5) != 0) {
+        return MRAA_ERROR_MODBUS_FRAME;
+    }
+    return MRAA_SUCCESS;
+}
+
+int
+mraa_modbus_last_exception(mraa_modbus_context dev)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "modbus: last_exception: context is NULL");
+        return -1;
+    }
+    return __atomic_load_n(&dev->last_exception, __ATOMIC_RELAXED);
+}
+
+mraa_result_t
+mraa_modbus_get_stats(mraa_modbus_context dev, uint8_t slave, mraa_modbus_stats_t* stats)
+{
+    if (dev == NULL || stats == NULL) {
+        syslog(LOG_ERR, "modbus: get_stats: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (slave > MRAA_MODBUS_MAX_SLAVE) {
+        syslog(LOG_ERR, "modbus: get_stats: invalid slave %d", slave);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&dev->bus);
+    *stats = dev->stats[slave].pub;
+    pthread_mutex_unlock(&dev->bus);
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_modbus_poll_add(mraa_modbus_context dev, uint8_t slave, uint8_t function, uint16_t address, int count, unsigned int period_ms, mraa_modbus_poll_cb cb, void* args)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "modbus: poll_add: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (dev->polling) {
+        syslog(LOG_ERR, "modbus: poll_add: poll thread is running");
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    if ((function != 0x03 && function != 0x04) || count < 1 || count > MODBUS_MAX_READ_REGS ||
+        slave == 0 || slave > MRAA_MODBUS_MAX_SLAVE || cb == NULL) {
+        syslog(LOG_ERR, "modbus: poll_add: invalid parameters");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    struct _modbus_poll* polls = realloc(dev->polls, (dev->poll_count + 1) * sizeof(struct _modbus_poll));
+    if (polls == NULL) {
+        syslog(LOG_CRIT, "modbus: poll_add: Failed to allocate memory for poll");
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    dev->polls = polls;
+
+    struct _modbus_poll* p = &dev->polls[dev->poll_count++];
+    memset(p, 0, sizeof(*p));
+    p->slave = slave;
+    p->function = function;
+    p->address = address;
+    p->count = count;
+    p->period_ns = period_ms * 1000000LL;
+    p->cb = cb;
+    p->args = args;
+    return MRAA_SUCCESS;
+}
+
+static void*
+mraa_modbus_poll_handler(void* arg)
+{
+    mraa_modbus_context dev = (mraa_modbus_context) arg;
+    uint16_t values[MODBUS_MAX_READ_REGS];
+
+    pthread_mutex_lock(&dev->poll_lock);
+    while (!dev->terminating) {
+        // earliest deadline first, ties go to the entry added first
+        struct _modbus_poll* next = &dev->polls[0];
+        for (int i = 1; i < dev->poll_count; i++) {
+            if (dev->polls[i].next_due < next->next_due) {
+                next = &dev->polls[i];
+            }
+        }
+
+        if (next->next_due > mraa_modbus_now()) {
+            struct timespec ts;
+            ts.tv_sec = next->next_due / NSEC_PER_SEC;
+            ts.tv_nsec = next->next_due % NSEC_PER_SEC;
+            pthread_cond_timedwait(&dev->poll_cond, &dev->poll_lock, &ts);
+            continue;
+        }
+        pthread_mutex_unlock(&dev->poll_lock);
+
+        mraa_result_t ret =
+        mraa_modbus_read_registers(dev, next->function, next->slave, next->address, next->count, values);
+        next->cb(next->slave, next->function, next->address, values, ret == MRAA_SUCCESS ? next->count : 0,
+                 ret, next->args);
+
+        // slots missed while the bus was busy are skipped, not bunched up
+        long long now = mraa_modbus_now();
+        next->next_due += next->period_ns;
+        if (next->next_due < now) {
+            next->next_due = now;
+        }
+        pthread_mutex_lock(&dev->poll_lock);
+    }
+    pthread_mutex_unlock(&dev->poll_lock);
+
+    return NULL;
+}
+
+mraa_result_t
+mraa_modbus_poll_start(mraa_modbus_context dev)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "modbus: poll_start: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (dev->polling || dev->poll_count == 0) {
+        syslog(LOG_ERR, "modbus: poll_start: already running or nothing to poll");
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    long long now = mraa_modbus_now();
+    for (int i = 0; i < dev->poll_count; i++) {
+        dev->polls[i].next_due = now;
+    }
+    dev->terminating = 0;
+    if (pthread_create(&dev->poll_thread, NULL, mraa_modbus_poll_handler, (void*) dev) != 0) {
+        syslog(LOG_ERR, "modbus: poll_start: failed to create thread");
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    dev->polling = 1;
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_modbus_poll_stop(mraa_modbus_context dev)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "modbus: poll_stop: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (!dev->polling) {
+        return MRAA_SUCCESS;
+    }
+
+    pthread_mutex_lock(&dev->poll_lock);
+    dev->terminating = 1;
+    pthread_cond_signal(&dev->poll_cond);
+    pthread_mutex_unlock(&dev->poll_lock);
+
+    dev->polling = 0;
+    if (pthread_join(dev->poll_thread, NULL) != 0) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_modbus_close(mraa_modbus_context dev)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "modbus: close: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    mraa_result_t ret = mraa_modbus_poll_stop(dev);
+    pthread_mutex_destroy(&dev->bus);
+    pthread_mutex_destroy(&dev->poll_lock);
+    pthread_cond_destroy(&dev->poll_cond);
+    free(dev->polls);
+    free(dev);
+    return ret;
+}
@@ -52,12 +52,12 @@
 #if defined(PERIPHERALMAN)
 #include "peripheralmanager/peripheralman.h"
 #else
-#define IIO_DEVICE_WILDCARD "iio:device*"
+#define IIO_DEVICE "iio:device"
 
 mraa_iio_info_t* plat_iio = NULL;
 
 static int num_i2c_devices = 0;
-static int num_iio_devices = 0;
+static pthread_mutex_t iio_detect_lock = PTHREAD_MUTEX_INITIALIZER;
 #endif
 
 mraa_board_t* plat = NULL;
@@ -206,9 +206,6 @@ imraa_init()
 #endif
 
 #if !defined(PERIPHERALMAN)
-    // Look for IIO devices
-    mraa_iio_detect();
-
     if (plat != NULL) {
         int length = strlen(plat->platform_name) + 1;
         if (mraa_has_sub_platform()) {
@@ -309,6 +306,14 @@ mraa_deinit()
     }
 #if !defined(PERIPHERALMAN)
     if (plat_iio != NULL) {
+        int i;
+        for (i = 0; i < plat_iio->iio_device_count; i++) {
+            mraa_iio_close(&plat_iio->iio_devices[i]);
+            mraa_iio_invalidate(&plat_iio->iio_devices[i]);
+            free(plat_iio->iio_devices[i].name);
+        }
+        mraa_iio_reactor_stop();
+        free(plat_iio->iio_devices);
         free(plat_iio);
         plat_iio = NULL;
     }
@@ -334,52 +339,71 @@ mraa_set_priority(const int priority)
 }
 
 #if !defined(PERIPHERALMAN)
-static int
-mraa_count_iio_devices(const char* path, const struct stat* sb, int flag, struct FTW* ftwb)
-{
-    // we are only interested in files with specific names
-    if (fnmatch(IIO_DEVICE_WILDCARD, basename(path), 0) == 0) {
-        num_iio_devices++;
-    }
-    return 0;
-}
-
 mraa_result_t
 mraa_iio_detect()
 {
-    plat_iio = (mraa_iio_info_t*) calloc(1, sizeof(mraa_iio_info_t));
-    plat_iio->iio_device_count = num_iio_devices;
-    // Now detect IIO devices, linux only
-    // find how many iio devices we have if we haven't already
-    if (num_iio_devices == 0) {
-        if (nftw("/sys/bus/iio/devices", &mraa_count_iio_devices, 20, FTW_PHYS) == -1) {
-            return MRAA_ERROR_UNSPECIFIED;
+    const struct dirent* ent;
+    mraa_iio_info_t* info;
+    mraa_result_t ret = MRAA_SUCCESS;
+    char name[64], filepath[64];
+    int fd, len, num, i;
+    int count = 0;
+    DIR* dir;
+
+    pthread_mutex_lock(&iio_detect_lock);
+    if (plat_iio != NULL) {
+        pthread_mutex_unlock(&iio_detect_lock);
+        return MRAA_SUCCESS;
+    }
+    info = (mraa_iio_info_t*) calloc(1, sizeof(mraa_iio_info_t));
+    if (info == NULL) {
+        pthread_mutex_unlock(&iio_detect_lock);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    // Now detect IIO devices, linux only. Numbers have gaps when a driver
+    // was unbound, so size by the largest one
+    dir = opendir("/sys/bus/iio/devices");
+    if (dir != NULL) {
+        while ((ent = readdir(dir)) != NULL) {
+            if (sscanf(ent->d_name, IIO_DEVICE "%d", &num) == 1 && num >= count) {
+                count = num + 1;
+            }
         }
+        closedir(dir);
+    } else {
+        ret = MRAA_ERROR_UNSPECIFIED;
     }
-    char name[64], filepath[64];
-    int fd, len, i;
-    plat_iio->iio_device_count = num_iio_devices;
-    plat_iio->iio_devices = calloc(num_iio_devices, sizeof(struct _iio));
+    if (count > 0) {
+        info->iio_devices = calloc(count, sizeof(struct _iio));
+        if (info->iio_devices == NULL) {
+            free(info);
+            pthread_mutex_unlock(&iio_detect_lock);
+            return MRAA_ERROR_NO_RESOURCES;
+        }
+    }
+    info->iio_device_count = count;
     struct _iio* device;
-    for (i = 0; i < num_iio_devices; i++) {
-        device = &plat_iio->iio_devices[i];
+    for (i = 0; i < count; i++) {
+        device = &info->iio_devices[i];
         device->num = i;
-        snprintf(filepath, 64, "/sys/bus/iio/devices/iio:device%d/name", i);
+        device->fp = -1;
+        device->fp_event = -1;
+        snprintf(filepath, 64, "/sys/bus/iio/devices/" IIO_DEVICE "%d/name", i);
         fd = open(filepath, O_RDONLY);
         if (fd != -1) {
-            len = read(fd, &name, 64);
+            len = read(fd, &name, sizeof(name) - 1);
             if (len > 1) {
                 // remove any trailing CR/LF symbols
+                name[len] = '\0';
                 name[strcspn(name, "\r\n")] = '\0';
-                len = strlen(name);
-                // use strndup
-                device->name = malloc((sizeof(char) * len) + sizeof(char));
-                strncpy(device->name, name, len + 1);
+                device->name = strdup(name);
             }
             close(fd);
         }
     }
-    return MRAA_SUCCESS;
+    plat_iio = info;
+    pthread_mutex_unlock(&iio_detect_lock);
+    return ret;
 }
 
 mraa_result_t
@@ -613,6 +637,12 @@ mraa_result_print(mraa_result_t result)
         case MRAA_ERROR_UART_OW_DATA_ERROR:
             fprintf(stdout, "MRAA: UART OW: Data or Bus error detected.\n");
             break;
+        case MRAA_ERROR_MODBUS_FRAME:
+            fprintf(stdout, "MRAA: Modbus: Bad CRC or framing in response.\n");
+            break;
+        case MRAA_ERROR_MODBUS_EXCEPTION:
+            fprintf(stdout, "MRAA: Modbus: Exception response.\n");
+            break;
         case MRAA_ERROR_UNSPECIFIED:
             fprintf(stdout, "MRAA: Unspecified Error.\n");
             break;
@@ -1332,7 +1362,8 @@ mraa_get_iio_device_count()
 #if defined(PERIPHERALMAN)
     return -1;
 #else
-    return plat_iio->iio_device_count;
+    mraa_iio_detect();
+    return plat_iio != NULL ? plat_iio->iio_device_count : 0;
 #endif
 }
 
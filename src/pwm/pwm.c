@@ -13,11 +13,163 @@
 #include <errno.h>
 #include <string.h>
 
+#if defined(__has_include)
+#if __has_include(<linux/pwm.h>)
+#include <linux/pwm.h>
+#include <sys/ioctl.h>
+#endif
+#endif
+
 #include "pwm.h"
 #include "mraa_internal.h"
 
 #define MAX_SIZE 64
 #define SYSFS_PWM "/sys/class/pwm"
+#define DEV_PWMCHIP "/dev/pwmchip"
+
+/* Linux 6.13 and later, waveforms set with one ioctl on /dev/pwmchipN */
+#if defined(PWM_IOCTL_SETROUNDWF)
+#define PWM_HAVE_CHARDEV 1
+#endif
+
+/**
+ * Files kept open for the life of the context and the last settings
+ * written, so writes are a single pwrite and reads only go to sysfs for
+ * values this context has not written itself
+ */
+struct _pwm_state {
+    int period_fp;
+    int enable_fp;
+    int duty;       /**< duty_cycle in ns, -1 until known */
+    int enabled;    /**< -1 until known */
+    int chardev;    /**< /dev/pwmchipN holding the pwm, -1 when sysfs is used */
+    int period_set; /**< dev->period was written through this context */
+    int duty_set;   /**< duty was written through this context */
+};
+
+static struct _pwm_state*
+mraa_pwm_state(mraa_pwm_context dev)
+{
+    if (dev->state == NULL) {
+        dev->state = malloc(sizeof(struct _pwm_state));
+        if (dev->state == NULL) {
+            syslog(LOG_CRIT, "pwm%i: Failed to allocate memory for state", dev->pin);
+            return NULL;
+        }
+        dev->state->period_fp = -1;
+        dev->state->enable_fp = -1;
+        dev->state->duty = -1;
+        dev->state->enabled = -1;
+        dev->state->chardev = -1;
+        dev->state->period_set = 0;
+        dev->state->duty_set = 0;
+    }
+    return dev->state;
+}
+
+/* Open pwmchipN/pwmM/<name> on first use */
+static int
+mraa_pwm_sysfs_fd(mraa_pwm_context dev, int* fd, const char* name)
+{
+    if (*fd == -1) {
+        char bu[MAX_SIZE];
+        snprintf(bu, MAX_SIZE, SYSFS_PWM "/pwmchip%d/pwm%d/%s", dev->chipid, dev->pin, name);
+        *fd = open(bu, O_RDWR);
+    }
+    return *fd;
+}
+
+static mraa_result_t
+mraa_pwm_sysfs_write(int fd, int value)
+{
+    char out[MAX_SIZE];
+    int length = snprintf(out, MAX_SIZE, "%d", value);
+    if (pwrite(fd, out, length * sizeof(char), 0) != length) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    return MRAA_SUCCESS;
+}
+
+static mraa_result_t
+mraa_pwm_sysfs_read(int fd, int* value)
+{
+    char output[MAX_SIZE];
+    ssize_t rb = pread(fd, output, MAX_SIZE - 1, 0);
+    if (rb <= 0) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    output[rb] = '\0';
+
+    char* endptr;
+    long int ret = strtol(output, &endptr, 10);
+    if (('\0' != *endptr && '\n' != *endptr) || ret > INT_MAX || ret < INT_MIN) {
+        return MRAA_ERROR_UNSPECIFIED;
+    }
+    *value = (int) ret;
+    return MRAA_SUCCESS;
+}
+
+#if defined(PWM_HAVE_CHARDEV)
+/* A disabled output is a zero period on the character device */
+static mraa_result_t
+mraa_pwm_chardev_apply(mraa_pwm_context dev, int period, int duty, int enabled)
+{
+    struct pwmchip_waveform wf;
+
+    if (enabled > 0 && period > 0 && duty > period) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    memset(&wf, 0, sizeof(wf));
+    wf.hwpwm = dev->pin;
+    if (enabled > 0 && period > 0) {
+        wf.period_length_ns = period;
+        wf.duty_length_ns = duty > 0 ? duty : 0;
+    }
+    if (ioctl(dev->state->chardev, PWM_IOCTL_SETROUNDWF, &wf) < 0) {
+        syslog(LOG_ERR, "pwm%i: Failed to set waveform: %s", dev->pin, strerror(errno));
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    return MRAA_SUCCESS;
+}
+
+/* Take the pwm through /dev/pwmchipN, fails when it is exported in sysfs */
+static mraa_result_t
+mraa_pwm_chardev_request(mraa_pwm_context dev)
+{
+    struct _pwm_state* state = mraa_pwm_state(dev);
+    struct pwmchip_waveform wf;
+    char bu[MAX_SIZE];
+
+    if (state == NULL) {
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    snprintf(bu, MAX_SIZE, DEV_PWMCHIP "%d", dev->chipid);
+    int fd = open(bu, O_RDWR | O_CLOEXEC);
+    if (fd == -1) {
+        return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+    }
+    if (ioctl(fd, PWM_IOCTL_REQUEST, (unsigned long) dev->pin) < 0) {
+        close(fd);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    state->chardev = fd;
+    dev->owner = 1;
+
+    memset(&wf, 0, sizeof(wf));
+    wf.hwpwm = dev->pin;
+    if (ioctl(fd, PWM_IOCTL_GETWF, &wf) == 0 && wf.period_length_ns > 0) {
+        dev->period = (int) wf.period_length_ns;
+        state->duty = (int) wf.duty_length_ns;
+        state->enabled = 1;
+    } else {
+        // applied on enable
+        dev->period = plat->pwm_default_period * 1000;
+        state->duty = 0;
+        state->enabled = 0;
+    }
+    return MRAA_SUCCESS;
+}
+#endif
 
 static int
 mraa_pwm_setup_duty_fp(mraa_pwm_context dev)
@@ -32,6 +184,17 @@ mraa_pwm_setup_duty_fp(mraa_pwm_context dev)
     return 0;
 }
 
+/* Calls from the application are refused while the player owns the pwm */
+static mraa_boolean_t
+mraa_pwm_seq_busy(mraa_pwm_context dev, const char* fn)
+{
+    if (mraa_pwm_seq_output(dev, NULL)) {
+        syslog(LOG_ERR, "pwm%i: %s: a sequence is playing", dev->pin, fn);
+        return 1;
+    }
+    return 0;
+}
+
 static mraa_result_t
 mraa_pwm_write_period(mraa_pwm_context dev, int period)
 {
@@ -47,24 +210,30 @@ mraa_pwm_write_period(mraa_pwm_context dev, int period)
         }
         return result;
     }
-    char bu[MAX_SIZE];
-    snprintf(bu, MAX_SIZE, "/sys/class/pwm/pwmchip%d/pwm%d/period", dev->chipid, dev->pin);
-
-    int period_f = open(bu, O_RDWR);
-    if (period_f == -1) {
+    struct _pwm_state* state = mraa_pwm_state(dev);
+    if (state == NULL) {
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+#if defined(PWM_HAVE_CHARDEV)
+    if (state->chardev >= 0) {
+        mraa_result_t result = mraa_pwm_chardev_apply(dev, period, state->duty, state->enabled);
+        if (result == MRAA_SUCCESS) {
+            dev->period = period;
+        }
+        return result;
+    }
+#endif
+    if (mraa_pwm_sysfs_fd(dev, &state->period_fp, "period") == -1) {
         syslog(LOG_ERR, "pwm%i write_period: Failed to open period for writing: %s", dev->pin, strerror(errno));
         return MRAA_ERROR_INVALID_RESOURCE;
     }
-    char out[MAX_SIZE];
-    int length = snprintf(out, MAX_SIZE, "%d", period);
-    if (write(period_f, out, length * sizeof(char)) == -1) {
-        close(period_f);
+    if (mraa_pwm_sysfs_write(state->period_fp, period) != MRAA_SUCCESS) {
         syslog(LOG_ERR, "pwm%i write_period: Failed to write to period: %s", dev->pin, strerror(errno));
         return MRAA_ERROR_INVALID_RESOURCE;
     }
 
-    close(period_f);
     dev->period = period;
+    state->period_set = 1;
     return MRAA_SUCCESS;
 }
 
@@ -79,19 +248,33 @@ mraa_pwm_write_duty(mraa_pwm_context dev, int duty)
     if (IS_FUNC_DEFINED(dev, pwm_write_replace)) {
         return dev->advance_func->pwm_write_replace(dev, duty);
     }
+    struct _pwm_state* state = mraa_pwm_state(dev);
+    if (state == NULL) {
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+#if defined(PWM_HAVE_CHARDEV)
+    if (state->chardev >= 0) {
+        mraa_result_t result = mraa_pwm_chardev_apply(dev, dev->period, duty, state->enabled);
+        if (result == MRAA_SUCCESS) {
+            state->duty = duty;
+        }
+        return result;
+    }
+#endif
     if (dev->duty_fp == -1) {
         if (mraa_pwm_setup_duty_fp(dev) == 1) {
             syslog(LOG_ERR, "pwm%i write_duty: Failed to open duty_cycle for writing: %s", dev->pin, strerror(errno));
             return MRAA_ERROR_INVALID_RESOURCE;
         }
     }
-    char bu[MAX_SIZE];
-    int length = snprintf(bu, MAX_SIZE, "%d", duty);
-    if (write(dev->duty_fp, bu, length * sizeof(char)) == -1)
-    {
+    if (mraa_pwm_sysfs_write(dev->duty_fp, duty) != MRAA_SUCCESS) {
         syslog(LOG_ERR, "pwm%i write_duty: Failed to write to duty_cycle: %s", dev->pin, strerror(errno));
+        state->duty = -1;
+        state->duty_set = 0;
         return MRAA_ERROR_INVALID_RESOURCE;
     }
+    state->duty = duty;
+    state->duty_set = 1;
     return MRAA_SUCCESS;
 }
 
@@ -107,35 +290,26 @@ mraa_pwm_read_period(mraa_pwm_context dev)
         return dev->period;
     }
 
-    char bu[MAX_SIZE];
-    char output[MAX_SIZE];
-    snprintf(bu, MAX_SIZE, "/sys/class/pwm/pwmchip%d/pwm%d/period", dev->chipid, dev->pin);
-
-    int period_f = open(bu, O_RDWR);
-    if (period_f == -1) {
+    struct _pwm_state* state = mraa_pwm_state(dev);
+    if (state == NULL) {
+        return -1;
+    }
+    // only what this context wrote, or holds exclusively, is known to be current
+    if (dev->period > 0 && (state->period_set || state->chardev >= 0)) {
+        return dev->period;
+    }
+    if (mraa_pwm_sysfs_fd(dev, &state->period_fp, "period") == -1) {
         syslog(LOG_ERR, "pwm%i read_period: Failed to open period for reading: %s", dev->pin, strerror(errno));
         return 0;
     }
 
-    ssize_t rb = read(period_f, output, MAX_SIZE);
-    close(period_f);
-
-    if (rb < 0) {
+    int period;
+    if (mraa_pwm_sysfs_read(state->period_fp, &period) != MRAA_SUCCESS) {
         syslog(LOG_ERR, "pwm%i read_period: Failed to read period: %s", dev->pin, strerror(errno));
         return -1;
     }
-
-    char* endptr;
-    long int ret = strtol(output, &endptr, 10);
-    if ('\0' != *endptr && '\n' != *endptr) {
-        syslog(LOG_ERR, "pwm%i read_period: Error in string conversion", dev->pin);
-        return -1;
-    } else if (ret > INT_MAX || ret < INT_MIN) {
-        syslog(LOG_ERR, "pwm%i read_period: Number is invalid", dev->pin);
-        return -1;
-    }
-    dev->period = (int) ret;
-    return (int) ret;
+    dev->period = period;
+    return period;
 }
 
 static int
@@ -150,33 +324,28 @@ mraa_pwm_read_duty(mraa_pwm_context dev)
         return dev->advance_func->pwm_read_replace(dev);
     }
 
+    struct _pwm_state* state = mraa_pwm_state(dev);
+    if (state == NULL) {
+        return -1;
+    }
+    if (state->duty >= 0 && (state->duty_set || state->chardev >= 0)) {
+        return state->duty;
+    }
     if (dev->duty_fp == -1) {
         if (mraa_pwm_setup_duty_fp(dev) == 1) {
             syslog(LOG_ERR, "pwm%i read_duty: Failed to open duty_cycle for reading: %s",
                     dev->pin, strerror(errno));
             return -1;
         }
-    } else {
-        lseek(dev->duty_fp, 0, SEEK_SET);
     }
 
-    char output[MAX_SIZE];
-    ssize_t rb = read(dev->duty_fp, output, MAX_SIZE);
-    if (rb < 0) {
+    int duty;
+    if (mraa_pwm_sysfs_read(dev->duty_fp, &duty) != MRAA_SUCCESS) {
         syslog(LOG_ERR, "pwm%i read_duty: Failed to read duty_cycle: %s", dev->pin, strerror(errno));
         return -1;
     }
-
-    char* endptr;
-    long int ret = strtol(output, &endptr, 10);
-    if ('\0' != *endptr && '\n' != *endptr) {
-        syslog(LOG_ERR, "pwm%i read_duty: Error in string conversion", dev->pin);
-        return -1;
-    } else if (ret > INT_MAX || ret < INT_MIN) {
-        syslog(LOG_ERR, "pwm%i read_duty: Number is invalid", dev->pin);
-        return -1;
-    }
-    return (int) ret;
+    state->duty = duty;
+    return duty;
 }
 
 static mraa_pwm_context
@@ -278,6 +447,12 @@ mraa_pwm_init_raw(int chipin, int pin)
         }
     }
 
+#if defined(PWM_HAVE_CHARDEV)
+    if (mraa_pwm_chardev_request(dev) == MRAA_SUCCESS) {
+        return dev;
+    }
+#endif
+
     char directory[MAX_SIZE];
     snprintf(directory, MAX_SIZE, SYSFS_PWM "/pwmchip%d/pwm%d", dev->chipid, dev->pin);
     struct stat dir;
@@ -319,6 +494,9 @@ mraa_pwm_write(mraa_pwm_context dev, float percentage)
         syslog(LOG_ERR, "pwm: write: context is NULL");
         return MRAA_ERROR_INVALID_HANDLE;
     }
+    if (mraa_pwm_seq_busy(dev, "write")) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
 
     if (IS_FUNC_DEFINED(dev, pwm_write_pre)) {
         if (dev->advance_func->pwm_write_pre(dev, percentage) != MRAA_SUCCESS) {
@@ -327,9 +505,8 @@ mraa_pwm_write(mraa_pwm_context dev, float percentage)
         }
     }
 
-    if (dev->period == -1) {
-        if (mraa_pwm_read_period(dev) <= 0)
-            return MRAA_ERROR_NO_DATA_AVAILABLE;
+    if (mraa_pwm_read_period(dev) <= 0) {
+        return MRAA_ERROR_NO_DATA_AVAILABLE;
     }
 
     if (percentage > 1.0f) {
@@ -347,6 +524,11 @@ mraa_pwm_read(mraa_pwm_context dev)
         return MRAA_ERROR_INVALID_HANDLE;
     }
 
+    mraa_pwm_step_t out;
+    if (mraa_pwm_seq_output(dev, &out)) {
+        return out.period_ns > 0 ? out.duty_ns / (float) out.period_ns : 0.0f;
+    }
+
     int period = mraa_pwm_read_period(dev);
     if (period > 0) {
         return (mraa_pwm_read_duty(dev) / (float) period);
@@ -366,16 +548,11 @@ mraa_pwm_period_ms(mraa_pwm_context dev, int ms)
     return mraa_pwm_period_us(dev, ms * 1000);
 }
 
-mraa_result_t
-mraa_pwm_period_us(mraa_pwm_context dev, int us)
+static mraa_boolean_t
+mraa_pwm_period_in_range(mraa_pwm_context dev, int us)
 {
     int min, max;
 
-    if (!dev) {
-        syslog(LOG_ERR, "pwm: period: context is NULL");
-        return MRAA_ERROR_INVALID_HANDLE;
-    }
-
     if (mraa_is_sub_platform_id(dev->chipid)) {
         min = plat->sub_platform->pwm_min_period;
         max = plat->sub_platform->pwm_max_period;
@@ -383,7 +560,21 @@ mraa_pwm_period_us(mraa_pwm_context dev, int us)
         min = plat->pwm_min_period;
         max = plat->pwm_max_period;
     }
-    if (us < min || us > max) {
+    return us >= min && us <= max;
+}
+
+mraa_result_t
+mraa_pwm_period_us(mraa_pwm_context dev, int us)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "pwm: period: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (mraa_pwm_seq_busy(dev, "period")) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    if (!mraa_pwm_period_in_range(dev, us)) {
         syslog(LOG_ERR, "pwm_period: pwm%i: %i uS outside platform range", dev->pin, us);
         return MRAA_ERROR_INVALID_PARAMETER;
     }
@@ -405,9 +596,94 @@ mraa_pwm_pulsewidth_ms(mraa_pwm_context dev, int ms)
 mraa_result_t
 mraa_pwm_pulsewidth_us(mraa_pwm_context dev, int us)
 {
+    if (dev != NULL && mraa_pwm_seq_busy(dev, "pulsewidth")) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
     return mraa_pwm_write_duty(dev, us * 1000);
 }
 
+mraa_result_t
+mraa_pwm_config_check(mraa_pwm_context dev, int period_ns, int duty_ns)
+{
+    if (period_ns <= 0 || duty_ns < 0 || duty_ns > period_ns) {
+        syslog(LOG_ERR, "pwm_config: pwm%i: duty %i ns does not fit period %i ns", dev->pin, duty_ns, period_ns);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    if (!mraa_pwm_period_in_range(dev, period_ns / 1000)) {
+        syslog(LOG_ERR, "pwm_config: pwm%i: %i nS outside platform range", dev->pin, period_ns);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_pwm_config_apply(mraa_pwm_context dev, int period_ns, int duty_ns)
+{
+    mraa_result_t ret = MRAA_SUCCESS;
+
+    // platform hooks get the same two calls as period_us and pulsewidth_us
+    if (IS_FUNC_DEFINED(dev, pwm_period_replace) || IS_FUNC_DEFINED(dev, pwm_write_replace)) {
+        if (period_ns != dev->period) {
+            ret = mraa_pwm_write_period(dev, period_ns);
+        }
+        return ret == MRAA_SUCCESS ? mraa_pwm_write_duty(dev, duty_ns) : ret;
+    }
+
+    struct _pwm_state* state = mraa_pwm_state(dev);
+    if (state == NULL) {
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+#if defined(PWM_HAVE_CHARDEV)
+    if (state->chardev >= 0) {
+        ret = mraa_pwm_chardev_apply(dev, period_ns, duty_ns, state->enabled);
+        if (ret == MRAA_SUCCESS) {
+            dev->period = period_ns;
+            state->duty = duty_ns;
+        }
+        return ret;
+    }
+#endif
+    mraa_pwm_read_period(dev);
+    mraa_pwm_read_duty(dev);
+
+    // sysfs refuses a duty longer than the period after either write, so
+    // shrink the duty first when the new period is below the current duty
+    if (period_ns != dev->period && period_ns < state->duty) {
+        if (duty_ns != state->duty) {
+            ret = mraa_pwm_write_duty(dev, duty_ns);
+        }
+        if (ret == MRAA_SUCCESS) {
+            ret = mraa_pwm_write_period(dev, period_ns);
+        }
+        return ret;
+    }
+    if (period_ns != dev->period) {
+        ret = mraa_pwm_write_period(dev, period_ns);
+    }
+    if (ret == MRAA_SUCCESS && duty_ns != state->duty) {
+        ret = mraa_pwm_write_duty(dev, duty_ns);
+    }
+    return ret;
+}
+
+mraa_result_t
+mraa_pwm_config(mraa_pwm_context dev, int period_ns, int duty_ns)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "pwm: config: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (mraa_pwm_seq_busy(dev, "config")) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    mraa_result_t ret = mraa_pwm_config_check(dev, period_ns, duty_ns);
+    if (ret != MRAA_SUCCESS) {
+        return ret;
+    }
+    return mraa_pwm_config_apply(dev, period_ns, duty_ns);
+}
+
 mraa_result_t
 mraa_pwm_enable(mraa_pwm_context dev, int enable)
 {
@@ -415,6 +691,9 @@ mraa_pwm_enable(mraa_pwm_context dev, int enable)
         syslog(LOG_ERR, "pwm: enable: context is NULL");
         return MRAA_ERROR_INVALID_HANDLE;
     }
+    if (mraa_pwm_seq_busy(dev, "enable")) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
 
     if (IS_FUNC_DEFINED(dev, pwm_enable_replace)) {
         return dev->advance_func->pwm_enable_replace(dev, enable);
@@ -427,23 +706,29 @@ mraa_pwm_enable(mraa_pwm_context dev, int enable)
         }
     }
 
-    char bu[MAX_SIZE];
-    snprintf(bu, MAX_SIZE, "/sys/class/pwm/pwmchip%d/pwm%d/enable", dev->chipid, dev->pin);
-
-    int enable_f = open(bu, O_RDWR);
-
-    if (enable_f == -1) {
+    struct _pwm_state* state = mraa_pwm_state(dev);
+    if (state == NULL) {
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    enable = enable ? 1 : 0;
+#if defined(PWM_HAVE_CHARDEV)
+    if (state->chardev >= 0) {
+        mraa_result_t result = mraa_pwm_chardev_apply(dev, dev->period, state->duty, enable);
+        if (result == MRAA_SUCCESS) {
+            state->enabled = enable;
+        }
+        return result;
+    }
+#endif
+    if (mraa_pwm_sysfs_fd(dev, &state->enable_fp, "enable") == -1) {
         syslog(LOG_ERR, "pwm_enable: pwm%i: Failed to open enable for writing: %s", dev->pin, strerror(errno));
         return MRAA_ERROR_INVALID_RESOURCE;
     }
-    char out[2];
-    int size = snprintf(out, sizeof(out), "%d", enable);
-    if (write(enable_f, out, size * sizeof(char)) == -1) {
+    if (mraa_pwm_sysfs_write(state->enable_fp, enable) != MRAA_SUCCESS) {
         syslog(LOG_ERR, "pwm_enable: pwm%i: Failed to write to enable: %s", dev->pin, strerror(errno));
-        close(enable_f);
         return MRAA_ERROR_UNSPECIFIED;
     }
-    close(enable_f);
+    state->enabled = enable;
     return MRAA_SUCCESS;
 }
 
@@ -480,6 +765,14 @@ mraa_pwm_unexport(mraa_pwm_context dev)
     }
 
     mraa_pwm_enable(dev, 0);
+#if defined(PWM_HAVE_CHARDEV)
+    if (dev->state != NULL && dev->state->chardev >= 0) {
+        ioctl(dev->state->chardev, PWM_IOCTL_FREE, (unsigned long) dev->pin);
+        close(dev->state->chardev);
+        dev->state->chardev = -1;
+        return MRAA_SUCCESS;
+    }
+#endif
     if (dev->owner) {
         return mraa_pwm_unexport_force(dev);
     }
@@ -494,10 +787,22 @@ mraa_pwm_close(mraa_pwm_context dev)
         return MRAA_ERROR_INVALID_HANDLE;
     }
 
+    if (dev->seq != NULL) {
+        mraa_pwm_seq_stop(dev);
+    }
     mraa_pwm_unexport(dev);
     if (dev->duty_fp != -1) {
         close(dev->duty_fp);
     }
+    if (dev->state != NULL) {
+        if (dev->state->period_fp != -1) {
+            close(dev->state->period_fp);
+        }
+        if (dev->state->enable_fp != -1) {
+            close(dev->state->enable_fp);
+        }
+        free(dev->state);
+    }
     free(dev);
     return MRAA_SUCCESS;
 }
@@ -0,0 +1,565 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "pwm.h"
+#include "mraa_internal.h"
+
+#define NSEC_PER_SEC 1000000000LL
+
+/**
+ * One sequence. Built by the caller, then owned by the player thread
+ * once it is taken from pending.
+ */
+struct _pwm_seq_track {
+    float* duty;             /**< fractions of the period, or NULL */
+    mraa_pwm_step_t* steps;  /**< period and duty pairs, or NULL */
+    unsigned int count;      /**< array length, 0 for a generator */
+    mraa_pwm_seq_mode_t mode;
+    mraa_pwm_seq_gen_t gen;  /**< used when both arrays are NULL */
+    void* args;
+    long long period_ns;     /**< update interval */
+    unsigned long long fade; /**< updates blended from the previous output */
+};
+
+/**
+ * Player state. Only the thread touches the playing track and the
+ * output; pending, finished and the statistics are shared under lock.
+ */
+struct _pwm_seq {
+    mraa_pwm_context pwm;
+    pthread_t thread_id;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;     /**< signalled when a one-shot finishes */
+    int timer_fd;
+    int control_pipe[2];     /**< a byte per new track, closed to exit */
+
+    struct _pwm_seq_track* track;
+    struct _pwm_seq_track* pending;
+    int finished;
+    unsigned long long index; /**< next update of the track */
+    long long start_ns;       /**< time the first update of the track was due */
+    mraa_pwm_step_t out;      /**< last written, period 0 when unknown */
+    mraa_pwm_step_t from;     /**< output when the track started */
+
+    unsigned long long updates;
+    unsigned long long missed;
+    unsigned long long errors;
+    long long max_lateness_ns;
+    long long sum_lateness_ns;
+    unsigned long long track_updates;
+    long long first_ns;
+    long long last_ns;
+};
+
+static long long
+mraa_pwm_seq_now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static void
+mraa_pwm_seq_track_free(struct _pwm_seq_track* track)
+{
+    if (track != NULL) {
+        free(track->duty);
+        free(track->steps);
+        free(track);
+    }
+}
+
+/* Start the timer now, or stop it when start_ns is 0 */
+static void
+mraa_pwm_seq_arm(struct _pwm_seq* seq, long long start_ns, long long period_ns)
+{
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    if (start_ns > 0) {
+        its.it_value.tv_sec = start_ns / NSEC_PER_SEC;
+        its.it_value.tv_nsec = start_ns % NSEC_PER_SEC;
+        its.it_interval.tv_sec = period_ns / NSEC_PER_SEC;
+        its.it_interval.tv_nsec = period_ns % NSEC_PER_SEC;
+    }
+    if (timerfd_settime(seq->timer_fd, TFD_TIMER_ABSTIME, &its, NULL) != 0) {
+        syslog(LOG_ERR, "pwm%i: seq: failed to set timer: %s", seq->pwm->pin, strerror(errno));
+    }
+}
+
+static void
+mraa_pwm_seq_adopt(struct _pwm_seq* seq)
+{
+    pthread_mutex_lock(&seq->lock);
+    struct _pwm_seq_track* track = seq->pending;
+    struct _pwm_seq_track* old = seq->track;
+    if (track == NULL) {
+        pthread_mutex_unlock(&seq->lock);
+        return;
+    }
+    seq->pending = NULL;
+    seq->track = track;
+    seq->finished = 0;
+    seq->index = 0;
+    seq->from = seq->out;
+    seq->start_ns = mraa_pwm_seq_now();
+    seq->track_updates = 0;
+    pthread_mutex_unlock(&seq->lock);
+
+    mraa_pwm_seq_track_free(old);
+    mraa_pwm_seq_arm(seq, seq->start_ns, track->period_ns);
+}
+
+/*
+ * Work out the output of an update, returns 0 when there is none and the
+ * track is over. last is set once the track has nothing after this one.
+ */
+static int
+mraa_pwm_seq_step(struct _pwm_seq* seq, struct _pwm_seq_track* track, unsigned long long index, mraa_pwm_step_t* step, int* last)
+{
+    *last = 0;
+    if (track->duty == NULL && track->steps == NULL) {
+        return track->gen(index, step, track->args);
+    }
+
+    unsigned int i;
+    if (track->mode == MRAA_PWM_SEQ_LOOP) {
+        i = (unsigned int) (index % track->count);
+    } else {
+        // a late thread may jump past the end, the final step is still written
+        i = index < track->count ? (unsigned int) index : track->count - 1;
+        *last = index + 1 >= track->count;
+    }
+    if (track->steps != NULL) {
+        *step = track->steps[i];
+    } else {
+        step->period_ns = seq->pwm->period;
+        step->duty_ns = (int) (track->duty[i] * step->period_ns);
+    }
+    return 1;
+}
+
+static void
+mraa_pwm_seq_tick(struct _pwm_seq* seq, uint64_t expirations)
+{
+    struct _pwm_seq_track* track = seq->track;
+    if (track == NULL || seq->finished || expirations == 0) {
+        return;
+    }
+
+    // the update due now, ones missed in between are skipped to keep time
+    unsigned long long index = seq->index + expirations - 1;
+    unsigned long long skipped = expirations - 1;
+    if ((track->duty != NULL || track->steps != NULL) && track->mode == MRAA_PWM_SEQ_ONESHOT &&
+        index >= track->count) {
+        // only steps that exist can be missed, the final one is still written
+        skipped = seq->index < track->count ? track->count - 1 - seq->index : 0;
+    }
+    long long now = mraa_pwm_seq_now();
+    long long lateness = now - (seq->start_ns + (long long) index * track->period_ns);
+    mraa_pwm_step_t step = seq->out;
+    int last;
+    int write = mraa_pwm_seq_step(seq, track, index, &step, &last);
+    mraa_result_t ret = MRAA_SUCCESS;
+
+    if (write) {
+        if (index < track->fade && seq->from.period_ns > 0) {
+            long long n = (long long) index + 1;
+            long long fade = (long long) track->fade;
+            step.period_ns = seq->from.period_ns + ((long long) step.period_ns - seq->from.period_ns) * n / fade;
+            step.duty_ns = seq->from.duty_ns + ((long long) step.duty_ns - seq->from.duty_ns) * n / fade;
+        }
+        if (track->duty == NULL && track->steps == NULL) {
+            // array steps were checked when queued, generated ones are not
+            ret = mraa_pwm_config_check(seq->pwm, step.period_ns, step.duty_ns);
+        }
+        if (ret == MRAA_SUCCESS) {
+            ret = mraa_pwm_config_apply(seq->pwm, step.period_ns, step.duty_ns);
+        }
+    }
+    seq->index = index + 1;
+
+    pthread_mutex_lock(&seq->lock);
+    seq->missed += skipped;
+    if (write) {
+        if (ret == MRAA_SUCCESS) {
+            seq->out = step;
+            seq->updates++;
+        } else {
+            seq->errors++;
+        }
+        if (lateness > seq->max_lateness_ns) {
+            seq->max_lateness_ns = lateness;
+        }
+        seq->sum_lateness_ns += lateness;
+        if (seq->track_updates++ == 0) {
+            seq->first_ns = now;
+        }
+        seq->last_ns = now;
+    }
+    if (!write || last) {
+        seq->finished = 1;
+        mraa_pwm_seq_arm(seq, 0, 0);
+        pthread_cond_broadcast(&seq->cond);
+    }
+    pthread_mutex_unlock(&seq->lock);
+}
+
+static void*
+mraa_pwm_seq_handler(void* arg)
+{
+    struct _pwm_seq* seq = (struct _pwm_seq*) arg;
+    struct pollfd pfd[2];
+
+    pfd[0].fd = seq->timer_fd;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = seq->control_pipe[0];
+    pfd[1].events = POLLIN;
+
+    for (;;) {
+        if (poll(pfd, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            syslog(LOG_ERR, "pwm%i: seq: poll failed: %s", seq->pwm->pin, strerror(errno));
+            break;
+        }
+        if (pfd[1].revents) {
+            char buf[16];
+            ssize_t n = read(seq->control_pipe[0], buf, sizeof(buf));
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+                break;
+            }
+            mraa_pwm_seq_adopt(seq);
+            continue;
+        }
+        if (pfd[0].revents & POLLIN) {
+            uint64_t expirations;
+            if (read(seq->timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+                mraa_pwm_seq_tick(seq, expirations);
+            }
+        }
+    }
+
+    // nothing will play anymore, release anyone waiting
+    pthread_mutex_lock(&seq->lock);
+    mraa_pwm_seq_track_free(seq->pending);
+    seq->pending = NULL;
+    seq->finished = 1;
+    pthread_cond_broadcast(&seq->cond);
+    pthread_mutex_unlock(&seq->lock);
+    return NULL;
+}
+
+static void
+mraa_pwm_seq_free(struct _pwm_seq* seq)
+{
+    if (seq->timer_fd >= 0) {
+        close(seq->timer_fd);
+    }
+    if (seq->control_pipe[0] >= 0) {
+        close(seq->control_pipe[0]);
+    }
+    if (seq->control_pipe[1] >= 0) {
+        close(seq->control_pipe[1]);
+    }
+    mraa_pwm_seq_track_free(seq->track);
+    mraa_pwm_seq_track_free(seq->pending);
+    pthread_cond_destroy(&seq->cond);
+    pthread_mutex_destroy(&seq->lock);
+    free(seq);
+}
+
+static struct _pwm_seq*
+mraa_pwm_seq_launch(mraa_pwm_context dev)
+{
+    struct _pwm_seq* seq = calloc(1, sizeof(struct _pwm_seq));
+    if (seq == NULL) {
+        syslog(LOG_CRIT, "pwm%i: seq: Failed to allocate memory for context", dev->pin);
+        return NULL;
+    }
+    seq->pwm = dev;
+    seq->finished = 1;
+    seq->control_pipe[0] = seq->control_pipe[1] = -1;
+    pthread_mutex_init(&seq->lock, NULL);
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&seq->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    // blend from whatever the pwm is outputting now
+    float current = mraa_pwm_read(dev);
+    if (dev->period > 0 && current >= 0.0f) {
+        seq->out.period_ns = dev->period;
+        seq->out.duty_ns = (int) (current * dev->period);
+    }
+
+    seq->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (seq->timer_fd < 0 || pipe(seq->control_pipe) != 0) {
+        syslog(LOG_ERR, "pwm%i: seq: failed to create timer: %s", dev->pin, strerror(errno));
+        mraa_pwm_seq_free(seq);
+        return NULL;
+    }
+    fcntl(seq->control_pipe[0], F_SETFL, O_NONBLOCK);
+
+    int ret = pthread_create(&seq->thread_id, NULL, mraa_pwm_seq_handler, (void*) seq);
+    if (ret != 0) {
+        syslog(LOG_ERR, "pwm%i: seq: failed to create thread: %s", dev->pin, strerror(ret));
+        mraa_pwm_seq_free(seq);
+        return NULL;
+    }
+    return seq;
+}
+
+/* Hand a track to the player, starting it first if needed */
+static mraa_result_t
+mraa_pwm_seq_submit(mraa_pwm_context dev, struct _pwm_seq_track* track, unsigned int rate_hz, unsigned int crossfade_ms)
+{
+    track->period_ns = NSEC_PER_SEC / rate_hz;
+    track->fade = (unsigned long long) crossfade_ms * rate_hz / 1000;
+
+    if (dev->seq == NULL) {
+        dev->seq = mraa_pwm_seq_launch(dev);
+        if (dev->seq == NULL) {
+            mraa_pwm_seq_track_free(track);
+            return MRAA_ERROR_NO_RESOURCES;
+        }
+    }
+
+    struct _pwm_seq* seq = dev->seq;
+    pthread_mutex_lock(&seq->lock);
+    mraa_pwm_seq_track_free(seq->pending);
+    seq->pending = track;
+    pthread_mutex_unlock(&seq->lock);
+
+    char c = 0;
+    if (write(seq->control_pipe[1], &c, 1) != 1) {
+        syslog(LOG_ERR, "pwm%i: seq: failed to wake player: %s", dev->pin, strerror(errno));
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    return MRAA_SUCCESS;
+}
+
+static struct _pwm_seq_track*
+mraa_pwm_seq_track_new(mraa_pwm_context dev, const char* fn, unsigned int count, unsigned int rate_hz, mraa_pwm_seq_mode_t mode)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "pwm: %s: context is NULL", fn);
+        return NULL;
+    }
+    if (count == 0 || rate_hz == 0 || rate_hz > NSEC_PER_SEC ||
+        (mode != MRAA_PWM_SEQ_ONESHOT && mode != MRAA_PWM_SEQ_LOOP)) {
+        syslog(LOG_ERR, "pwm%i: %s: invalid parameters", dev->pin, fn);
+        return NULL;
+    }
+
+    struct _pwm_seq_track* track = calloc(1, sizeof(struct _pwm_seq_track));
+    if (track == NULL) {
+        syslog(LOG_CRIT, "pwm%i: %s: Failed to allocate memory for sequence", dev->pin, fn);
+        return NULL;
+    }
+    track->count = count;
+    track->mode = mode;
+    return track;
+}
+
+mraa_result_t
+mraa_pwm_seq_play(mraa_pwm_context dev, const float* duty, unsigned int count, unsigned int rate_hz, mraa_pwm_seq_mode_t mode, unsigned int crossfade_ms)
+{
+    if (duty == NULL) {
+        syslog(LOG_ERR, "pwm: seq_play: no duty cycles given");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    struct _pwm_seq_track* track = mraa_pwm_seq_track_new(dev, "seq_play", count, rate_hz, mode);
+    if (track == NULL) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    // duty cycles are taken of the period in place at every update, while
+    // a sequence plays only the player thread may look at the context
+    mraa_pwm_step_t out;
+    int period;
+    if (mraa_pwm_seq_output(dev, &out)) {
+        period = out.period_ns;
+    } else {
+        if (dev->period <= 0) {
+            mraa_pwm_read(dev);
+        }
+        period = dev->period;
+    }
+    if (period <= 0) {
+        syslog(LOG_ERR, "pwm%i: seq_play: period is not set", dev->pin);
+        mraa_pwm_seq_track_free(track);
+        return MRAA_ERROR_NO_DATA_AVAILABLE;
+    }
+
+    track->duty = malloc(count * sizeof(float));
+    if (track->duty == NULL) {
+        syslog(LOG_CRIT, "pwm%i: seq_play: Failed to allocate memory for sequence", dev->pin);
+        mraa_pwm_seq_track_free(track);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    for (unsigned int i = 0; i < count; i++) {
+        // same clamping as mraa_pwm_write()
+        track->duty[i] = duty[i] > 1.0f ? 1.0f : (duty[i] < 0.0f ? 0.0f : duty[i]);
+    }
+    return mraa_pwm_seq_submit(dev, track, rate_hz, crossfade_ms);
+}
+
+mraa_result_t
+mraa_pwm_seq_play_steps(mraa_pwm_context dev, const mraa_pwm_step_t* steps, unsigned int count, unsigned int rate_hz, mraa_pwm_seq_mode_t mode, unsigned int crossfade_ms)
+{
+    if (steps == NULL) {
+        syslog(LOG_ERR, "pwm: seq_play_steps: no steps given");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    struct _pwm_seq_track* track = mraa_pwm_seq_track_new(dev, "seq_play_steps", count, rate_hz, mode);
+    if (track == NULL) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+        mraa_result_t ret = mraa_pwm_config_check(dev, steps[i].period_ns, steps[i].duty_ns);
+        if (ret != MRAA_SUCCESS) {
+            mraa_pwm_seq_track_free(track);
+            return ret;
+        }
+    }
+    track->steps = malloc(count * sizeof(mraa_pwm_step_t));
+    if (track->steps == NULL) {
+        syslog(LOG_CRIT, "pwm%i: seq_play_steps: Failed to allocate memory for sequence", dev->pin);
+        mraa_pwm_seq_track_free(track);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    memcpy(track->steps, steps, count * sizeof(mraa_pwm_step_t));
+    return mraa_pwm_seq_submit(dev, track, rate_hz, crossfade_ms);
+}
+
+mraa_result_t
+mraa_pwm_seq_play_gen(mraa_pwm_context dev, mraa_pwm_seq_gen_t gen, void* args, unsigned int rate_hz, unsigned int crossfade_ms)
+{
+    if (gen == NULL) {
+        syslog(LOG_ERR, "pwm: seq_play_gen: no generator given");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    struct _pwm_seq_track* track = mraa_pwm_seq_track_new(dev, "seq_play_gen", 1, rate_hz, MRAA_PWM_SEQ_ONESHOT);
+    if (track == NULL) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    // open ended, every skipped update counts as missed
+    track->count = 0;
+    track->gen = gen;
+    track->args = args;
+    return mraa_pwm_seq_submit(dev, track, rate_hz, crossfade_ms);
+}
+
+mraa_boolean_t
+mraa_pwm_seq_output(mraa_pwm_context dev, mraa_pwm_step_t* out)
+{
+    if (dev == NULL || dev->seq == NULL) {
+        return 0;
+    }
+
+    struct _pwm_seq* seq = dev->seq;
+    pthread_mutex_lock(&seq->lock);
+    mraa_boolean_t playing = !seq->finished || seq->pending != NULL;
+    if (out != NULL) {
+        *out = seq->out;
+    }
+    pthread_mutex_unlock(&seq->lock);
+    return playing;
+}
+
+mraa_result_t
+mraa_pwm_seq_wait(mraa_pwm_context dev, int timeout_ms)
+{
+    if (dev == NULL || dev->seq == NULL) {
+        syslog(LOG_ERR, "pwm: seq_wait: no sequence playing");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    struct _pwm_seq* seq = dev->seq;
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    if (timeout_ms > 0) {
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long) (timeout_ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= NSEC_PER_SEC) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= NSEC_PER_SEC;
+        }
+    }
+
+    pthread_mutex_lock(&seq->lock);
+    // a queued track has not started yet, so it has not finished either
+    while (!seq->finished || seq->pending != NULL) {
+        if (timeout_ms < 0) {
+            pthread_cond_wait(&seq->cond, &seq->lock);
+        } else if (pthread_cond_timedwait(&seq->cond, &seq->lock, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    mraa_result_t ret = seq->finished && seq->pending == NULL ? MRAA_SUCCESS : MRAA_ERROR_NO_DATA_AVAILABLE;
+    pthread_mutex_unlock(&seq->lock);
+    return ret;
+}
+
+mraa_result_t
+mraa_pwm_seq_get_stats(mraa_pwm_context dev, mraa_pwm_seq_stats_t* stats)
+{
+    if (dev == NULL || dev->seq == NULL || stats == NULL) {
+        syslog(LOG_ERR, "pwm: seq_get_stats: no sequence playing");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    struct _pwm_seq* seq = dev->seq;
+    pthread_mutex_lock(&seq->lock);
+    unsigned long long samples = seq->updates + seq->errors;
+    stats->updates = seq->updates;
+    stats->missed = seq->missed;
+    stats->errors = seq->errors;
+    stats->max_lateness_ns = seq->max_lateness_ns;
+    stats->mean_lateness_ns = samples > 0 ? seq->sum_lateness_ns / (long long) samples : 0;
+    stats->rate_hz = 0.0f;
+    if (seq->track_updates > 1 && seq->last_ns > seq->first_ns) {
+        stats->rate_hz = (float) ((double) (seq->track_updates - 1) * NSEC_PER_SEC / (seq->last_ns - seq->first_ns));
+    }
+    pthread_mutex_unlock(&seq->lock);
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_pwm_seq_stop(mraa_pwm_context dev)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "pwm: seq_stop: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (dev->seq == NULL) {
+        return MRAA_SUCCESS;
+    }
+
+    struct _pwm_seq* seq = dev->seq;
+    close(seq->control_pipe[1]);
+    seq->control_pipe[1] = -1;
+    pthread_join(seq->thread_id, NULL);
+
+    mraa_pwm_seq_free(seq);
+    dev->seq = NULL;
+    return MRAA_SUCCESS;
+}
@@ -25,12 +25,225 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
+#include <limits.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 #include "spi.h"
 #include "mraa_internal.h"
 
 #define MAX_SIZE 64
 #define SPI_MAX_LENGTH 4096
+#define SPI_BUFSIZ_PATH "/sys/module/spidev/parameters/bufsiz"
+
+/*
+ * spidev rejects any message larger than its bufsiz module parameter, read it
+ * once so transfers can be split to fit. Falls back to the kernel default.
+ */
+static unsigned int
+mraa_spi_read_bufsiz()
+{
+    char buf[MAX_SIZE];
+    int fd = open(SPI_BUFSIZ_PATH, O_RDONLY);
+    if (fd == -1) {
+        return SPI_MAX_LENGTH;
+    }
+
+    ssize_t rb = read(fd, buf, MAX_SIZE - 1);
+    close(fd);
+    if (rb <= 0) {
+        return SPI_MAX_LENGTH;
+    }
+    buf[rb] = '\0';
+
+    char* endptr;
+    unsigned long ret = strtoul(buf, &endptr, 10);
+    if (('\0' != *endptr && '\n' != *endptr) || ret == 0 || ret > INT_MAX) {
+        syslog(LOG_WARNING, "spi: Invalid spidev bufsiz, using %d", SPI_MAX_LENGTH);
+        return SPI_MAX_LENGTH;
+    }
+    return (unsigned int) ret;
+}
+
+#define SPI_BITREV2(n) n, n + 2 * 64, n + 1 * 64, n + 3 * 64
+#define SPI_BITREV4(n) SPI_BITREV2(n), SPI_BITREV2(n + 2 * 16), SPI_BITREV2(n + 1 * 16), SPI_BITREV2(n + 3 * 16)
+#define SPI_BITREV6(n) SPI_BITREV4(n), SPI_BITREV4(n + 2 * 4), SPI_BITREV4(n + 1 * 4), SPI_BITREV4(n + 3 * 4)
+
+static const uint8_t spi_bitrev_table[256] = { SPI_BITREV6(0), SPI_BITREV6(2), SPI_BITREV6(1), SPI_BITREV6(3) };
+
+/*
+ * Software bit order and word size conversion for controllers that refuse
+ * SPI_LSB_FIRST or 16 bit words. Reversing bits and swapping bytes are both
+ * their own inverse so the same routine converts tx before and rx after a
+ * transfer, dst may equal src.
+ */
+static void
+mraa_spi_soft_convert_scalar(uint8_t* dst, const uint8_t* src, int len, mraa_boolean_t rev, int word)
+{
+    int i = 0;
+    if (word > 1) {
+        for (; i + word <= len; i += word) {
+            uint8_t tmp[4];
+            for (int b = 0; b < word; b++) {
+                tmp[b] = src[i + word - 1 - b];
+            }
+            for (int b = 0; b < word; b++) {
+                dst[i + b] = rev ? spi_bitrev_table[tmp[b]] : tmp[b];
+            }
+        }
+    }
+    for (; i < len; i++) {
+        dst[i] = rev ? spi_bitrev_table[src[i]] : src[i];
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("ssse3"))) static void
+mraa_spi_soft_convert_ssse3(uint8_t* dst, const uint8_t* src, int len, mraa_boolean_t rev, int word)
+{
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i rev_lo = _mm_setr_epi8(0x00, 0x80, 0x40, 0xc0, 0x20, 0xa0, 0x60, 0xe0,
+                                         0x10, 0x90, 0x50, 0xd0, 0x30, 0xb0, 0x70, 0xf0);
+    const __m128i rev_hi = _mm_setr_epi8(0x00, 0x08, 0x04, 0x0c, 0x02, 0x0a, 0x06, 0x0e,
+                                         0x01, 0x09, 0x05, 0x0d, 0x03, 0x0b, 0x07, 0x0f);
+    const __m128i swap =
+    word == 4 ? _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+              : _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+    int i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*) (src + i));
+        if (rev) {
+            __m128i lo = _mm_and_si128(v, nibble);
+            __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+            v = _mm_or_si128(_mm_shuffle_epi8(rev_lo, lo), _mm_shuffle_epi8(rev_hi, hi));
+        }
+        if (word > 1) {
+            v = _mm_shuffle_epi8(v, swap);
+        }
+        _mm_storeu_si128((__m128i*) (dst + i), v);
+    }
+    mraa_spi_soft_convert_scalar(dst + i, src + i, len - i, rev, word);
+}
+#elif defined(__aarch64__)
+static void
+mraa_spi_soft_convert_neon(uint8_t* dst, const uint8_t* src, int len, mraa_boolean_t rev, int word)
+{
+    int i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        if (rev) {
+            v = vrbitq_u8(v);
+        }
+        if (word == 2) {
+            v = vrev16q_u8(v);
+        } else if (word == 4) {
+            v = vrev32q_u8(v);
+        }
+        vst1q_u8(dst + i, v);
+    }
+    mraa_spi_soft_convert_scalar(dst + i, src + i, len - i, rev, word);
+}
+#endif
+
+void
+mraa_spi_soft_convert(mraa_spi_context dev, uint8_t* dst, const uint8_t* src, int len)
+{
+    mraa_boolean_t rev = dev->soft_lsb;
+    int word = 1;
+    if (dev->soft_word16) {
+        // a 16 bit word goes out msb first, or lsb first in lsb mode, emulating
+        // it with 8 bit transfers needs a swap when that differs from host order
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        word = !dev->lsb ? 2 : 1;
+#else
+        word = dev->lsb ? 2 : 1;
+#endif
+    } else if (dev->soft_lsb && dev->bpw > 8) {
+        // the controller shifts whole words msb first, so reversing a word's
+        // bits also reverses the order of its bytes, whatever the host order
+        word = dev->bpw > 16 ? 4 : 2;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    static int has_ssse3 = -1;
+    if (has_ssse3 < 0) {
+        __builtin_cpu_init();
+        has_ssse3 = __builtin_cpu_supports("ssse3");
+    }
+    if (has_ssse3) {
+        mraa_spi_soft_convert_ssse3(dst, src, len, rev, word);
+        return;
+    }
+#elif defined(__aarch64__)
+    mraa_spi_soft_convert_neon(dst, src, len, rev, word);
+    return;
+#endif
+    mraa_spi_soft_convert_scalar(dst, src, len, rev, word);
+}
+
+/*
+ * Perform a transfer of any length as a sequence of spidev messages no larger
+ * than bufsiz. Chunks stay aligned to whole words and chip select is held
+ * asserted between them so the device sees one continuous transaction.
+ */
+static mraa_result_t
+mraa_spi_transfer_chunked(mraa_spi_context dev, uint8_t* data, uint8_t* rxbuf, int length)
+{
+    if (length < 0) {
+        syslog(LOG_ERR, "spi: transfer: invalid length %d", length);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    int word = dev->bpw > 16 ? 4 : (dev->bpw > 8 || dev->soft_word16 ? 2 : 1);
+    int bufsiz = dev->max_xfer > 0 ? (int) dev->max_xfer : SPI_MAX_LENGTH;
+    int chunk = bufsiz - bufsiz % word;
+
+    mraa_boolean_t soft = dev->soft_lsb || dev->soft_word16;
+    if (soft && data != NULL && dev->soft_buf == NULL) {
+        // sized for the whole bufsiz, a later word size change only shrinks chunk
+        dev->soft_buf = malloc(bufsiz);
+        if (dev->soft_buf == NULL) {
+            syslog(LOG_ERR, "spi: transfer: Failed to allocate conversion buffer");
+            return MRAA_ERROR_NO_RESOURCES;
+        }
+    }
+
+    struct spi_ioc_transfer msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.speed_hz = dev->clock;
+    msg.bits_per_word = dev->bpw;
+    msg.delay_usecs = 0;
+
+    int offset = 0;
+    do {
+        int seg = length - offset;
+        if (seg > chunk) {
+            seg = chunk;
+        }
+        msg.tx_buf = data != NULL ? (unsigned long) (data + offset) : 0;
+        if (soft && data != NULL) {
+            mraa_spi_soft_convert(dev, dev->soft_buf, data + offset, seg);
+            msg.tx_buf = (unsigned long) dev->soft_buf;
+        }
+        msg.rx_buf = rxbuf != NULL ? (unsigned long) (rxbuf + offset) : 0;
+        msg.len = seg;
+        msg.cs_change = (offset + seg) < length;
+        if (ioctl(dev->devfd, SPI_IOC_MESSAGE(1), &msg) < 0) {
+            syslog(LOG_ERR, "spi: Failed to perform dev transfer");
+            return MRAA_ERROR_INVALID_RESOURCE;
+        }
+        if (soft && rxbuf != NULL) {
+            mraa_spi_soft_convert(dev, rxbuf + offset, rxbuf + offset, seg);
+        }
+        offset += seg;
+    } while (offset < length);
+
+    return MRAA_SUCCESS;
+}
 
 static mraa_spi_context
 mraa_spi_init_internal(mraa_adv_func_t* func_table)
@@ -40,6 +253,7 @@ mraa_spi_init_internal(mraa_adv_func_t* func_table)
         return NULL;
     }
     dev->advance_func = func_table;
+    dev->stream_cpu = -1;
 
     return dev;
 }
@@ -149,6 +363,8 @@ mraa_spi_init_raw(unsigned int bus, unsigned int cs)
         goto init_raw_cleanup;
     }
 
+    dev->max_xfer = mraa_spi_read_bufsiz();
+
     int speed = 0;
     if (ioctl(dev->devfd, SPI_IOC_RD_MAX_SPEED_HZ, &speed) != -1) {
         dev->clock = speed;
@@ -263,13 +479,22 @@ mraa_spi_lsbmode(mraa_spi_context dev, mraa_boolean_t lsb)
     }
 
     uint8_t lsb_mode = (uint8_t) lsb;
-    if (ioctl(dev->devfd, SPI_IOC_WR_LSB_FIRST, &lsb_mode) < 0) {
-        syslog(LOG_ERR, "spi: Failed to set bit order");
-        return MRAA_ERROR_INVALID_RESOURCE;
-    }
-    if (ioctl(dev->devfd, SPI_IOC_RD_LSB_FIRST, &lsb_mode) < 0) {
-        syslog(LOG_ERR, "spi: Failed to set bit order");
-        return MRAA_ERROR_INVALID_RESOURCE;
+    if (ioctl(dev->devfd, SPI_IOC_WR_LSB_FIRST, &lsb_mode) < 0 ||
+        ioctl(dev->devfd, SPI_IOC_RD_LSB_FIRST, &lsb_mode) < 0 || lsb_mode != (uint8_t) lsb) {
+        if (!lsb) {
+            syslog(LOG_ERR, "spi: Failed to set bit order");
+            return MRAA_ERROR_INVALID_RESOURCE;
+        }
+        // controller can't do it, keep it msb first and reverse bits ourselves
+        lsb_mode = 0;
+        if (ioctl(dev->devfd, SPI_IOC_WR_LSB_FIRST, &lsb_mode) < 0) {
+            syslog(LOG_ERR, "spi: Failed to set bit order");
+            return MRAA_ERROR_INVALID_RESOURCE;
+        }
+        syslog(LOG_NOTICE, "spi: lsb first not supported by controller, converting in software");
+        dev->soft_lsb = 1;
+    } else {
+        dev->soft_lsb = 0;
     }
     dev->lsb = lsb;
     return MRAA_SUCCESS;
@@ -288,9 +513,18 @@ mraa_spi_bit_per_word(mraa_spi_context dev, unsigned int bits)
     }
 
     if (ioctl(dev->devfd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0) {
-        syslog(LOG_ERR, "spi: Failed to set bit per word");
-        return MRAA_ERROR_INVALID_RESOURCE;
+        unsigned int byte_bits = 8;
+        if (bits != 16 || ioctl(dev->devfd, SPI_IOC_WR_BITS_PER_WORD, &byte_bits) < 0) {
+            syslog(LOG_ERR, "spi: Failed to set bit per word");
+            return MRAA_ERROR_INVALID_RESOURCE;
+        }
+        // send 16 bit words as byte pairs in wire order instead
+        syslog(LOG_NOTICE, "spi: 16 bit words not supported by controller, converting in software");
+        dev->soft_word16 = 1;
+        dev->bpw = byte_bits;
+        return MRAA_SUCCESS;
     }
+    dev->soft_word16 = 0;
     dev->bpw = bits;
     return MRAA_SUCCESS;
 }
@@ -307,20 +541,8 @@ mraa_spi_write(mraa_spi_context dev, uint8_t data)
         return dev->advance_func->spi_write_replace(dev, data);
     }
 
-    struct spi_ioc_transfer msg;
-    memset(&msg, 0, sizeof(msg));
-
-    uint16_t length = 1;
-
-    unsigned long recv = 0;
-    msg.tx_buf = (unsigned long) &data;
-    msg.rx_buf = (unsigned long) &recv;
-    msg.speed_hz = dev->clock;
-    msg.bits_per_word = dev->bpw;
-    msg.delay_usecs = 0;
-    msg.len = length;
-    if (ioctl(dev->devfd, SPI_IOC_MESSAGE(1), &msg) < 0) {
-        syslog(LOG_ERR, "spi: Failed to perform dev transfer");
+    uint8_t recv = 0;
+    if (mraa_spi_transfer_chunked(dev, &data, &recv, 1) != MRAA_SUCCESS) {
         return -1;
     }
     return (int) recv;
@@ -338,20 +560,8 @@ mraa_spi_write_word(mraa_spi_context dev, uint16_t data)
         return dev->advance_func->spi_write_word_replace(dev, data);
     }
 
-    struct spi_ioc_transfer msg;
-    memset(&msg, 0, sizeof(msg));
-
-    uint16_t length = 2;
-
     uint16_t recv = 0;
-    msg.tx_buf = (unsigned long) &data;
-    msg.rx_buf = (unsigned long) &recv;
-    msg.speed_hz = dev->clock;
-    msg.bits_per_word = dev->bpw;
-    msg.delay_usecs = 0;
-    msg.len = length;
-    if (ioctl(dev->devfd, SPI_IOC_MESSAGE(1), &msg) < 0) {
-        syslog(LOG_ERR, "spi: Failed to perform dev transfer");
+    if (mraa_spi_transfer_chunked(dev, (uint8_t*) &data, (uint8_t*) &recv, 2) != MRAA_SUCCESS) {
         return -1;
     }
     return (int) recv;
@@ -369,20 +579,7 @@ mraa_spi_transfer_buf(mraa_spi_context dev, uint8_t* data, uint8_t* rxbuf, int l
         return dev->advance_func->spi_transfer_buf_replace(dev, data, rxbuf, length);
     }
 
-    struct spi_ioc_transfer msg;
-    memset(&msg, 0, sizeof(msg));
-
-    msg.tx_buf = (unsigned long) data;
-    msg.rx_buf = (unsigned long) rxbuf;
-    msg.speed_hz = dev->clock;
-    msg.bits_per_word = dev->bpw;
-    msg.delay_usecs = 0;
-    msg.len = length;
-    if (ioctl(dev->devfd, SPI_IOC_MESSAGE(1), &msg) < 0) {
-        syslog(LOG_ERR, "spi: Failed to perform dev transfer");
-        return MRAA_ERROR_INVALID_RESOURCE;
-    }
-    return MRAA_SUCCESS;
+    return mraa_spi_transfer_chunked(dev, data, rxbuf, length);
 }
 
 mraa_result_t
@@ -397,20 +594,7 @@ mraa_spi_transfer_buf_word(mraa_spi_context dev, uint16_t* data, uint16_t* rxbuf
         return dev->advance_func->spi_transfer_buf_word_replace(dev, data, rxbuf, length);
     }
 
-    struct spi_ioc_transfer msg;
-    memset(&msg, 0, sizeof(msg));
-
-    msg.tx_buf = (unsigned long) data;
-    msg.rx_buf = (unsigned long) rxbuf;
-    msg.speed_hz = dev->clock;
-    msg.bits_per_word = dev->bpw;
-    msg.delay_usecs = 0;
-    msg.len = length;
-    if (ioctl(dev->devfd, SPI_IOC_MESSAGE(1), &msg) < 0) {
-        syslog(LOG_ERR, "spi: Failed to perform dev transfer");
-        return MRAA_ERROR_INVALID_RESOURCE;
-    }
-    return MRAA_SUCCESS;
+    return mraa_spi_transfer_chunked(dev, (uint8_t*) data, (uint8_t*) rxbuf, length);
 }
 
 uint8_t*
@@ -455,6 +639,12 @@ mraa_spi_stop(mraa_spi_context dev)
         return MRAA_ERROR_INVALID_HANDLE;
     }
 
+    if (dev->stream != NULL) {
+        mraa_spi_stream_stop(dev);
+    }
+    free(dev->soft_buf);
+    dev->soft_buf = NULL;
+
     if (IS_FUNC_DEFINED(dev, spi_stop_replace)) {
         return dev->advance_func->spi_stop_replace(dev);
     }
@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "spi.h"
+#include "mraa_internal.h"
+
+#define NSEC_PER_SEC 1000000000LL
+// largest ring, keeps the power of two rounding and the ring size in range
+#define SPI_STREAM_MAX_DEPTH (1u << 20)
+
+/**
+ * Streaming acquisition state. The ring is single producer (the stream
+ * thread) single consumer (mraa_spi_stream_read), head and tail are only
+ * ever advanced by their owner so no lock is needed. The statistics are
+ * read by other threads and are guarded by lock.
+ */
+struct _spi_stream {
+    mraa_spi_context spi;
+    uint8_t* txbuf;           /**< copy of the buffer sent every transfer */
+    int length;               /**< bytes per transfer */
+    long long period_ns;      /**< timer period, 0 when gpio triggered */
+    mraa_gpio_context drdy;   /**< data ready gpio, NULL when timer driven */
+    int drdy_fd;              /**< edge descriptor of drdy */
+    short drdy_events;        /**< poll events of drdy_fd */
+    int timer_fd;             /**< periodic timer, -1 when gpio triggered */
+    int control_pipe[2];      /**< closed to wake the thread up for exit */
+    volatile int terminating;
+    pthread_t thread_id;
+
+    uint8_t* ring;            /**< depth slots of length bytes plus a scratch slot */
+    mraa_timestamp_t* stamps; /**< timestamp of each slot */
+    unsigned int depth;       /**< slot count, a power of two */
+    unsigned int head;        /**< next slot written by the thread */
+    unsigned int tail;        /**< next slot read by the consumer */
+
+    pthread_mutex_t lock;     /**< guards the statistics below */
+    unsigned long long transfers;
+    unsigned long long overruns;
+    unsigned long long missed;
+    unsigned long long errors;
+    long long max_lateness_ns;
+    long long sum_lateness_ns;
+    unsigned long long lateness_samples;
+};
+
+static long long
+mraa_spi_stream_now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static void
+mraa_spi_stream_capture(struct _spi_stream* stream)
+{
+    unsigned int head = stream->head;
+    unsigned int tail = __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail >= stream->depth) {
+        // consumer is behind, keep what it has not read yet and drop this one
+        uint8_t* scratch = stream->ring + (size_t) stream->depth * stream->length;
+        mraa_result_t ret = mraa_spi_transfer_buf(stream->spi, stream->txbuf, scratch, stream->length);
+        pthread_mutex_lock(&stream->lock);
+        if (ret != MRAA_SUCCESS) {
+            stream->errors++;
+        }
+        stream->overruns++;
+        pthread_mutex_unlock(&stream->lock);
+        return;
+    }
+
+    unsigned int slot = head & (stream->depth - 1);
+    stream->stamps[slot] = (mraa_timestamp_t) mraa_spi_stream_now();
+    mraa_result_t ret = mraa_spi_transfer_buf(stream->spi, stream->txbuf,
+                                              stream->ring + (size_t) slot * stream->length, stream->length);
+    pthread_mutex_lock(&stream->lock);
+    if (ret != MRAA_SUCCESS) {
+        stream->errors++;
+    } else {
+        stream->transfers++;
+    }
+    pthread_mutex_unlock(&stream->lock);
+    if (ret == MRAA_SUCCESS) {
+        __atomic_store_n(&stream->head, head + 1, __ATOMIC_RELEASE);
+    }
+}
+
+static void
+mraa_spi_stream_lateness(struct _spi_stream* stream, long long lateness, unsigned long long missed)
+{
+    pthread_mutex_lock(&stream->lock);
+    if (lateness > stream->max_lateness_ns) {
+        stream->max_lateness_ns = lateness;
+    }
+    stream->sum_lateness_ns += lateness;
+    stream->lateness_samples++;
+    stream->missed += missed;
+    pthread_mutex_unlock(&stream->lock);
+}
+
+static void*
+mraa_spi_stream_timer_handler(void* arg)
+{
+    struct _spi_stream* stream = (struct _spi_stream*) arg;
+    struct pollfd pfd[2];
+    struct itimerspec its;
+
+    pfd[0].fd = stream->timer_fd;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = stream->control_pipe[0];
+    pfd[1].events = POLLIN;
+
+    long long deadline = mraa_spi_stream_now() + stream->period_ns;
+    its.it_value.tv_sec = deadline / NSEC_PER_SEC;
+    its.it_value.tv_nsec = deadline % NSEC_PER_SEC;
+    its.it_interval.tv_sec = stream->period_ns / NSEC_PER_SEC;
+    its.it_interval.tv_nsec = stream->period_ns % NSEC_PER_SEC;
+    if (timerfd_settime(stream->timer_fd, TFD_TIMER_ABSTIME, &its, NULL) != 0) {
+        syslog(LOG_ERR, "spi: stream: failed to set timer: %s", strerror(errno));
+        return NULL;
+    }
+
+    while (!stream->terminating) {
+        if (poll(pfd, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            syslog(LOG_ERR, "spi: stream: poll failed: %s", strerror(errno));
+            break;
+        }
+        if (stream->terminating || pfd[1].revents) {
+            break;
+        }
+
+        uint64_t expirations;
+        if (!(pfd[0].revents & POLLIN) ||
+            read(stream->timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+            continue;
+        }
+
+        // we ran over one or more periods, count them rather than burst
+        deadline += (long long) (expirations - 1) * stream->period_ns;
+        mraa_spi_stream_lateness(stream, mraa_spi_stream_now() - deadline, expirations - 1);
+        mraa_spi_stream_capture(stream);
+        deadline += stream->period_ns;
+    }
+
+    return NULL;
+}
+
+static void*
+mraa_spi_stream_gpio_handler(void* arg)
+{
+    struct _spi_stream* stream = (struct _spi_stream*) arg;
+    struct pollfd pfd[2];
+
+    pfd[0].fd = stream->drdy_fd;
+    pfd[0].events = stream->drdy_events;
+    pfd[1].fd = stream->control_pipe[0];
+    pfd[1].events = POLLIN;
+
+    while (!stream->terminating) {
+        if (poll(pfd, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            syslog(LOG_ERR, "spi: stream: poll failed: %s", strerror(errno));
+            break;
+        }
+        if (stream->terminating || pfd[1].revents) {
+            break;
+        }
+        if (pfd[0].revents & stream->drdy_events) {
+            mraa_gpio_event_fd_ack(stream->drdy_fd, stream->drdy_events);
+            mraa_spi_stream_capture(stream);
+        }
+    }
+
+    return NULL;
+}
+
+static void
+mraa_spi_stream_free(struct _spi_stream* stream)
+{
+    if (stream->drdy_fd >= 0) {
+        close(stream->drdy_fd);
+    }
+    if (stream->timer_fd >= 0) {
+        close(stream->timer_fd);
+    }
+    if (stream->control_pipe[0] >= 0) {
+        close(stream->control_pipe[0]);
+    }
+    if (stream->control_pipe[1] >= 0) {
+        close(stream->control_pipe[1]);
+    }
+    free(stream->txbuf);
+    free(stream->ring);
+    free(stream->stamps);
+    pthread_mutex_destroy(&stream->lock);
+    free(stream);
+}
+
+static struct _spi_stream*
+mraa_spi_stream_alloc(mraa_spi_context dev, const uint8_t* data, int length, unsigned int depth)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "spi: stream: context is invalid");
+        return NULL;
+    }
+    if (dev->stream != NULL) {
+        syslog(LOG_ERR, "spi: stream: already running");
+        return NULL;
+    }
+    if (data == NULL || length <= 0 || depth == 0) {
+        syslog(LOG_ERR, "spi: stream: invalid parameters");
+        return NULL;
+    }
+    if (depth > SPI_STREAM_MAX_DEPTH) {
+        syslog(LOG_ERR, "spi: stream: depth %u above %u", depth, SPI_STREAM_MAX_DEPTH);
+        return NULL;
+    }
+
+    struct _spi_stream* stream = calloc(1, sizeof(struct _spi_stream));
+    if (stream == NULL) {
+        syslog(LOG_CRIT, "spi: stream: Failed to allocate memory for context");
+        return NULL;
+    }
+    stream->spi = dev;
+    stream->length = length;
+    stream->drdy_fd = -1;
+    stream->timer_fd = -1;
+    stream->control_pipe[0] = stream->control_pipe[1] = -1;
+    pthread_mutex_init(&stream->lock, NULL);
+
+    // round up so slots can be found with a mask, documented in spi.h
+    stream->depth = 1;
+    while (stream->depth < depth) {
+        stream->depth <<= 1;
+    }
+    if ((size_t) length > SIZE_MAX / (stream->depth + 1)) {
+        syslog(LOG_ERR, "spi: stream: ring of %u transfers of %d bytes is too large", stream->depth, length);
+        mraa_spi_stream_free(stream);
+        return NULL;
+    }
+
+    stream->txbuf = malloc(length);
+    stream->ring = malloc((size_t) (stream->depth + 1) * length);
+    stream->stamps = calloc(stream->depth, sizeof(mraa_timestamp_t));
+    if (stream->txbuf == NULL || stream->ring == NULL || stream->stamps == NULL) {
+        syslog(LOG_CRIT, "spi: stream: Failed to allocate memory for ring");
+        mraa_spi_stream_free(stream);
+        return NULL;
+    }
+    memcpy(stream->txbuf, data, length);
+
+    return stream;
+}
+
+static mraa_result_t
+mraa_spi_stream_launch(mraa_spi_context dev, struct _spi_stream* stream, void* (*handler)(void*))
+{
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+
+    if (dev->stream_priority > 0) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = dev->stream_priority;
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+    }
+
+    int ret = pthread_create(&stream->thread_id, &attr, handler, (void*) stream);
+    if (ret == EPERM && dev->stream_priority > 0) {
+        syslog(LOG_WARNING, "spi: stream: not permitted to use SCHED_FIFO, using default scheduling");
+        ret = pthread_create(&stream->thread_id, NULL, handler, (void*) stream);
+    }
+    pthread_attr_destroy(&attr);
+
+    if (ret != 0) {
+        syslog(LOG_ERR, "spi: stream: failed to create thread: %s", strerror(ret));
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+
+#ifdef CPU_SET
+    if (dev->stream_cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(dev->stream_cpu, &cpus);
+        if (pthread_setaffinity_np(stream->thread_id, sizeof(cpus), &cpus) != 0) {
+            syslog(LOG_WARNING, "spi: stream: failed to pin thread to cpu %d", dev->stream_cpu);
+        }
+    }
+#endif
+
+    dev->stream = stream;
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_spi_stream_sched(mraa_spi_context dev, int priority, int cpu)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "spi: stream_sched: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (priority < 0 || priority > sched_get_priority_max(SCHED_FIFO)) {
+        syslog(LOG_ERR, "spi: stream_sched: invalid priority %d", priority);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    dev->stream_priority = priority;
+    dev->stream_cpu = cpu;
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_spi_stream_start(mraa_spi_context dev, const uint8_t* data, int length, unsigned int period_us, unsigned int depth)
+{
+    if (period_us == 0) {
+        syslog(LOG_ERR, "spi: stream_start: period cannot be zero");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    struct _spi_stream* stream = mraa_spi_stream_alloc(dev, data, length, depth);
+    if (stream == NULL) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    stream->period_ns = (long long) period_us * 1000;
+
+    stream->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (stream->timer_fd < 0 || pipe(stream->control_pipe) != 0) {
+        syslog(LOG_ERR, "spi: stream_start: failed to create timer: %s", strerror(errno));
+        mraa_spi_stream_free(stream);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+
+    mraa_result_t ret = mraa_spi_stream_launch(dev, stream, mraa_spi_stream_timer_handler);
+    if (ret != MRAA_SUCCESS) {
+        mraa_spi_stream_free(stream);
+    }
+    return ret;
+}
+
+mraa_result_t
+mraa_spi_stream_start_gpio(mraa_spi_context dev, const uint8_t* data, int length, mraa_gpio_context drdy, mraa_gpio_edge_t edge, unsigned int depth)
+{
+    if (drdy == NULL || edge == MRAA_GPIO_EDGE_NONE) {
+        syslog(LOG_ERR, "spi: stream_start_gpio: invalid data ready gpio");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    struct _spi_stream* stream = mraa_spi_stream_alloc(dev, data, length, depth);
+    if (stream == NULL) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    mraa_result_t ret = mraa_gpio_edge_mode(drdy, edge);
+    if (ret != MRAA_SUCCESS) {
+        mraa_spi_stream_free(stream);
+        return ret;
+    }
+
+    stream->drdy = drdy;
+    stream->drdy_fd = mraa_gpio_event_fd_open(drdy, &stream->drdy_events);
+    if (stream->drdy_fd < 0 || pipe(stream->control_pipe) != 0) {
+        syslog(LOG_ERR, "spi: stream_start_gpio: failed to set up data ready wait");
+        mraa_spi_stream_free(stream);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    ret = mraa_spi_stream_launch(dev, stream, mraa_spi_stream_gpio_handler);
+    if (ret != MRAA_SUCCESS) {
+        mraa_spi_stream_free(stream);
+    }
+    return ret;
+}
+
+int
+mraa_spi_stream_read(mraa_spi_context dev, uint8_t* rxbuf, mraa_timestamp_t* timestamps, int count)
+{
+    if (dev == NULL || dev->stream == NULL) {
+        syslog(LOG_ERR, "spi: stream_read: no stream running");
+        return -1;
+    }
+    if (rxbuf == NULL || count < 0) {
+        syslog(LOG_ERR, "spi: stream_read: invalid parameters");
+        return -1;
+    }
+
+    struct _spi_stream* stream = dev->stream;
+    unsigned int tail = stream->tail;
+    unsigned int head = __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE);
+    unsigned int avail = head - tail;
+    if (avail > (unsigned int) count) {
+        avail = count;
+    }
+
+    for (unsigned int i = 0; i < avail; i++) {
+        unsigned int slot = (tail + i) & (stream->depth - 1);
+        memcpy(rxbuf + (size_t) i * stream->length, stream->ring + (size_t) slot * stream->length,
+               stream->length);
+        if (timestamps != NULL) {
+            timestamps[i] = stream->stamps[slot];
+        }
+    }
+    __atomic_store_n(&stream->tail, tail + avail, __ATOMIC_RELEASE);
+
+    return (int) avail;
+}
+
+mraa_result_t
+mraa_spi_stream_get_stats(mraa_spi_context dev, mraa_spi_stream_stats_t* stats)
+{
+    if (dev == NULL || dev->stream == NULL || stats == NULL) {
+        syslog(LOG_ERR, "spi: stream_get_stats: no stream running");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    struct _spi_stream* stream = dev->stream;
+    pthread_mutex_lock(&stream->lock);
+    stats->transfers = stream->transfers;
+    stats->overruns = stream->overruns;
+    stats->missed = stream->missed;
+    stats->errors = stream->errors;
+    stats->max_lateness_ns = stream->max_lateness_ns;
+    stats->mean_lateness_ns =
+    stream->lateness_samples > 0 ? stream->sum_lateness_ns / (long long) stream->lateness_samples : 0;
+    pthread_mutex_unlock(&stream->lock);
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_spi_stream_stop(mraa_spi_context dev)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "spi: stream_stop: context is invalid");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (dev->stream == NULL) {
+        return MRAA_SUCCESS;
+    }
+
+    struct _spi_stream* stream = dev->stream;
+    mraa_result_t ret = MRAA_SUCCESS;
+
+    stream->terminating = 1;
+    if (stream->control_pipe[1] >= 0) {
+        close(stream->control_pipe[1]);
+        stream->control_pipe[1] = -1;
+    }
+    if (pthread_join(stream->thread_id, NULL) != 0) {
+        ret = MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    if (stream->drdy != NULL) {
+        mraa_gpio_edge_mode(stream->drdy, MRAA_GPIO_EDGE_NONE);
+    }
+    dev->stream = NULL;
+    mraa_spi_stream_free(stream);
+    return ret;
+}
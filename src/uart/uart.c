@@ -8,12 +8,17 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <limits.h>
 #include <stdlib.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <string.h>
 #include <termios.h>
-#include <sys/select.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#if defined(__linux__)
+#include <linux/serial.h>
+#endif
 #include <errno.h>
 #include <string.h>
 
@@ -24,6 +29,13 @@
 #define CMSPAR   010000000000
 #endif
 
+/* read settings replaced by mraa_uart_set_low_latency, put back on disable */
+struct _uart_latency {
+    tcflag_t lflag;
+    cc_t vmin;
+    cc_t vtime;
+};
+
 // This function takes an unsigned int and converts it to a B* speed_t
 // that can be used with linux/posix termios
 static speed_t
@@ -114,6 +126,7 @@ static unsigned int speed_to_uint(speed_t speedt) {
         { B1200, 1200 },
         { B1800, 1800 },
         { B2400, 2400 },
+        { B4800, 4800 },
         { B9600, 9600 },
         { B19200, 19200 },
         { B38400, 38400 },
@@ -323,6 +336,13 @@ mraa_uart_stop(mraa_uart_context dev)
         return MRAA_ERROR_INVALID_HANDLE;
     }
 
+    if (dev->async != NULL) {
+        mraa_uart_async_stop(dev);
+    }
+    mraa_uart_writer_stop(dev);
+    mraa_uart_rs485_stop(dev);
+    free(dev->latency);
+
     // just close the device and reset our fd.
     if (dev->fd >= 0) {
         close(dev->fd);
@@ -412,6 +432,12 @@ mraa_uart_settings(int index, const char **devpath, const char **name, int* baud
 
        if (baudrate != NULL) {
            *baudrate = speed_to_uint(cfgetospeed(&term));
+           if (*baudrate == 0) {
+               unsigned int other = 0;
+               if (mraa_uart_termios2_get_speed(fd, &other) == MRAA_SUCCESS) {
+                   *baudrate = (int) other;
+               }
+           }
        }
 
        if (ctsrts != NULL) {
@@ -435,6 +461,13 @@ mraa_uart_flush(mraa_uart_context dev)
         return MRAA_ERROR_INVALID_HANDLE;
     }
 
+    if (dev->writer != NULL) {
+        mraa_result_t ret = mraa_uart_writer_drain(dev);
+        if (ret != MRAA_SUCCESS) {
+            return ret;
+        }
+    }
+
     if (IS_FUNC_DEFINED(dev, uart_flush_replace)) {
         return dev->advance_func->uart_flush_replace(dev);
     }
@@ -478,21 +511,35 @@ mraa_uart_set_baudrate(mraa_uart_context dev, unsigned int baud)
     }
 
     if (IS_FUNC_DEFINED(dev, uart_set_baudrate_replace)) {
-        return dev->advance_func->uart_set_baudrate_replace(dev, baud);
+        mraa_result_t ret = dev->advance_func->uart_set_baudrate_replace(dev, baud);
+        if (ret == MRAA_SUCCESS) {
+            dev->baudrate = baud;
+        }
+        return ret;
     }
 
-    struct termios termio;
-    if (tcgetattr(dev->fd, &termio)) {
-        syslog(LOG_ERR, "uart%i: set_baudrate: tcgetattr() failed: %s", dev->index, strerror(errno));
-        return MRAA_ERROR_INVALID_RESOURCE;
+    if (baud == 0) {
+        syslog(LOG_ERR, "uart%i: set_baudrate: invalid baudrate: %i", dev->index, baud);
+        return MRAA_ERROR_INVALID_PARAMETER;
     }
 
     // set our baud rates
     speed_t speed = uint2speed(baud);
-    if (speed == B0)
-    {
-        syslog(LOG_ERR, "uart%i: set_baudrate: invalid baudrate: %i", dev->index, baud);
-        return MRAA_ERROR_INVALID_PARAMETER;
+    if (speed == B0) {
+        // not one of the Bxxx constants, ask the driver for the exact rate
+        mraa_result_t ret = mraa_uart_termios2_set_speed(dev->fd, baud);
+        if (ret != MRAA_SUCCESS) {
+            syslog(LOG_ERR, "uart%i: set_baudrate: unsupported baudrate: %i", dev->index, baud);
+            return ret == MRAA_ERROR_FEATURE_NOT_SUPPORTED ? MRAA_ERROR_INVALID_PARAMETER : ret;
+        }
+        dev->baudrate = baud;
+        return MRAA_SUCCESS;
+    }
+
+    struct termios termio;
+    if (tcgetattr(dev->fd, &termio)) {
+        syslog(LOG_ERR, "uart%i: set_baudrate: tcgetattr() failed: %s", dev->index, strerror(errno));
+        return MRAA_ERROR_INVALID_RESOURCE;
     }
     cfsetispeed(&termio, speed);
     cfsetospeed(&termio, speed);
@@ -502,6 +549,112 @@ mraa_uart_set_baudrate(mraa_uart_context dev, unsigned int baud)
         syslog(LOG_ERR, "uart%i: set_baudrate: tcsetattr() failed: %s", dev->index, strerror(errno));
         return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
     }
+    dev->baudrate = baud;
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_uart_get_baudrate(mraa_uart_context dev, unsigned int* baud)
+{
+    if (!dev || !baud) {
+        syslog(LOG_ERR, "uart: get_baudrate: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    if (dev->fd < 0) {
+        // ports run by platform hooks can only report what was asked for
+        *baud = dev->baudrate;
+        return MRAA_SUCCESS;
+    }
+
+    if (mraa_uart_termios2_get_speed(dev->fd, baud) == MRAA_SUCCESS && *baud != 0) {
+        return MRAA_SUCCESS;
+    }
+
+    struct termios termio;
+    if (tcgetattr(dev->fd, &termio)) {
+        syslog(LOG_ERR, "uart%i: get_baudrate: tcgetattr() failed: %s", dev->index, strerror(errno));
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    *baud = speed_to_uint(cfgetospeed(&termio));
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_uart_set_low_latency(mraa_uart_context dev, mraa_boolean_t enable)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "uart: set_low_latency: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    if (dev->fd < 0) {
+        syslog(LOG_ERR, "uart%i: set_low_latency: port is not open", dev->index);
+        return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+    }
+
+#if defined(TIOCGSERIAL) && defined(ASYNC_LOW_LATENCY)
+    struct serial_struct serial;
+    if (ioctl(dev->fd, TIOCGSERIAL, &serial) == 0) {
+        if (enable) {
+            serial.flags |= ASYNC_LOW_LATENCY;
+        } else {
+            serial.flags &= ~ASYNC_LOW_LATENCY;
+        }
+        if (ioctl(dev->fd, TIOCSSERIAL, &serial) != 0) {
+            syslog(LOG_NOTICE, "uart%i: set_low_latency: TIOCSSERIAL failed: %s", dev->index, strerror(errno));
+        }
+    } else {
+        // usb adapters and ptys have no serial_struct, termios tuning still applies
+        syslog(LOG_NOTICE, "uart%i: set_low_latency: driver has no TIOCGSERIAL", dev->index);
+    }
+#endif
+
+    if (!enable && dev->latency == NULL) {
+        return MRAA_SUCCESS;
+    }
+
+    struct termios termio;
+    if (tcgetattr(dev->fd, &termio)) {
+        syslog(LOG_ERR, "uart%i: set_low_latency: tcgetattr() failed: %s", dev->index, strerror(errno));
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    struct _uart_latency* saved = dev->latency;
+    if (!enable) {
+        termio.c_lflag = (termio.c_lflag & ~ICANON) | (saved->lflag & ICANON);
+        termio.c_cc[VMIN] = saved->vmin;
+        termio.c_cc[VTIME] = saved->vtime;
+    } else {
+        if (saved == NULL) {
+            saved = calloc(1, sizeof(struct _uart_latency));
+            if (saved == NULL) {
+                syslog(LOG_CRIT, "uart%i: set_low_latency: Failed to allocate memory for saved termios", dev->index);
+                return MRAA_ERROR_NO_RESOURCES;
+            }
+            // only the first enable sees the settings to go back to
+            saved->lflag = termio.c_lflag;
+            saved->vmin = termio.c_cc[VMIN];
+            saved->vtime = termio.c_cc[VTIME];
+        }
+        // return from read() as soon as a single byte is there
+        termio.c_lflag &= ~ICANON;
+        termio.c_cc[VMIN] = 1;
+        termio.c_cc[VTIME] = 0;
+    }
+    if (tcsetattr(dev->fd, TCSANOW, &termio) < 0) {
+        syslog(LOG_ERR, "uart%i: set_low_latency: tcsetattr() failed: %s", dev->index, strerror(errno));
+        if (saved != dev->latency) {
+            free(saved);
+        }
+        return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+    }
+
+    if (!enable) {
+        free(saved);
+        saved = NULL;
+    }
+    dev->latency = saved;
     return MRAA_SUCCESS;
 }
 
@@ -733,6 +886,11 @@ mraa_uart_read(mraa_uart_context dev, char* buf, size_t len)
         return MRAA_ERROR_INVALID_HANDLE;
     }
 
+    if (dev->async != NULL) {
+        syslog(LOG_ERR, "uart%i: read: port is owned by the async reader", dev->index);
+        return -1;
+    }
+
     if (IS_FUNC_DEFINED(dev, uart_read_replace)) {
         return dev->advance_func->uart_read_replace(dev, buf, len);
     }
@@ -753,6 +911,14 @@ mraa_uart_write(mraa_uart_context dev, const char* buf, size_t len)
         return MRAA_ERROR_INVALID_HANDLE;
     }
 
+    if (dev->writer != NULL) {
+        return mraa_uart_writer_write(dev, buf, len);
+    }
+
+    if (dev->rs485 != NULL && mraa_uart_get_rs485_mode(dev) == MRAA_UART_RS485_GPIO) {
+        return mraa_uart_rs485_write(dev, buf, len);
+    }
+
     if (IS_FUNC_DEFINED(dev, uart_write_replace)) {
         return dev->advance_func->uart_write_replace(dev, buf, len);
     }
@@ -782,29 +948,21 @@ mraa_uart_data_available(mraa_uart_context dev, unsigned int millis)
         return 0;
     }
 
-    struct timeval timeout;
-
-    if (millis == 0) {
-        // no waiting
-        timeout.tv_sec = 0;
-        timeout.tv_usec = 0;
-    } else {
-        timeout.tv_sec = millis / 1000;
-        timeout.tv_usec = (millis % 1000) * 1000;
-    }
+    // poll() rather than select(), which cannot take descriptors above FD_SETSIZE
+    struct pollfd pfd;
+    pfd.fd = dev->fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
 
-    fd_set readfds;
+    int timeout = millis > INT_MAX ? INT_MAX : (int) millis;
+    int ret;
+    do {
+        ret = poll(&pfd, 1, timeout);
+    } while (ret < 0 && errno == EINTR);
 
-#if !defined(PERIPHERALMAN)
-    FD_ZERO(&readfds);
-    FD_SET(dev->fd, &readfds);
-#endif
-
-    if (select(dev->fd + 1, &readfds, NULL, NULL, &timeout) > 0) {
+    if (ret > 0 && (pfd.revents & POLLIN)) {
         return 1; // data is ready
     } else {
         return 0;
     }
 }
-
-
@@ -0,0 +1,530 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "uart.h"
+#include "mraa_internal.h"
+
+#define UART_ASYNC_BATCH 16
+#define UART_ASYNC_STALL_MS 1
+
+#define SLIP_END 0xC0
+#define SLIP_ESC 0xDB
+#define SLIP_ESC_END 0xDC
+#define SLIP_ESC_ESC 0xDD
+
+/**
+ * Background reader state. The thread reads straight into the ring and is
+ * the only writer of head. Framing runs on the consumer side, either in the
+ * thread itself when a callback is installed or in mraa_uart_async_pop(),
+ * and only the consumer moves cursor, scan and tail. Frames are handed out
+ * as pointers into the ring, decoded in place, and only a frame that wraps
+ * around the end of the ring is copied to the scratch buffer.
+ */
+struct _uart_async {
+    mraa_uart_context uart;
+    mraa_uart_framing_t framing;
+    unsigned int option;      /**< delimiter byte or length prefix width */
+    mraa_uart_frame_cb cb;
+    void* args;
+    int control_pipe[2];      /**< closed to wake the thread up for exit */
+    volatile int terminating;
+    pthread_t thread_id;
+
+    uint8_t* ring;
+    uint8_t* scratch;         /**< linearised copy of a wrapped frame */
+    size_t size;              /**< ring bytes, a power of two */
+    size_t head;              /**< bytes written by the thread */
+    size_t tail;              /**< bytes released by the consumer */
+    size_t cursor;            /**< start of the next unparsed frame */
+    size_t scan;              /**< delimiter search resumes here */
+    size_t discard;           /**< bytes of an oversized length prefixed frame left to drop */
+    int resync;               /**< dropping bytes up to the next delimiter */
+
+    // statistics, updated and read with __atomic builtins
+    unsigned long long bytes;
+    unsigned long long frames;
+    unsigned long long errors;
+    unsigned long long stalls;
+};
+
+static uint8_t
+mraa_uart_async_at(struct _uart_async* async, size_t pos)
+{
+    return async->ring[pos & (async->size - 1)];
+}
+
+/* Pointer to len bytes starting at pos, contiguous unless the range wraps */
+static uint8_t*
+mraa_uart_async_linear(struct _uart_async* async, size_t pos, size_t len)
+{
+    size_t off = pos & (async->size - 1);
+    if (off + len <= async->size) {
+        return async->ring + off;
+    }
+    size_t first = async->size - off;
+    memcpy(async->scratch, async->ring + off, first);
+    memcpy(async->scratch + first, async->ring, len - first);
+    return async->scratch;
+}
+
+/* Find the first delimiter in [from, to), returns to when there is none */
+static size_t
+mraa_uart_async_find(struct _uart_async* async, size_t from, size_t to, uint8_t delim)
+{
+    while (from < to) {
+        size_t off = from & (async->size - 1);
+        size_t len = to - from;
+        if (off + len > async->size) {
+            len = async->size - off;
+        }
+        // memchr is the vectorised scanner of the C library
+        const uint8_t* hit = memchr(async->ring + off, delim, len);
+        if (hit != NULL) {
+            return from + (size_t) (hit - (async->ring + off));
+        }
+        from += len;
+    }
+    return to;
+}
+
+static int
+mraa_uart_async_cobs_decode(uint8_t* buf, int len)
+{
+    int in = 0;
+    int out = 0;
+
+    while (in < len) {
+        int code = buf[in++];
+        if (code == 0 || in + code - 1 > len) {
+            return -1;
+        }
+        for (int i = 1; i < code; i++) {
+            buf[out++] = buf[in++];
+        }
+        if (code < 0xFF && in < len) {
+            buf[out++] = 0;
+        }
+    }
+    return out;
+}
+
+static int
+mraa_uart_async_slip_decode(uint8_t* buf, int len)
+{
+    int out = 0;
+
+    for (int in = 0; in < len; in++) {
+        uint8_t c = buf[in];
+        if (c == SLIP_ESC) {
+            if (++in >= len) {
+                return -1;
+            }
+            if (buf[in] == SLIP_ESC_END) {
+                c = SLIP_END;
+            } else if (buf[in] == SLIP_ESC_ESC) {
+                c = SLIP_ESC;
+            } else {
+                return -1;
+            }
+        }
+        buf[out++] = c;
+    }
+    return out;
+}
+
+/**
+ * Parse the next complete frame out of [cursor, head). Returns 1 and fills
+ * frame when one is found, 0 when more data is needed.
+ */
+static int
+mraa_uart_async_next(struct _uart_async* async, size_t head, mraa_uart_frame_t* frame)
+{
+    for (;;) {
+        size_t avail = head - async->cursor;
+        if (avail == 0) {
+            return 0;
+        }
+
+        if (async->discard > 0) {
+            size_t drop = avail < async->discard ? avail : async->discard;
+            async->cursor += drop;
+            async->discard -= drop;
+            continue;
+        }
+
+        if (async->framing == MRAA_UART_FRAME_RAW) {
+            size_t off = async->cursor & (async->size - 1);
+            size_t len = avail < async->size - off ? avail : async->size - off;
+            frame->data = async->ring + off;
+            frame->length = (int) len;
+            async->cursor += len;
+            __atomic_add_fetch(&async->frames, 1, __ATOMIC_RELAXED);
+            return 1;
+        }
+
+        if (async->framing == MRAA_UART_FRAME_LENGTH) {
+            size_t width = async->option;
+            if (avail < width) {
+                return 0;
+            }
+            size_t len = 0;
+            for (size_t i = 0; i < width; i++) {
+                len = (len << 8) | mraa_uart_async_at(async, async->cursor + i);
+            }
+            if (width + len > async->size) {
+                // can never fit, drop it and hope the stream realigns
+                __atomic_add_fetch(&async->errors, 1, __ATOMIC_RELAXED);
+                async->cursor += width;
+                async->discard = len;
+                continue;
+            }
+            if (avail < width + len) {
+                return 0;
+            }
+            frame->data = mraa_uart_async_linear(async, async->cursor + width, len);
+            frame->length = (int) len;
+            async->cursor += width + len;
+            if (len == 0) {
+                continue;
+            }
+            __atomic_add_fetch(&async->frames, 1, __ATOMIC_RELAXED);
+            return 1;
+        }
+
+        uint8_t delim = async->framing == MRAA_UART_FRAME_COBS ?
+                        0x00 :
+                        async->framing == MRAA_UART_FRAME_SLIP ? SLIP_END : (uint8_t) async->option;
+        size_t from = async->scan > async->cursor ? async->scan : async->cursor;
+        size_t end = mraa_uart_async_find(async, from, head, delim);
+        if (end == head) {
+            async->scan = head;
+            if (avail >= async->size) {
+                // a frame larger than the ring, throw it away up to the next delimiter
+                __atomic_add_fetch(&async->errors, 1, __ATOMIC_RELAXED);
+                async->cursor = head;
+                async->resync = 1;
+            }
+            return 0;
+        }
+
+        size_t start = async->cursor;
+        async->cursor = end + 1;
+        async->scan = async->cursor;
+        if (async->resync) {
+            async->resync = 0;
+            continue;
+        }
+
+        int len = (int) (end - start);
+        if (len == 0) {
+            continue;
+        }
+        uint8_t* data = mraa_uart_async_linear(async, start, len);
+        if (async->framing == MRAA_UART_FRAME_COBS) {
+            len = mraa_uart_async_cobs_decode(data, len);
+        } else if (async->framing == MRAA_UART_FRAME_SLIP) {
+            len = mraa_uart_async_slip_decode(data, len);
+        }
+        if (len < 0) {
+            __atomic_add_fetch(&async->errors, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (len == 0) {
+            continue;
+        }
+        frame->data = data;
+        frame->length = len;
+        __atomic_add_fetch(&async->frames, 1, __ATOMIC_RELAXED);
+        return 1;
+    }
+}
+
+static void
+mraa_uart_async_dispatch(struct _uart_async* async)
+{
+    mraa_uart_frame_t batch[UART_ASYNC_BATCH];
+    size_t head = async->head;
+
+    for (;;) {
+        int count = 0;
+        while (count < UART_ASYNC_BATCH && mraa_uart_async_next(async, head, &batch[count])) {
+            count++;
+        }
+        if (count > 0) {
+            async->cb(batch, count, async->args);
+        }
+        __atomic_store_n(&async->tail, async->cursor, __ATOMIC_RELEASE);
+        if (count < UART_ASYNC_BATCH) {
+            return;
+        }
+    }
+}
+
+static int
+mraa_uart_async_wait(struct _uart_async* async, mraa_boolean_t stalled)
+{
+    mraa_uart_context dev = async->uart;
+    struct pollfd pfd[2];
+
+    pfd[0].fd = async->control_pipe[0];
+    pfd[0].events = POLLIN;
+    if (stalled) {
+        // a full ring only waits for the consumer or the stop request
+        poll(pfd, 1, UART_ASYNC_STALL_MS);
+        return 0;
+    }
+
+    if (IS_FUNC_DEFINED(dev, uart_data_available_replace)) {
+        // no descriptor to wait on, let the platform decide
+        return dev->advance_func->uart_data_available_replace(dev, 10) ? 1 : 0;
+    }
+
+    pfd[1].fd = dev->fd;
+    pfd[1].events = POLLIN;
+    if (poll(pfd, 2, -1) < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    if (pfd[0].revents) {
+        return 0;
+    }
+    if (pfd[1].revents & (POLLERR | POLLNVAL)) {
+        return -1;
+    }
+    // POLLHUP with nothing left to read shows up as a zero length read
+    return (pfd[1].revents & (POLLIN | POLLHUP)) ? 1 : 0;
+}
+
+static void*
+mraa_uart_async_reader(void* arg)
+{
+    struct _uart_async* async = (struct _uart_async*) arg;
+    mraa_uart_context dev = async->uart;
+
+    while (!async->terminating) {
+        size_t head = async->head;
+        size_t used = head - __atomic_load_n(&async->tail, __ATOMIC_ACQUIRE);
+        if (used == async->size) {
+            __atomic_add_fetch(&async->stalls, 1, __ATOMIC_RELAXED);
+            mraa_uart_async_wait(async, 1);
+            continue;
+        }
+
+        int ready = mraa_uart_async_wait(async, 0);
+        if (ready < 0) {
+            syslog(LOG_ERR, "uart%i: async: wait failed: %s", dev->index, strerror(errno));
+            break;
+        }
+        if (ready == 0 || async->terminating) {
+            continue;
+        }
+
+        size_t off = head & (async->size - 1);
+        size_t len = async->size - used;
+        if (len > async->size - off) {
+            len = async->size - off;
+        }
+
+        int n;
+        if (IS_FUNC_DEFINED(dev, uart_read_replace)) {
+            n = dev->advance_func->uart_read_replace(dev, (char*) async->ring + off, len);
+        } else {
+            n = read(dev->fd, async->ring + off, len);
+        }
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            syslog(LOG_ERR, "uart%i: async: read failed: %s", dev->index, strerror(errno));
+            break;
+        }
+        if (n == 0) {
+            syslog(LOG_NOTICE, "uart%i: async: port hung up", dev->index);
+            break;
+        }
+
+        __atomic_add_fetch(&async->bytes, n, __ATOMIC_RELAXED);
+        __atomic_store_n(&async->head, head + n, __ATOMIC_RELEASE);
+        if (async->cb != NULL) {
+            mraa_uart_async_dispatch(async);
+        }
+    }
+
+    return NULL;
+}
+
+static void
+mraa_uart_async_free(struct _uart_async* async)
+{
+    if (async->control_pipe[0] >= 0) {
+        close(async->control_pipe[0]);
+    }
+    if (async->control_pipe[1] >= 0) {
+        close(async->control_pipe[1]);
+    }
+    free(async->ring);
+    free(async->scratch);
+    free(async);
+}
+
+mraa_result_t
+mraa_uart_async_start(mraa_uart_context dev, mraa_uart_framing_t framing, unsigned int option, unsigned int ring_size, mraa_uart_frame_cb cb, void* args)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "uart: async_start: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (dev->async != NULL) {
+        syslog(LOG_ERR, "uart%i: async_start: already running", dev->index);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    if (dev->fd < 0 && !IS_FUNC_DEFINED(dev, uart_read_replace)) {
+        syslog(LOG_ERR, "uart%i: async_start: port is not open", dev->index);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    switch (framing) {
+        case MRAA_UART_FRAME_RAW:
+        case MRAA_UART_FRAME_COBS:
+        case MRAA_UART_FRAME_SLIP:
+            break;
+        case MRAA_UART_FRAME_DELIMITER:
+            if (option > 0xFF) {
+                syslog(LOG_ERR, "uart%i: async_start: invalid delimiter %u", dev->index, option);
+                return MRAA_ERROR_INVALID_PARAMETER;
+            }
+            break;
+        case MRAA_UART_FRAME_LENGTH:
+            if (option < 1 || option > 4) {
+                syslog(LOG_ERR, "uart%i: async_start: invalid length prefix width %u", dev->index, option);
+                return MRAA_ERROR_INVALID_PARAMETER;
+            }
+            break;
+        default:
+            syslog(LOG_ERR, "uart%i: async_start: unknown framing %d", dev->index, framing);
+            return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    if (ring_size == 0) {
+        syslog(LOG_ERR, "uart%i: async_start: ring size cannot be zero", dev->index);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    struct _uart_async* async = calloc(1, sizeof(struct _uart_async));
+    if (async == NULL) {
+        syslog(LOG_CRIT, "uart%i: async_start: Failed to allocate memory for context", dev->index);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    async->uart = dev;
+    async->framing = framing;
+    async->option = option;
+    async->cb = cb;
+    async->args = args;
+    async->control_pipe[0] = async->control_pipe[1] = -1;
+
+    // round up so offsets can be found with a mask
+    async->size = 1;
+    while (async->size < ring_size) {
+        async->size <<= 1;
+    }
+    async->ring = malloc(async->size);
+    async->scratch = malloc(async->size);
+    if (async->ring == NULL || async->scratch == NULL) {
+        syslog(LOG_CRIT, "uart%i: async_start: Failed to allocate memory for ring", dev->index);
+        mraa_uart_async_free(async);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    if (pipe(async->control_pipe) != 0) {
+        syslog(LOG_ERR, "uart%i: async_start: failed to create control pipe", dev->index);
+        mraa_uart_async_free(async);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+
+    int ret = pthread_create(&async->thread_id, NULL, mraa_uart_async_reader, (void*) async);
+    if (ret != 0) {
+        syslog(LOG_ERR, "uart%i: async_start: failed to create thread: %s", dev->index, strerror(ret));
+        mraa_uart_async_free(async);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+
+    dev->async = async;
+    return MRAA_SUCCESS;
+}
+
+int
+mraa_uart_async_pop(mraa_uart_context dev, const uint8_t** data)
+{
+    if (dev == NULL || dev->async == NULL) {
+        syslog(LOG_ERR, "uart: async_pop: no reader running");
+        return -1;
+    }
+    if (dev->async->cb != NULL || data == NULL) {
+        syslog(LOG_ERR, "uart%i: async_pop: frames are delivered through the callback", dev->index);
+        return -1;
+    }
+
+    struct _uart_async* async = dev->async;
+    // everything before the cursor, including the frame handed out last time, is done with
+    __atomic_store_n(&async->tail, async->cursor, __ATOMIC_RELEASE);
+
+    mraa_uart_frame_t frame;
+    size_t head = __atomic_load_n(&async->head, __ATOMIC_ACQUIRE);
+    if (!mraa_uart_async_next(async, head, &frame)) {
+        __atomic_store_n(&async->tail, async->cursor, __ATOMIC_RELEASE);
+        return 0;
+    }
+
+    *data = frame.data;
+    return frame.length;
+}
+
+mraa_result_t
+mraa_uart_async_get_stats(mraa_uart_context dev, mraa_uart_async_stats_t* stats)
+{
+    if (dev == NULL || dev->async == NULL || stats == NULL) {
+        syslog(LOG_ERR, "uart: async_get_stats: no reader running");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    struct _uart_async* async = dev->async;
+    // counted by the reader thread while this runs
+    stats->bytes = __atomic_load_n(&async->bytes, __ATOMIC_RELAXED);
+    stats->frames = __atomic_load_n(&async->frames, __ATOMIC_RELAXED);
+    stats->errors = __atomic_load_n(&async->errors, __ATOMIC_RELAXED);
+    stats->stalls = __atomic_load_n(&async->stalls, __ATOMIC_RELAXED);
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_uart_async_stop(mraa_uart_context dev)
+{
+    if (dev == NULL) {
+        syslog(LOG_ERR, "uart: async_stop: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (dev->async == NULL) {
+        return MRAA_SUCCESS;
+    }
+
+    struct _uart_async* async = dev->async;
+    mraa_result_t ret = MRAA_SUCCESS;
+
+    async->terminating = 1;
+    close(async->control_pipe[1]);
+    async->control_pipe[1] = -1;
+    if (pthread_join(async->thread_id, NULL) != 0) {
+        ret = MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    dev->async = NULL;
+    mraa_uart_async_free(async);
+    return ret;
+}
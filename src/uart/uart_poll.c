@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "uart.h"
+#include "mraa_internal.h"
+
+#define UART_POLL_MAX_BATCH 64
+
+/**
+ * One registered source. uart entries use the port descriptor directly,
+ * gpio entries own a descriptor from mraa_gpio_event_fd_open().
+ */
+struct _uart_poll_entry {
+    mraa_uart_context uart;
+    mraa_gpio_context gpio;
+    int fd;
+    short gpio_events;   /**< poll events of a gpio descriptor */
+    void* user;
+    struct _uart_poll_entry* next;
+};
+
+struct _uart_poll_set {
+    int epfd;
+    struct _uart_poll_entry* entries;
+};
+
+static uint32_t
+mraa_uart_poll_to_epoll(unsigned int events)
+{
+    uint32_t ep = 0;
+    if (events & MRAA_UART_POLL_READABLE) {
+        ep |= EPOLLIN;
+    }
+    if (events & MRAA_UART_POLL_WRITABLE) {
+        ep |= EPOLLOUT;
+    }
+    return ep;
+}
+
+static struct _uart_poll_entry*
+mraa_uart_poll_set_find(mraa_uart_poll_set set, mraa_uart_context uart, mraa_gpio_context gpio)
+{
+    for (struct _uart_poll_entry* entry = set->entries; entry != NULL; entry = entry->next) {
+        if ((uart != NULL && entry->uart == uart) || (gpio != NULL && entry->gpio == gpio)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+mraa_uart_poll_set
+mraa_uart_poll_set_create()
+{
+    mraa_uart_poll_set set = calloc(1, sizeof(struct _uart_poll_set));
+    if (set == NULL) {
+        syslog(LOG_CRIT, "uart: poll_set: Failed to allocate memory for context");
+        return NULL;
+    }
+
+    set->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (set->epfd < 0) {
+        syslog(LOG_ERR, "uart: poll_set: epoll_create1 failed: %s", strerror(errno));
+        free(set);
+        return NULL;
+    }
+    return set;
+}
+
+mraa_result_t
+mraa_uart_poll_set_add(mraa_uart_poll_set set, mraa_uart_context uart, unsigned int events, void* user)
+{
+    if (set == NULL || uart == NULL) {
+        syslog(LOG_ERR, "uart: poll_set_add: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (events == 0 || (events & ~(MRAA_UART_POLL_READABLE | MRAA_UART_POLL_WRITABLE))) {
+        syslog(LOG_ERR, "uart%i: poll_set_add: invalid events 0x%x", uart->index, events);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+    if (uart->fd < 0) {
+        syslog(LOG_ERR, "uart%i: poll_set_add: port has no descriptor to wait on", uart->index);
+        return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+    }
+    if (uart->async != NULL && (events & MRAA_UART_POLL_READABLE)) {
+        syslog(LOG_ERR, "uart%i: poll_set_add: port is owned by the async reader", uart->index);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    if (mraa_uart_poll_set_find(set, uart, NULL) != NULL) {
+        syslog(LOG_ERR, "uart%i: poll_set_add: already registered", uart->index);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    struct _uart_poll_entry* entry = calloc(1, sizeof(struct _uart_poll_entry));
+    if (entry == NULL) {
+        syslog(LOG_CRIT, "uart%i: poll_set_add: Failed to allocate memory for entry", uart->index);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    entry->uart = uart;
+    entry->fd = uart->fd;
+    entry->user = user;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = mraa_uart_poll_to_epoll(events);
+    ev.data.ptr = entry;
+    if (epoll_ctl(set->epfd, EPOLL_CTL_ADD, entry->fd, &ev) != 0) {
+        syslog(LOG_ERR, "uart%i: poll_set_add: epoll_ctl failed: %s", uart->index, strerror(errno));
+        free(entry);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    entry->next = set->entries;
+    set->entries = entry;
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_uart_poll_set_modify(mraa_uart_poll_set set, mraa_uart_context uart, unsigned int events)
+{
+    if (set == NULL || uart == NULL) {
+        syslog(LOG_ERR, "uart: poll_set_modify: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (events == 0 || (events & ~(MRAA_UART_POLL_READABLE | MRAA_UART_POLL_WRITABLE))) {
+        syslog(LOG_ERR, "uart%i: poll_set_modify: invalid events 0x%x", uart->index, events);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    struct _uart_poll_entry* entry = mraa_uart_poll_set_find(set, uart, NULL);
+    if (entry == NULL) {
+        syslog(LOG_ERR, "uart%i: poll_set_modify: not registered", uart->index);
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = mraa_uart_poll_to_epoll(events);
+    ev.data.ptr = entry;
+    if (epoll_ctl(set->epfd, EPOLL_CTL_MOD, entry->fd, &ev) != 0) {
+        syslog(LOG_ERR, "uart%i: poll_set_modify: epoll_ctl failed: %s", uart->index, strerror(errno));
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_uart_poll_set_add_gpio(mraa_uart_poll_set set, mraa_gpio_context gpio, void* user)
+{
+    if (set == NULL || gpio == NULL) {
+        syslog(LOG_ERR, "uart: poll_set_add_gpio: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (mraa_uart_poll_set_find(set, NULL, gpio) != NULL) {
+        syslog(LOG_ERR, "uart: poll_set_add_gpio: already registered");
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    struct _uart_poll_entry* entry = calloc(1, sizeof(struct _uart_poll_entry));
+    if (entry == NULL) {
+        syslog(LOG_CRIT, "uart: poll_set_add_gpio: Failed to allocate memory for entry");
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    entry->gpio = gpio;
+    entry->user = user;
+    entry->fd = mraa_gpio_event_fd_open(gpio, &entry->gpio_events);
+    if (entry->fd < 0) {
+        syslog(LOG_ERR, "uart: poll_set_add_gpio: gpio cannot report edges to a poll set");
+        free(entry);
+        return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = (entry->gpio_events & POLLPRI) ? EPOLLPRI : EPOLLIN;
+    ev.data.ptr = entry;
+    if (epoll_ctl(set->epfd, EPOLL_CTL_ADD, entry->fd, &ev) != 0) {
+        syslog(LOG_ERR, "uart: poll_set_add_gpio: epoll_ctl failed: %s", strerror(errno));
+        close(entry->fd);
+        free(entry);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    entry->next = set->entries;
+    set->entries = entry;
+    return MRAA_SUCCESS;
+}
+
+static mraa_result_t
+mraa_uart_poll_set_unlink(mraa_uart_poll_set set, mraa_uart_context uart, mraa_gpio_context gpio)
+{
+    struct _uart_poll_entry** link = &set->entries;
+    while (*link != NULL) {
+        struct _uart_poll_entry* entry = *link;
+        if ((uart != NULL && entry->uart == uart) || (gpio != NULL && entry->gpio == gpio)) {
+            *link = entry->next;
+            epoll_ctl(set->epfd, EPOLL_CTL_DEL, entry->fd, NULL);
+            if (entry->gpio != NULL) {
+                close(entry->fd);
+            }
+            free(entry);
+            return MRAA_SUCCESS;
+        }
+        link = &entry->next;
+    }
+    return MRAA_ERROR_INVALID_PARAMETER;
+}
+
+mraa_result_t
+mraa_uart_poll_set_remove(mraa_uart_poll_set set, mraa_uart_context uart)
+{
+    if (set == NULL || uart == NULL) {
+        syslog(LOG_ERR, "uart: poll_set_remove: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    return mraa_uart_poll_set_unlink(set, uart, NULL);
+}
+
+mraa_result_t
+mraa_uart_poll_set_remove_gpio(mraa_uart_poll_set set, mraa_gpio_context gpio)
+{
+    if (set == NULL || gpio == NULL) {
+        syslog(LOG_ERR, "uart: poll_set_remove_gpio: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    return mraa_uart_poll_set_unlink(set, NULL, gpio);
+}
+
+int
+mraa_uart_poll_set_wait(mraa_uart_poll_set set, mraa_uart_poll_event_t* events, int max_events, int timeout_ms)
+{
+    if (set == NULL || events == NULL || max_events <= 0) {
+        syslog(LOG_ERR, "uart: poll_set_wait: invalid parameters");
+        return -1;
+    }
+
+    struct epoll_event ready[UART_POLL_MAX_BATCH];
+    if (max_events > UART_POLL_MAX_BATCH) {
+        max_events = UART_POLL_MAX_BATCH;
+    }
+
+    int n;
+    do {
+        n = epoll_wait(set->epfd, ready, max_events, timeout_ms);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        syslog(LOG_ERR, "uart: poll_set_wait: epoll_wait failed: %s", strerror(errno));
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        struct _uart_poll_entry* entry = (struct _uart_poll_entry*) ready[i].data.ptr;
+        uint32_t ep = ready[i].events;
+
+        events[i].uart = entry->uart;
+        events[i].gpio = entry->gpio;
+        events[i].user = entry->user;
+        events[i].events = 0;
+        if (entry->gpio != NULL) {
+            mraa_gpio_event_fd_ack(entry->fd, entry->gpio_events);
+            events[i].events |= MRAA_UART_POLL_READABLE;
+            continue;
+        }
+        if (ep & EPOLLIN) {
+            events[i].events |= MRAA_UART_POLL_READABLE;
+        }
+        if (ep & EPOLLOUT) {
+            events[i].events |= MRAA_UART_POLL_WRITABLE;
+        }
+        if (ep & (EPOLLERR | EPOLLHUP)) {
+            events[i].events |= MRAA_UART_POLL_ERROR;
+        }
+    }
+    return n;
+}
+
+mraa_result_t
+mraa_uart_poll_set_destroy(mraa_uart_poll_set set)
+{
+    if (set == NULL) {
+        syslog(LOG_ERR, "uart: poll_set_destroy: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    while (set->entries != NULL) {
+        struct _uart_poll_entry* entry = set->entries;
+        set->entries = entry->next;
+        if (entry->gpio != NULL) {
+            close(entry->fd);
+        }
+        free(entry);
+    }
+    close(set->epfd);
+    free(set);
+    return MRAA_SUCCESS;
+}
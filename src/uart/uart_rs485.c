@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <linux/serial.h>
+
+#include "uart.h"
+#include "gpio.h"
+#include "mraa_internal.h"
+
+/* Give up on the line status register after this much extra time */
+#define RS485_DRAIN_SLACK_NS 100000000LL
+
+/**
+ * RS-485 state of a port. Only allocated once RS-485 is enabled, in kernel
+ * mode the driver does all the work and just the mode is remembered.
+ */
+struct _uart_rs485 {
+    mraa_uart_rs485_mode_t mode;
+    mraa_gpio_context de;
+    int de_pin;   /**< mraa pin of de, -1 in kernel mode */
+    int active;   /**< level that asserts DE */
+    int lsr_ok;   /**< driver answers TIOCSERGETLSR */
+};
+
+static long long
+mraa_uart_rs485_now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void
+mraa_uart_rs485_sleep_ns(long long ns)
+{
+    struct timespec ts;
+    ts.tv_sec = ns / 1000000000LL;
+    ts.tv_nsec = ns % 1000000000LL;
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+/*
+ * Wait for the last stop bit to leave the shift register. Sleeps while
+ * whole characters are still queued, then polls the line status register
+ * for the final one, so DE is released within a fraction of a character
+ * rather than after a scheduler tick as tcdrain() tends to.
+ */
+static void
+mraa_uart_rs485_wait_sent(mraa_uart_context dev, size_t len)
+{
+    struct _uart_rs485* rs = dev->rs485;
+
+    if (IS_FUNC_DEFINED(dev, uart_flush_replace)) {
+        dev->advance_func->uart_flush_replace(dev);
+        return;
+    }
+    if (!rs->lsr_ok || dev->baudrate == 0) {
+        tcdrain(dev->fd);
+        return;
+    }
+
+    // 10 bits is the shortest character, sleeping must not overshoot
+    long long char_ns = 10000000000LL / dev->baudrate;
+    long long deadline = mraa_uart_rs485_now_ns() + (long long) (len + 16) * char_ns * 2 + RS485_DRAIN_SLACK_NS;
+
+    for (;;) {
+        long long left = deadline - mraa_uart_rs485_now_ns();
+        if (left <= 0) {
+            syslog(LOG_WARNING, "uart%i: rs485: transmitter did not empty, releasing DE", dev->index);
+            return;
+        }
+        int outq = 0;
+        if (ioctl(dev->fd, TIOCOUTQ, &outq) == 0 && outq > 1) {
+            long long wait = (long long) (outq - 1) * char_ns;
+            mraa_uart_rs485_sleep_ns(wait < left ? wait : left);
+            continue;
+        }
+        unsigned int lsr = 0;
+        if (ioctl(dev->fd, TIOCSERGETLSR, &lsr) != 0) {
+            rs->lsr_ok = 0;
+            tcdrain(dev->fd);
+            return;
+        }
+        if (lsr & TIOCSER_TEMT) {
+            return;
+        }
+    }
+}
+
+int
+mraa_uart_rs485_write(mraa_uart_context dev, const char* buf, size_t len)
+{
+    struct _uart_rs485* rs = dev->rs485;
+    size_t done = 0;
+
+    if (mraa_gpio_write(rs->de, rs->active) != MRAA_SUCCESS) {
+        syslog(LOG_ERR, "uart%i: rs485: failed to assert DE", dev->index);
+        return -1;
+    }
+
+    // DE must not drop in the middle of a frame, so always write it all
+    while (done < len) {
+        ssize_t n;
+        if (IS_FUNC_DEFINED(dev, uart_write_replace)) {
+            n = dev->advance_func->uart_write_replace(dev, buf + done, len - done);
+        } else {
+            n = write(dev->fd, buf + done, len - done);
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && errno == EAGAIN && dev->fd >= 0) {
+            struct pollfd pfd;
+            pfd.fd = dev->fd;
+            pfd.events = POLLOUT;
+            poll(&pfd, 1, -1);
+            continue;
+        }
+        if (n <= 0) {
+            syslog(LOG_ERR, "uart%i: rs485: write failed: %s", dev->index, strerror(errno));
+            break;
+        }
+        done += n;
+    }
+
+    mraa_uart_rs485_wait_sent(dev, done);
+    if (mraa_gpio_write(rs->de, !rs->active) != MRAA_SUCCESS) {
+        syslog(LOG_ERR, "uart%i: rs485: failed to release DE", dev->index);
+    }
+
+    return done == len ? (int) len : -1;
+}
+
+static mraa_result_t
+mraa_uart_rs485_kernel(int fd, mraa_boolean_t enable, mraa_boolean_t de_active_low)
+{
+    struct serial_rs485 conf;
+
+    if (fd < 0) {
+        return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+    }
+    memset(&conf, 0, sizeof(conf));
+    if (ioctl(fd, TIOCGRS485, &conf) != 0) {
+        return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+    }
+
+    if (enable) {
+        conf.flags |= SER_RS485_ENABLED;
+        conf.flags &= ~(SER_RS485_RTS_ON_SEND | SER_RS485_RTS_AFTER_SEND | SER_RS485_RX_DURING_TX);
+        conf.flags |= de_active_low ? SER_RS485_RTS_AFTER_SEND : SER_RS485_RTS_ON_SEND;
+        conf.delay_rts_before_send = 0;
+        conf.delay_rts_after_send = 0;
+    } else {
+        conf.flags &= ~SER_RS485_ENABLED;
+    }
+
+    if (ioctl(fd, TIOCSRS485, &conf) != 0) {
+        return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+    }
+    return MRAA_SUCCESS;
+}
+
+/* Let go of rs, turning the driver's RS-485 mode off only when asked to */
+static void
+mraa_uart_rs485_release(mraa_uart_context dev, struct _uart_rs485* rs, mraa_boolean_t kernel_off)
+{
+    if (kernel_off && rs->mode == MRAA_UART_RS485_KERNEL) {
+        mraa_uart_rs485_kernel(dev->fd, 0, 0);
+    }
+    if (rs->de != NULL) {
+        mraa_gpio_write(rs->de, !rs->active);
+        mraa_gpio_close(rs->de);
+    }
+    free(rs);
+}
+
+void
+mraa_uart_rs485_stop(mraa_uart_context dev)
+{
+    struct _uart_rs485* rs = dev->rs485;
+
+    if (rs == NULL) {
+        return;
+    }
+    dev->rs485 = NULL;
+    mraa_uart_rs485_release(dev, rs, 1);
+}
+
+mraa_result_t
+mraa_uart_set_rs485(mraa_uart_context dev, mraa_boolean_t enable, int de_pin, mraa_boolean_t de_active_low)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "uart: set_rs485: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    if (!enable) {
+        mraa_uart_rs485_stop(dev);
+        return MRAA_SUCCESS;
+    }
+
+    // the current mode stays in place until the new one is set up
+    struct _uart_rs485* old = dev->rs485;
+    struct _uart_rs485* rs = calloc(1, sizeof(struct _uart_rs485));
+    if (rs == NULL) {
+        syslog(LOG_CRIT, "uart%i: set_rs485: Failed to allocate memory for context", dev->index);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    rs->de_pin = -1;
+    rs->active = de_active_low ? 0 : 1;
+
+    if (mraa_uart_rs485_kernel(dev->fd, 1, de_active_low) == MRAA_SUCCESS) {
+        rs->mode = MRAA_UART_RS485_KERNEL;
+        dev->rs485 = rs;
+        // a previous kernel mode was reconfigured in place
+        if (old != NULL) {
+            mraa_uart_rs485_release(dev, old, 0);
+        }
+        return MRAA_SUCCESS;
+    }
+
+    if (de_pin < 0) {
+        syslog(LOG_ERR, "uart%i: set_rs485: driver has no RS-485 support and no DE gpio given", dev->index);
+        free(rs);
+        return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+    }
+    if (dev->writer != NULL) {
+        syslog(LOG_ERR, "uart%i: set_rs485: gpio DE cannot be used with a write buffer", dev->index);
+        free(rs);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    // closing the old context would unexport a pin shared with the new one
+    mraa_boolean_t reused = old != NULL && old->de != NULL && old->de_pin == de_pin;
+    if (reused) {
+        rs->de = old->de;
+    } else {
+        rs->de = mraa_gpio_init(de_pin);
+        if (rs->de == NULL) {
+            syslog(LOG_ERR, "uart%i: set_rs485: failed to initialise DE gpio %d", dev->index, de_pin);
+            free(rs);
+            return MRAA_ERROR_INVALID_RESOURCE;
+        }
+    }
+    mraa_result_t ret = mraa_gpio_dir(rs->de, rs->active ? MRAA_GPIO_OUT_LOW : MRAA_GPIO_OUT_HIGH);
+    if (ret != MRAA_SUCCESS) {
+        syslog(LOG_ERR, "uart%i: set_rs485: failed to drive DE gpio %d", dev->index, de_pin);
+        if (reused) {
+            mraa_gpio_dir(old->de, old->active ? MRAA_GPIO_OUT_LOW : MRAA_GPIO_OUT_HIGH);
+        } else {
+            mraa_gpio_close(rs->de);
+        }
+        free(rs);
+        return ret;
+    }
+
+    if (dev->fd >= 0) {
+        unsigned int lsr;
+        rs->lsr_ok = ioctl(dev->fd, TIOCSERGETLSR, &lsr) == 0;
+        if (!rs->lsr_ok) {
+            syslog(LOG_NOTICE, "uart%i: set_rs485: no line status register, falling back to tcdrain", dev->index);
+        }
+    }
+    rs->mode = MRAA_UART_RS485_GPIO;
+    rs->de_pin = de_pin;
+    dev->rs485 = rs;
+    if (old != NULL) {
+        if (reused) {
+            old->de = NULL;
+        }
+        mraa_uart_rs485_release(dev, old, 1);
+    }
+    return MRAA_SUCCESS;
+}
+
+mraa_uart_rs485_mode_t
+mraa_uart_get_rs485_mode(mraa_uart_context dev)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "uart: get_rs485_mode: context is NULL");
+        return MRAA_UART_RS485_OFF;
+    }
+    return dev->rs485 != NULL ? dev->rs485->mode : MRAA_UART_RS485_OFF;
+}
+
+mraa_result_t
+mraa_uart_rs485_settings(int index, const char** devpath, unsigned int* enabled, unsigned int* rts_on_send, unsigned int* delay_after_ms)
+{
+    const char* path;
+    struct serial_rs485 conf;
+
+    if (plat == NULL) {
+        return MRAA_ERROR_PLATFORM_NOT_INITIALISED;
+    }
+
+    if (index >= 0 && index < plat->uart_dev_count) {
+        path = plat->uart_dev[index].device_path;
+        if (devpath != NULL) {
+            *devpath = path;
+        }
+    } else if (devpath != NULL && *devpath != NULL) {
+        path = *devpath;
+    } else {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    int fd = open(path, O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    memset(&conf, 0, sizeof(conf));
+    int ret = ioctl(fd, TIOCGRS485, &conf);
+    close(fd);
+    if (ret != 0) {
+        return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+    }
+
+    if (enabled != NULL) {
+        *enabled = conf.flags & SER_RS485_ENABLED ? 1 : 0;
+    }
+    if (rts_on_send != NULL) {
+        *rts_on_send = conf.flags & SER_RS485_RTS_ON_SEND ? 1 : 0;
+    }
+    if (delay_after_ms != NULL) {
+        *delay_after_ms = conf.delay_rts_after_send;
+    }
+    return MRAA_SUCCESS;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * struct termios2 lives in the kernel headers, which clash with the libc
+ * <termios.h> used by uart.c, so the BOTHER handling has its own file.
+ */
+#include <errno.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#if defined(__linux__)
+#include <asm/termbits.h>
+#endif
+
+#include "mraa_internal.h"
+
+mraa_result_t
+mraa_uart_termios2_set_speed(int fd, unsigned int baud)
+{
+#if defined(TCGETS2) && defined(BOTHER)
+    struct termios2 tio;
+    if (ioctl(fd, TCGETS2, &tio) != 0) {
+        syslog(LOG_ERR, "uart: termios2: TCGETS2 failed: %s", strerror(errno));
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    tio.c_cflag &= ~CBAUD;
+    tio.c_cflag |= BOTHER;
+    tio.c_ispeed = baud;
+    tio.c_ospeed = baud;
+    // input speed follows output speed
+    tio.c_cflag &= ~(CBAUD << IBSHIFT);
+
+    if (ioctl(fd, TCSETSF2, &tio) != 0) {
+        syslog(LOG_ERR, "uart: termios2: TCSETSF2 failed: %s", strerror(errno));
+        return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+    }
+    return MRAA_SUCCESS;
+#else
+    return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+#endif
+}
+
+mraa_result_t
+mraa_uart_termios2_get_speed(int fd, unsigned int* baud)
+{
+#if defined(TCGETS2)
+    struct termios2 tio;
+    if (ioctl(fd, TCGETS2, &tio) != 0) {
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    // drivers write the rate they really programmed back into c_ospeed
+    *baud = tio.c_ospeed;
+    return MRAA_SUCCESS;
+#else
+    return MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+#endif
+}
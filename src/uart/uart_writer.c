@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "uart.h"
+#include "mraa_internal.h"
+
+/**
+ * Buffered writer state. Writes are only ever issued from the caller's
+ * thread, the completion thread just waits for the driver to drain and
+ * reports how many bytes made it out.
+ */
+struct _uart_writer {
+    uint8_t* buf;
+    size_t size;
+    size_t len;
+
+    mraa_uart_write_done_cb cb;
+    void* args;
+    pthread_t thread_id;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int thread_running;
+    int terminating;
+    unsigned long long written;   /**< bytes handed to the driver */
+    unsigned long long completed; /**< bytes reported as sent */
+};
+
+/* Hand up to two buffers to the driver in one call, returns bytes taken */
+static ssize_t
+mraa_uart_writer_emit(mraa_uart_context dev, const uint8_t* a, size_t alen, const uint8_t* b, size_t blen)
+{
+    ssize_t n;
+
+    if (IS_FUNC_DEFINED(dev, uart_write_replace)) {
+        n = alen > 0 ? dev->advance_func->uart_write_replace(dev, (const char*) a, alen) : 0;
+        if (n == (ssize_t) alen && blen > 0) {
+            int m = dev->advance_func->uart_write_replace(dev, (const char*) b, blen);
+            n = m < 0 ? n : n + m;
+        }
+    } else {
+        struct iovec iov[2];
+        int cnt = 0;
+        if (alen > 0) {
+            iov[cnt].iov_base = (void*) a;
+            iov[cnt++].iov_len = alen;
+        }
+        if (blen > 0) {
+            iov[cnt].iov_base = (void*) b;
+            iov[cnt++].iov_len = blen;
+        }
+        do {
+            n = writev(dev->fd, iov, cnt);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0 && errno == EAGAIN) {
+            n = 0;
+        }
+    }
+
+    if (n > 0) {
+        struct _uart_writer* w = dev->writer;
+        pthread_mutex_lock(&w->lock);
+        w->written += n;
+        pthread_cond_signal(&w->cond);
+        pthread_mutex_unlock(&w->lock);
+    }
+    return n;
+}
+
+static void*
+mraa_uart_writer_completion(void* arg)
+{
+    mraa_uart_context dev = (mraa_uart_context) arg;
+    struct _uart_writer* w = dev->writer;
+
+    pthread_mutex_lock(&w->lock);
+    for (;;) {
+        while (w->written == w->completed && !w->terminating) {
+            pthread_cond_wait(&w->cond, &w->lock);
+        }
+        if (w->written == w->completed) {
+            // terminating with nothing left to report
+            break;
+        }
+        unsigned long long target = w->written;
+        pthread_mutex_unlock(&w->lock);
+
+        // everything handed over before the drain started has left the transmitter
+        if (IS_FUNC_DEFINED(dev, uart_flush_replace)) {
+            dev->advance_func->uart_flush_replace(dev);
+        } else {
+            tcdrain(dev->fd);
+        }
+
+        pthread_mutex_lock(&w->lock);
+        unsigned int done = (unsigned int) (target - w->completed);
+        w->completed = target;
+        mraa_uart_write_done_cb cb = w->cb;
+        void* args = w->args;
+        pthread_mutex_unlock(&w->lock);
+        if (cb != NULL) {
+            cb(done, args);
+        }
+        pthread_mutex_lock(&w->lock);
+    }
+    pthread_mutex_unlock(&w->lock);
+
+    return NULL;
+}
+
+int
+mraa_uart_writer_write(mraa_uart_context dev, const char* buf, size_t len)
+{
+    struct _uart_writer* w = dev->writer;
+    const uint8_t* data = (const uint8_t*) buf;
+
+    if (w->len + len <= w->size) {
+        memcpy(w->buf + w->len, data, len);
+        w->len += len;
+        return (int) len;
+    }
+
+    // queue is full, push it out together with the new data in one call
+    ssize_t n = mraa_uart_writer_emit(dev, w->buf, w->len, data, len);
+    if (n < 0) {
+        syslog(LOG_ERR, "uart%i: write: writev failed: %s", dev->index, strerror(errno));
+        return -1;
+    }
+
+    size_t taken = 0;
+    if ((size_t) n < w->len) {
+        memmove(w->buf, w->buf + n, w->len - n);
+        w->len -= n;
+    } else {
+        taken = n - w->len;
+        w->len = 0;
+    }
+
+    size_t room = w->size - w->len;
+    size_t copy = len - taken < room ? len - taken : room;
+    memcpy(w->buf + w->len, data + taken, copy);
+    w->len += copy;
+    return (int) (taken + copy);
+}
+
+int
+mraa_uart_write_flush(mraa_uart_context dev)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "uart: write_flush: context is NULL");
+        return -1;
+    }
+    if (dev->writer == NULL) {
+        return 0;
+    }
+
+    struct _uart_writer* w = dev->writer;
+    while (w->len > 0) {
+        ssize_t n = mraa_uart_writer_emit(dev, w->buf, w->len, NULL, 0);
+        if (n < 0) {
+            syslog(LOG_ERR, "uart%i: write_flush: write failed: %s", dev->index, strerror(errno));
+            return -1;
+        }
+        if (n == 0) {
+            // non blocking port with a full driver buffer
+            break;
+        }
+        memmove(w->buf, w->buf + n, w->len - n);
+        w->len -= n;
+    }
+    return (int) w->len;
+}
+
+mraa_result_t
+mraa_uart_writer_drain(mraa_uart_context dev)
+{
+    while (mraa_uart_write_flush(dev) > 0) {
+        if (dev->fd < 0) {
+            return MRAA_ERROR_INVALID_RESOURCE;
+        }
+        struct pollfd pfd;
+        pfd.fd = dev->fd;
+        pfd.events = POLLOUT;
+        if (poll(&pfd, 1, -1) < 0 && errno != EINTR) {
+            return MRAA_ERROR_INVALID_RESOURCE;
+        }
+    }
+    return dev->writer != NULL && dev->writer->len > 0 ? MRAA_ERROR_INVALID_RESOURCE : MRAA_SUCCESS;
+}
+
+static void
+mraa_uart_writer_free(mraa_uart_context dev)
+{
+    struct _uart_writer* w = dev->writer;
+
+    if (w->thread_running) {
+        pthread_mutex_lock(&w->lock);
+        w->terminating = 1;
+        pthread_cond_signal(&w->cond);
+        pthread_mutex_unlock(&w->lock);
+        pthread_join(w->thread_id, NULL);
+    }
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->cond);
+    dev->writer = NULL;
+    free(w->buf);
+    free(w);
+}
+
+mraa_result_t
+mraa_uart_set_write_buffer(mraa_uart_context dev, unsigned int size)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "uart: set_write_buffer: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    if (dev->writer != NULL) {
+        mraa_result_t ret = mraa_uart_writer_drain(dev);
+        if (ret != MRAA_SUCCESS) {
+            syslog(LOG_ERR, "uart%i: set_write_buffer: failed to flush queued data", dev->index);
+            return ret;
+        }
+        if (size == 0) {
+            mraa_uart_writer_free(dev);
+            return MRAA_SUCCESS;
+        }
+        uint8_t* buf = realloc(dev->writer->buf, size);
+        if (buf == NULL) {
+            syslog(LOG_CRIT, "uart%i: set_write_buffer: Failed to allocate memory for queue", dev->index);
+            return MRAA_ERROR_NO_RESOURCES;
+        }
+        dev->writer->buf = buf;
+        dev->writer->size = size;
+        return MRAA_SUCCESS;
+    }
+
+    if (size == 0) {
+        return MRAA_SUCCESS;
+    }
+    if (mraa_uart_get_rs485_mode(dev) == MRAA_UART_RS485_GPIO) {
+        syslog(LOG_ERR, "uart%i: set_write_buffer: not available with gpio RS-485 direction control", dev->index);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    if (dev->fd < 0 && !IS_FUNC_DEFINED(dev, uart_write_replace)) {
+        syslog(LOG_ERR, "uart%i: set_write_buffer: port is not open", dev->index);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    struct _uart_writer* w = calloc(1, sizeof(struct _uart_writer));
+    if (w == NULL || (w->buf = malloc(size)) == NULL) {
+        syslog(LOG_CRIT, "uart%i: set_write_buffer: Failed to allocate memory for queue", dev->index);
+        free(w);
+        return MRAA_ERROR_NO_RESOURCES;
+    }
+    w->size = size;
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->cond, NULL);
+    dev->writer = w;
+    return MRAA_SUCCESS;
+}
+
+mraa_result_t
+mraa_uart_set_write_callback(mraa_uart_context dev, mraa_uart_write_done_cb cb, void* args)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "uart: set_write_callback: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (dev->writer == NULL) {
+        syslog(LOG_ERR, "uart%i: set_write_callback: write buffer is not enabled", dev->index);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+
+    struct _uart_writer* w = dev->writer;
+    pthread_mutex_lock(&w->lock);
+    w->cb = cb;
+    w->args = args;
+    pthread_mutex_unlock(&w->lock);
+
+    if (cb != NULL && !w->thread_running) {
+        // only bytes written from now on are reported
+        w->completed = w->written;
+        if (pthread_create(&w->thread_id, NULL, mraa_uart_writer_completion, (void*) dev) != 0) {
+            syslog(LOG_ERR, "uart%i: set_write_callback: failed to create thread", dev->index);
+            w->cb = NULL;
+            return MRAA_ERROR_NO_RESOURCES;
+        }
+        w->thread_running = 1;
+    }
+    return MRAA_SUCCESS;
+}
+
+int
+mraa_uart_output_pending(mraa_uart_context dev)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "uart: output_pending: context is NULL");
+        return -1;
+    }
+
+    int pending = dev->writer != NULL ? (int) dev->writer->len : 0;
+    if (dev->fd >= 0) {
+        int outq = 0;
+        if (ioctl(dev->fd, TIOCOUTQ, &outq) == 0) {
+            pending += outq;
+        }
+    }
+    return pending;
+}
+
+void
+mraa_uart_writer_stop(mraa_uart_context dev)
+{
+    if (dev->writer == NULL) {
+        return;
+    }
+    if (mraa_uart_write_flush(dev) > 0) {
+        syslog(LOG_WARNING, "uart%i: stop: dropping %d queued bytes", dev->index, (int) dev->writer->len);
+    }
+    mraa_uart_writer_free(dev);
+}
@@ -11,6 +11,7 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <math.h>
 #include <stdlib.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -18,25 +19,106 @@
 #include <termios.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <poll.h>
 #include <time.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#include "crc.h"
 #include "uart.h"
 #include "uart_ow.h"
 #include "mraa_internal.h"
 
-// low-level read byte
+// 1-Wire bytes exchanged per uart write, each one takes 8 uart bytes
+#define OW_BLOCK_BYTES 32
+
+// default time allowed for echoes on top of their transmission time
+#define OW_DEFAULT_RESET_TIMEOUT 100
+#define OW_DEFAULT_IO_TIMEOUT 100
+
+// uart character time in microseconds at 9600 and 115200 baud
+#define OW_CHAR_US_LOW 1042
+#define OW_CHAR_US_HIGH 87
+
+/* termios for the reset and data speeds, built once per context */
+struct _uart_ow_speeds {
+    struct termios low;
+    struct termios high;
+    int current; /**< speed in use, -1 when unknown */
+};
+
+/* rom codes found by the last search, in search order */
+struct _uart_ow_roms {
+    uint8_t* ids;
+    int count;
+    int size;
+    int stale; /**< a device stopped answering, search again */
+};
+
+// DS18B20 family command bytes
+#define OW_CMD_CONVERT_T 0x44
+#define OW_CMD_READ_SCRATCHPAD 0xbe
+
+// families that answer Convert T and Read Scratchpad like a DS18B20
+static int
+_ow_is_thermometer(uint8_t family)
+{
+    switch (family) {
+        case 0x10: // DS18S20
+        case 0x22: // DS1822
+        case 0x28: // DS18B20
+        case 0x3b: // DS1825, MAX31850
+        case 0x42: // DS28EA00
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static long long
+_ow_now_ms()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// low-level read of len bytes, sleeping in poll() until they arrive
 static mraa_result_t
-_ow_read_byte(mraa_uart_ow_context dev, uint8_t *ch)
+_ow_read_block(mraa_uart_ow_context dev, uint8_t *buf, int len, int timeout_ms)
 {
-    time_t thetime = time(NULL);
-    // add 5 seconds -- our crude timeout
-    thetime += 5;
+    int char_us = dev->speeds->current == 0 ? OW_CHAR_US_LOW : OW_CHAR_US_HIGH;
+    long long start = _ow_now_ms();
+    long long deadline = start + timeout_ms + ((long long) len * char_us + 999) / 1000;
+
+    int got = 0;
+    while (got < len) {
+        int rv = mraa_uart_read(dev->uart, (char*) buf + got, len - got);
+        if (rv > 0) {
+            got += rv;
+            continue;
+        }
+        if (rv < 0 && errno != EAGAIN && errno != EINTR) {
+            syslog(LOG_ERR, "uart_ow: read failed: %s", strerror(errno));
+            return MRAA_ERROR_INVALID_RESOURCE;
+        }
 
-    int rv;
-    do {
-        rv = mraa_uart_read(dev->uart, (char*) ch, 1);
-    } while (rv == 0 && (time(NULL) < thetime));
+        long long left = deadline - _ow_now_ms();
+        if (left <= 0) {
+            break;
+        }
+        struct pollfd pfd;
+        pfd.fd = dev->uart->fd;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, (int) left) < 0 && errno != EINTR) {
+            return MRAA_ERROR_INVALID_RESOURCE;
+        }
+    }
 
-    if (rv == 0) {
+    if (got < len) {
+        syslog(LOG_NOTICE, "uart_ow: timed out after %lld ms with %d of %d bytes", _ow_now_ms() - start, got, len);
         return MRAA_ERROR_NO_DATA_AVAILABLE; // we timed out
     }
     else {
@@ -44,6 +126,13 @@ _ow_read_byte(mraa_uart_ow_context dev, uint8_t *ch)
     }
 }
 
+// low-level read byte
+static mraa_result_t
+_ow_read_byte(mraa_uart_ow_context dev, uint8_t *ch)
+{
+    return _ow_read_block(dev, ch, 1, dev->io_timeout);
+}
+
 // low-level write byte
 static int
 _ow_write_byte(mraa_uart_ow_context dev, const char ch)
@@ -51,6 +140,83 @@ _ow_write_byte(mraa_uart_ow_context dev, const char ch)
     return mraa_uart_write(dev->uart, &ch, 1);
 }
 
+// Expand bytes into timeslots, LSB first, 0xff for a 1 and 0x00 for a 0
+static void
+_ow_encode_slots(uint8_t *slots, const uint8_t *data, int len)
+{
+    int i, b;
+    for (i = 0; i < len; i++) {
+        for (b = 0; b < 8; b++) {
+            *slots++ = (data[i] >> b) & 0x01 ? 0xff : 0x00;
+        }
+    }
+}
+
+// Collapse echoed timeslots back into bytes, only an 0xff echo is a 1
+static void
+_ow_decode_slots(uint8_t *data, const uint8_t *slots, int len)
+{
+    int i = 0, b;
+
+#if defined(__SSE2__)
+    // compare 16 slots at once, the byte mask is exactly two bus bytes
+    const __m128i ones = _mm_set1_epi8((char) 0xff);
+    for (; i + 2 <= len; i += 2) {
+        __m128i v = _mm_loadu_si128((const __m128i*) (slots + i * 8));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, ones));
+        data[i] = mask & 0xff;
+        data[i + 1] = mask >> 8;
+    }
+#elif defined(__aarch64__)
+    const uint8_t weights[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+    const uint8x8_t w = vld1_u8(weights);
+    for (; i < len; i++) {
+        uint8x8_t v = vceq_u8(vld1_u8(slots + i * 8), vdup_n_u8(0xff));
+        data[i] = vaddv_u8(vand_u8(v, w));
+    }
+#endif
+    for (; i < len; i++) {
+        uint8_t byte = 0;
+        for (b = 0; b < 8; b++) {
+            if (slots[i * 8 + b] == 0xff) {
+                byte |= 1 << b;
+            }
+        }
+        data[i] = byte;
+    }
+}
+
+// Run raw timeslots, the echo of each replaces it in slots
+static mraa_result_t
+_ow_touch_slots(mraa_uart_ow_context dev, uint8_t *slots, int len)
+{
+    if (mraa_uart_write(dev->uart, (const char*) slots, len) != len) {
+        syslog(LOG_ERR, "uart_ow: failed to write %d timeslots", len);
+        return MRAA_ERROR_INVALID_RESOURCE;
+    }
+    return _ow_read_block(dev, slots, len, dev->io_timeout);
+}
+
+// Exchange whole bytes with the bus, one uart write and read per block
+static mraa_result_t
+_ow_touch_block(mraa_uart_ow_context dev, uint8_t *buf, int len)
+{
+    uint8_t slots[OW_BLOCK_BYTES * 8];
+
+    while (len > 0) {
+        int n = len < OW_BLOCK_BYTES ? len : OW_BLOCK_BYTES;
+        _ow_encode_slots(slots, buf, n);
+        mraa_result_t rv = _ow_touch_slots(dev, slots, n * 8);
+        if (rv != MRAA_SUCCESS) {
+            return rv;
+        }
+        _ow_decode_slots(buf, slots, n);
+        buf += n;
+        len -= n;
+    }
+    return MRAA_SUCCESS;
+}
+
 // Here we setup a very simple termios with the minimum required
 // settings.  We use this to also change speed from high to low.  We
 // use the low speed (9600 bd) for emitting the reset pulse, and
@@ -65,29 +231,58 @@ _ow_set_speed(mraa_uart_ow_context dev, mraa_boolean_t speed)
         return MRAA_ERROR_INVALID_HANDLE;
     }
 
-    static speed_t baud;
-    if (speed) {
-        baud = B115200;
-    }
-    else {
-        baud = B9600;
-    }
-
-    struct termios termio = {
-        .c_cflag = baud | CS8 | CLOCAL | CREAD, .c_iflag = 0, .c_oflag = 0, .c_lflag = NOFLSH, .c_cc = { 0 },
-    };
-
     tcflush(dev->uart->fd, TCIFLUSH);
 
+    if (dev->speeds->current == (speed ? 1 : 0)) {
+        return MRAA_SUCCESS;
+    }
+
     // TCSANOW is required
-    if (tcsetattr(dev->uart->fd, TCSANOW, &termio) < 0) {
+    if (tcsetattr(dev->uart->fd, TCSANOW, speed ? &dev->speeds->high : &dev->speeds->low) < 0) {
         syslog(LOG_ERR, "uart_ow: tcsetattr() failed");
+        dev->speeds->current = -1;
         return MRAA_ERROR_INVALID_RESOURCE;
     }
+    dev->speeds->current = speed ? 1 : 0;
 
     return MRAA_SUCCESS;
 }
 
+// Common setup once the uart is open
+static mraa_uart_ow_context
+_ow_setup(mraa_uart_ow_context dev)
+{
+    // now get the fd, and set it up for non-blocking operation
+    if (fcntl(dev->uart->fd, F_SETFL, O_NONBLOCK) == -1) {
+        syslog(LOG_ERR, "uart_ow: failed to set non-blocking on fd");
+        mraa_uart_ow_stop(dev);
+        return NULL;
+    }
+
+    dev->speeds = calloc(1, sizeof(struct _uart_ow_speeds));
+    if (!dev->speeds) {
+        syslog(LOG_CRIT, "uart_ow: Failed to allocate memory for context");
+        mraa_uart_ow_stop(dev);
+        return NULL;
+    }
+
+    struct termios termio = {
+        .c_cflag = CS8 | CLOCAL | CREAD, .c_iflag = 0, .c_oflag = 0, .c_lflag = NOFLSH, .c_cc = { 0 },
+    };
+    dev->speeds->low = termio;
+    cfsetispeed(&dev->speeds->low, B9600);
+    cfsetospeed(&dev->speeds->low, B9600);
+    dev->speeds->high = termio;
+    cfsetispeed(&dev->speeds->high, B115200);
+    cfsetospeed(&dev->speeds->high, B115200);
+    dev->speeds->current = -1;
+
+    dev->reset_timeout = OW_DEFAULT_RESET_TIMEOUT;
+    dev->io_timeout = OW_DEFAULT_IO_TIMEOUT;
+
+    return dev;
+}
+
 // Perform the 1-Wire Search Algorithm on the 1-Wire bus using the existing
 // search state.
 // Return 1 : device found, ROM number in ROM_NO buffer
@@ -124,9 +319,12 @@ _ow_search(mraa_uart_ow_context dev)
 
         // loop to do the search
         do {
-            // read a bit and its complement
-            id_bit = mraa_uart_ow_bit(dev, 1);
-            cmp_id_bit = mraa_uart_ow_bit(dev, 1);
+            // read a bit and its complement, both slots in one exchange
+            uint8_t pair[2] = { 0xff, 0xff };
+            if (_ow_touch_slots(dev, pair, 2) != MRAA_SUCCESS)
+                break;
+            id_bit = (pair[0] == 0xff);
+            cmp_id_bit = (pair[1] == 0xff);
 
             // check for no devices on 1-wire
             if ((id_bit == 1) && (cmp_id_bit == 1))
@@ -245,15 +443,7 @@ mraa_uart_ow_init(int index)
             return NULL;
         }
 
-
-    // now get the fd, and set it up for non-blocking operation
-    if (fcntl(dev->uart->fd, F_SETFL, O_NONBLOCK) == -1) {
-        syslog(LOG_ERR, "uart_ow: failed to set non-blocking on fd");
-        mraa_uart_ow_stop(dev);
-        return NULL;
-    }
-
-    return dev;
+    return _ow_setup(dev);
 }
 
 mraa_uart_ow_context
@@ -270,24 +460,38 @@ mraa_uart_ow_init_raw(const char* path)
             return NULL;
         }
 
-    // now get the fd, and set it up for non-blocking operation
-    if (fcntl(dev->uart->fd, F_SETFL, O_NONBLOCK) == -1) {
-        syslog(LOG_ERR, "uart_ow: failed to set non-blocking on fd");
-        mraa_uart_ow_stop(dev);
-        return NULL;
-    }
-
-    return dev;
+    return _ow_setup(dev);
 }
 
 mraa_result_t
 mraa_uart_ow_stop(mraa_uart_ow_context dev)
 {
     mraa_result_t rv =  mraa_uart_stop(dev->uart);
+    if (dev->roms) {
+        free(dev->roms->ids);
+        free(dev->roms);
+    }
+    free(dev->speeds);
     free(dev);
     return rv;
 }
 
+mraa_result_t
+mraa_uart_ow_set_timeout(mraa_uart_ow_context dev, int reset_ms, int io_ms)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "uart_ow: set_timeout: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (reset_ms < 0 || io_ms < 0) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    dev->reset_timeout = reset_ms;
+    dev->io_timeout = io_ms;
+    return MRAA_SUCCESS;
+}
+
 const char*
 mraa_uart_ow_get_dev_path(mraa_uart_ow_context dev)
 {
@@ -333,24 +537,31 @@ mraa_uart_ow_write_byte(mraa_uart_ow_context dev, uint8_t byte)
      * from the bus and build a byte to return.  This is possible due to
      * the way we wire the UART TX/RX pins together, similar to a
      * loopback connection, except the devices on the 1-wire bus have
-     * the ability to modify the returning bitstream.
+     * the ability to modify the returning bitstream. All eight
+     * timeslots go out in a single write.
      */
-
-    uint8_t bit;
-    int i;
-    for (i = 0; i < 8; i++) {
-        bit = mraa_uart_ow_bit(dev, byte & 0x01);
-        /* prep for next bit to send, and clear space for bit read */
-        byte >>= 1;
-        /* store read bit in the msb */
-        if (bit)
-            byte |= 0x80;
+    if (_ow_touch_block(dev, &byte, 1) != MRAA_SUCCESS) {
+        return -1;
     }
 
     /* return the new byte read */
     return byte;
 }
 
+mraa_result_t
+mraa_uart_ow_block(mraa_uart_ow_context dev, uint8_t* buf, int len)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "uart_ow: block: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+    if (buf == NULL || len < 0) {
+        return MRAA_ERROR_INVALID_PARAMETER;
+    }
+
+    return _ow_touch_block(dev, buf, len);
+}
+
 int
 mraa_uart_ow_read_byte(mraa_uart_ow_context dev)
 {
@@ -396,7 +607,7 @@ mraa_uart_ow_reset(mraa_uart_ow_context dev)
     /* pull the data line low */
     _ow_write_byte(dev, 0xf0);
 
-    if (_ow_read_byte(dev, &rv) != MRAA_SUCCESS) {
+    if (_ow_read_block(dev, &rv, 1, dev->reset_timeout) != MRAA_SUCCESS) {
         return MRAA_ERROR_NO_DATA_AVAILABLE;
     }
 
@@ -464,52 +675,257 @@ mraa_uart_ow_command(mraa_uart_ow_context dev, uint8_t command, uint8_t* id)
     if (rv != MRAA_SUCCESS)
         return rv;
 
+    uint8_t buf[MRAA_UART_OW_ROMCODE_SIZE + 2];
+    int len = 0;
     if (id) {
         /* send the match rom command */
-        mraa_uart_ow_write_byte(dev, MRAA_UART_OW_CMD_MATCH_ROM);
+        buf[len++] = MRAA_UART_OW_CMD_MATCH_ROM;
 
         /* sending to a specific device, so send out the full romcode */
-        int i;
-        for (i = 0; i < MRAA_UART_OW_ROMCODE_SIZE; i++)
-            mraa_uart_ow_write_byte(dev, id[i]);
+        memcpy(buf + len, id, MRAA_UART_OW_ROMCODE_SIZE);
+        len += MRAA_UART_OW_ROMCODE_SIZE;
     } else {
         /* send to all devices (or a single device if it's the only one
          * on the bus)
          */
-        mraa_uart_ow_write_byte(dev, MRAA_UART_OW_CMD_SKIP_ROM);
+        buf[len++] = MRAA_UART_OW_CMD_SKIP_ROM;
     }
 
-    mraa_uart_ow_write_byte(dev, command);
+    buf[len++] = command;
 
-    return MRAA_SUCCESS;
+    /* rom selection and command go out as one block */
+    return _ow_touch_block(dev, buf, len);
 }
 
 uint8_t
 mraa_uart_ow_crc8(uint8_t* buffer, uint16_t length)
 {
-    // 0x18 = X ^ 8 + X ^ 5 + X ^ 4 + X ^ 0
-    static const uint8_t CRC8POLY = 0x18;
+    return mraa_crc8_maxim(buffer, length, 0);
+}
 
-    uint8_t crc = 0x00;
-    uint16_t loop_count;
-    uint8_t bit_counter;
-    uint8_t data;
-    uint8_t feedback_bit;
+// Walk the whole bus and replace the cached rom codes
+static mraa_result_t
+_ow_search_all(mraa_uart_ow_context dev)
+{
+    struct _uart_ow_roms* roms = dev->roms;
+    uint8_t id[MRAA_UART_OW_ROMCODE_SIZE];
+    mraa_boolean_t start = 1;
+    mraa_result_t rv;
 
-    for (loop_count = 0; loop_count != length; loop_count++) {
-        data = buffer[loop_count];
-        bit_counter = 8;
-        do {
-            feedback_bit = (crc ^ data) & 0x01;
-            if (feedback_bit == 0x01)
-                crc = crc ^ CRC8POLY;
-            crc = (crc >> 1) & 0x7F;
-            if (feedback_bit == 0x01)
-                crc = crc | 0x80;
-            data = data >> 1;
-            bit_counter--;
-        } while (bit_counter > 0);
-    }
-
-    return crc;
+    roms->count = 0;
+    while ((rv = mraa_uart_ow_rom_search(dev, start, id)) == MRAA_SUCCESS) {
+        start = 0;
+        if (mraa_uart_ow_crc8(id, MRAA_UART_OW_ROMCODE_SIZE) != 0) {
+            // noise on the bus, the next call starts over
+            syslog(LOG_WARNING, "uart_ow: search: rom code with bad crc, restarting");
+            roms->count = 0;
+            start = 1;
+            continue;
+        }
+        if (roms->count == roms->size) {
+            int size = roms->size ? roms->size * 2 : 8;
+            uint8_t* ids = realloc(roms->ids, size * MRAA_UART_OW_ROMCODE_SIZE);
+            if (!ids) {
+                syslog(LOG_CRIT, "uart_ow: search: Failed to allocate memory for rom cache");
+                return MRAA_ERROR_NO_RESOURCES;
+            }
+            roms->ids = ids;
+            roms->size = size;
+        }
+        memcpy(roms->ids + roms->count * MRAA_UART_OW_ROMCODE_SIZE, id, MRAA_UART_OW_ROMCODE_SIZE);
+        roms->count++;
+        if (dev->LastDeviceFlag) {
+            break;
+        }
+    }
+
+    roms->stale = 0;
+    if (rv == MRAA_ERROR_UART_OW_NO_DEVICES || rv == MRAA_SUCCESS) {
+        return MRAA_SUCCESS;
+    }
+    return rv;
+}
+
+int
+mraa_uart_ow_devices(mraa_uart_ow_context dev, uint8_t* ids, int max, mraa_boolean_t refresh)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "uart_ow: devices: context is NULL");
+        return -1;
+    }
+
+    if (!dev->roms) {
+        dev->roms = calloc(1, sizeof(struct _uart_ow_roms));
+        if (!dev->roms) {
+            syslog(LOG_CRIT, "uart_ow: devices: Failed to allocate memory for rom cache");
+            return -1;
+        }
+        refresh = 1;
+    }
+
+    if (!refresh && !dev->roms->stale) {
+        // a presence pulse that does not match the cache means the bus changed
+        mraa_result_t rv = mraa_uart_ow_reset(dev);
+        if (rv == MRAA_ERROR_UART_OW_NO_DEVICES) {
+            refresh = dev->roms->count > 0;
+        } else if (rv == MRAA_SUCCESS) {
+            refresh = dev->roms->count == 0;
+        } else {
+            return -1;
+        }
+    }
+
+    if (refresh || dev->roms->stale) {
+        if (_ow_search_all(dev) != MRAA_SUCCESS) {
+            return -1;
+        }
+    }
+
+    int n = dev->roms->count < max ? dev->roms->count : max;
+    if (ids && n > 0) {
+        memcpy(ids, dev->roms->ids, n * MRAA_UART_OW_ROMCODE_SIZE);
+    }
+    return dev->roms->count;
+}
+
+mraa_result_t
+mraa_uart_ow_convert_all(mraa_uart_ow_context dev, unsigned int timeout_ms)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "uart_ow: convert_all: context is NULL");
+        return MRAA_ERROR_INVALID_HANDLE;
+    }
+
+    // one Skip ROM Convert T starts every sensor on the bus at once
+    mraa_result_t rv = mraa_uart_ow_command(dev, OW_CMD_CONVERT_T, NULL);
+    if (rv != MRAA_SUCCESS) {
+        return rv;
+    }
+
+    // sensors hold read slots low until their conversion is done
+    long long deadline = _ow_now_ms() + timeout_ms;
+    for (;;) {
+        uint8_t busy = 0xff;
+        rv = _ow_touch_block(dev, &busy, 1);
+        if (rv != MRAA_SUCCESS) {
+            return rv;
+        }
+        if (busy == 0xff) {
+            return MRAA_SUCCESS;
+        }
+        if (_ow_now_ms() >= deadline) {
+            syslog(LOG_ERR, "uart_ow: convert_all: conversion not done after %u ms", timeout_ms);
+            return MRAA_ERROR_NO_DATA_AVAILABLE;
+        }
+        usleep(5000);
+    }
+}
+
+int
+mraa_uart_ow_read_scratchpads(mraa_uart_ow_context dev, uint8_t* scratchpads, mraa_result_t* results, int max)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "uart_ow: read_scratchpads: context is NULL");
+        return -1;
+    }
+    if (!scratchpads || max < 0) {
+        return -1;
+    }
+    if (!dev->roms && mraa_uart_ow_devices(dev, NULL, 0, 1) < 0) {
+        return -1;
+    }
+
+    int n = dev->roms->count < max ? dev->roms->count : max;
+    int i;
+    for (i = 0; i < n; i++) {
+        // Match ROM, rom code, Read Scratchpad and the 9 read bytes in one block
+        uint8_t buf[MRAA_UART_OW_ROMCODE_SIZE + 2 + MRAA_UART_OW_SCRATCHPAD_SIZE];
+        uint8_t* pad = buf + MRAA_UART_OW_ROMCODE_SIZE + 2;
+        mraa_result_t rv;
+
+        if (!_ow_is_thermometer(dev->roms->ids[i * MRAA_UART_OW_ROMCODE_SIZE])) {
+            // other families would read all ones, which is no reason to search again
+            memset(scratchpads + i * MRAA_UART_OW_SCRATCHPAD_SIZE, 0, MRAA_UART_OW_SCRATCHPAD_SIZE);
+            if (results) {
+                results[i] = MRAA_ERROR_FEATURE_NOT_SUPPORTED;
+            }
+            continue;
+        }
+
+        buf[0] = MRAA_UART_OW_CMD_MATCH_ROM;
+        memcpy(buf + 1, dev->roms->ids + i * MRAA_UART_OW_ROMCODE_SIZE, MRAA_UART_OW_ROMCODE_SIZE);
+        buf[MRAA_UART_OW_ROMCODE_SIZE + 1] = OW_CMD_READ_SCRATCHPAD;
+        memset(pad, 0xff, MRAA_UART_OW_SCRATCHPAD_SIZE);
+
+        rv = mraa_uart_ow_reset(dev);
+        if (rv == MRAA_SUCCESS) {
+            rv = _ow_touch_block(dev, buf, sizeof(buf));
+        }
+        if (rv == MRAA_SUCCESS && mraa_uart_ow_crc8(pad, MRAA_UART_OW_SCRATCHPAD_SIZE) != 0) {
+            rv = MRAA_ERROR_UART_OW_DATA_ERROR;
+        }
+        if (rv == MRAA_SUCCESS) {
+            // an absent device reads as all ones, which has no valid crc
+            memcpy(scratchpads + i * MRAA_UART_OW_SCRATCHPAD_SIZE, pad, MRAA_UART_OW_SCRATCHPAD_SIZE);
+        } else {
+            memset(scratchpads + i * MRAA_UART_OW_SCRATCHPAD_SIZE, 0, MRAA_UART_OW_SCRATCHPAD_SIZE);
+            dev->roms->stale = 1;
+        }
+        if (results) {
+            results[i] = rv;
+        }
+    }
+    return n;
+}
+
+int
+mraa_uart_ow_read_temperatures(mraa_uart_ow_context dev, float* celsius, int max, unsigned int timeout_ms)
+{
+    if (!dev) {
+        syslog(LOG_ERR, "uart_ow: read_temperatures: context is NULL");
+        return -1;
+    }
+    if (!celsius || max < 0) {
+        return -1;
+    }
+    if (max == 0) {
+        return 0;
+    }
+
+    int count = mraa_uart_ow_devices(dev, NULL, 0, 0);
+    if (count <= 0) {
+        return count;
+    }
+    if (mraa_uart_ow_convert_all(dev, timeout_ms) != MRAA_SUCCESS) {
+        return -1;
+    }
+
+    int n = count < max ? count : max;
+    uint8_t* pads = malloc(n * MRAA_UART_OW_SCRATCHPAD_SIZE);
+    mraa_result_t* results = malloc(n * sizeof(mraa_result_t));
+    if (!pads || !results) {
+        syslog(LOG_CRIT, "uart_ow: read_temperatures: Failed to allocate memory for scratchpads");
+        free(pads);
+        free(results);
+        return -1;
+    }
+
+    n = mraa_uart_ow_read_scratchpads(dev, pads, results, n);
+    int i;
+    for (i = 0; i < n; i++) {
+        const uint8_t* pad = pads + i * MRAA_UART_OW_SCRATCHPAD_SIZE;
+        int16_t raw = (int16_t) (pad[0] | (pad[1] << 8));
+        if (results[i] != MRAA_SUCCESS) {
+            celsius[i] = NAN;
+        } else if (dev->roms->ids[i * MRAA_UART_OW_ROMCODE_SIZE] == 0x10) {
+            // DS18S20 reports half degrees
+            celsius[i] = raw / 2.0f;
+        } else {
+            celsius[i] = raw / 16.0f;
+        }
+    }
+
+    free(pads);
+    free(results);
+    return n;
 }
@@ -0,0 +1,390 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gtest/gtest.h"
+#include "mraa_internal_types.h"
+#include "mraa/aio.h"
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+/* MRAA AIO h test fixture */
+class api_aio_h_unit : public ::testing::Test
+{
+};
+
+/*
+ * A stream built by hand over two le:s16/16 channels and an s64 timestamp,
+ * 16 byte scans, read from a pipe in place of /dev/iio:deviceN
+ */
+class api_aio_stream_unit : public ::testing::Test
+{
+  protected:
+    enum { SCAN = 16, SCANS = 64, BUF_SCANS = 32 };
+
+    virtual void
+    SetUp()
+    {
+        memset(chans, 0, sizeof(chans));
+        set_chan(0, 2, 16, 0);
+        set_chan(1, 2, 16, 2);
+        set_chan(2, 8, 64, 8);
+        memset(&iio, 0, sizeof(iio));
+        iio.fp = iio.fp_event = -1;
+        iio.chan_num = 3;
+        iio.channels = chans;
+        iio.datasize = SCAN;
+
+        aio = mraa_aio_init(0);
+        ASSERT_TRUE(aio != NULL);
+        ASSERT_EQ(MRAA_SUCCESS, mraa_aio_set_calibration(aio, 0.5f, -100.0f));
+        pins[0] = pins[1] = aio;
+        index[0] = 0;
+        index[1] = 1;
+        channel[0] = 0;
+        channel[1] = 1;
+        acc[0] = acc[1] = 0;
+
+        memset(&stream, 0, sizeof(stream));
+        stream.iio = &iio;
+        stream.count = 2;
+        stream.index = index;
+        stream.ts_index = 2;
+        stream.channel = channel;
+        stream.pins = pins;
+        stream.acc = acc;
+        stream.decimation = 1;
+        stream.fd = feed = -1;
+        set_buf(BUF_SCANS);
+
+        int fds[2];
+        ASSERT_EQ(0, pipe(fds));
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        stream.fd = fds[0];
+        feed = fds[1];
+
+        data.assign(SCANS * SCAN, 0);
+        for (int s = 0; s < SCANS; s++) {
+            int16_t a = value(0, s);
+            int16_t b = value(1, s);
+            int64_t ts = stamp(s);
+            memcpy(&data[s * SCAN], &a, 2);
+            memcpy(&data[s * SCAN + 2], &b, 2);
+            memcpy(&data[s * SCAN + 8], &ts, 8);
+        }
+    }
+
+    virtual void
+    TearDown()
+    {
+        // the context is not from stream_init, only the pipe and the aio are ours to close
+        if (stream.fd >= 0)
+            close(stream.fd);
+        if (feed >= 0)
+            close(feed);
+        mraa_aio_close(aio);
+    }
+
+    /* Negative and positive samples, odd sums included */
+    static int16_t
+    value(int chan, int s)
+    {
+        return chan == 0 ? (int16_t) ((s * 37) % 11 - 7) : (int16_t) (-((s * s) % 13));
+    }
+
+    /* Uneven spacing so the mid-point differs from a running mean */
+    static int64_t
+    stamp(int s)
+    {
+        return 1000000000LL + s * 1000 + (s * s) % 7;
+    }
+
+    void
+    set_chan(int i, unsigned int bytes, unsigned int bits, unsigned int location)
+    {
+        chans[i].index = i;
+        chans[i].enabled = 1;
+        chans[i].lendian = 1;
+        chans[i].signedd = 1;
+        chans[i].bytes = bytes;
+        chans[i].bits_used = bits;
+        chans[i].location = location;
+    }
+
+    /* Raw scans the stream reads at most at once */
+    void
+    set_buf(int scans)
+    {
+        buf.assign(scans * SCAN, 0);
+        stream.buf = &buf[0];
+        stream.buf_scans = scans;
+    }
+
+    /* Scans first to first + count, written at once so reads see whole scans */
+    void
+    push(int first, int count)
+    {
+        ASSERT_LE((first + count) * SCAN, (int) data.size());
+        ASSERT_EQ(count * SCAN, write(feed, &data[first * SCAN], count * SCAN));
+    }
+
+    /* Expected output of raw scans first to first + n, both channels and the stamp */
+    static void
+    expect(int first, int n, int32_t out[2], int64_t* ts)
+    {
+        for (int c = 0; c < 2; c++) {
+            long sum = 0;
+            for (int s = first; s < first + n; s++)
+                sum += value(c, s);
+            // to nearest with halves away from zero
+            out[c] = (int32_t) std::lround((double) sum / n);
+        }
+        *ts = stamp(first) + (stamp(first + n - 1) - stamp(first)) / 2;
+    }
+
+    mraa_iio_channel chans[3];
+    struct _iio iio;
+    struct _aio_stream stream;
+    mraa_aio_context aio;
+    mraa_aio_context pins[2];
+    int index[2];
+    unsigned int channel[2];
+    int64_t acc[2];
+    std::vector<uint8_t> buf;
+    std::vector<char> data;
+    int feed;
+};
+
+/* Without decimation every scan is decoded as read, across several reads */
+TEST_F(api_aio_stream_unit, test_fill)
+{
+    int32_t values[2 * 16];
+    int64_t ts[16];
+
+    // an empty buffer times out without output
+    ASSERT_EQ(0, mraa_aio_stream_read(&stream, values, ts, 4, 10));
+
+    push(0, 10);
+    ASSERT_EQ(4, mraa_aio_stream_read(&stream, values, ts, 4, 100));
+    // only what is there is returned, no waiting once data came in
+    ASSERT_EQ(6, mraa_aio_stream_read(&stream, values + 8, ts + 4, 12, 100));
+    for (int s = 0; s < 10; s++) {
+        ASSERT_EQ(value(0, s), values[2 * s]) << "scan " << s;
+        ASSERT_EQ(value(1, s), values[2 * s + 1]) << "scan " << s;
+        ASSERT_EQ(stamp(s), ts[s]) << "scan " << s;
+    }
+
+    // reads larger than the scan buffer take several passes
+    set_buf(3);
+    push(10, 8);
+    ASSERT_EQ(8, mraa_aio_stream_read(&stream, values, NULL, 8, 100));
+    for (int s = 0; s < 8; s++) {
+        ASSERT_EQ(value(0, 10 + s), values[2 * s]) << "scan " << s;
+        ASSERT_EQ(value(1, 10 + s), values[2 * s + 1]) << "scan " << s;
+    }
+
+    float units[2 * 2];
+    push(18, 2);
+    ASSERT_EQ(2, mraa_aio_stream_read_calibrated(&stream, units, NULL, 2, 100));
+    for (int s = 0; s < 2; s++) {
+        ASSERT_FLOAT_EQ((value(0, 18 + s) - 100.0f) * 0.5f, units[2 * s]);
+        ASSERT_FLOAT_EQ((value(1, 18 + s) - 100.0f) * 0.5f, units[2 * s + 1]);
+    }
+
+    // a stopped stream refuses to read
+    close(stream.fd);
+    stream.fd = -1;
+    ASSERT_EQ(-1, mraa_aio_stream_read(&stream, values, ts, 1, 0));
+}
+
+/* Boxcar sums are carried across reads when the factor does not divide them */
+TEST_F(api_aio_stream_unit, test_decimation)
+{
+    int32_t values[2 * 8];
+    int64_t ts[8];
+    int32_t want[2];
+    int64_t want_ts;
+
+    stream.decimation = 3;
+    set_buf(8);
+    push(0, 14);
+
+    // 8 raw scans then 4 more, the third output spans both reads
+    ASSERT_EQ(4, mraa_aio_stream_read(&stream, values, ts, 4, 100));
+    for (int o = 0; o < 4; o++) {
+        expect(o * 3, 3, want, &want_ts);
+        ASSERT_EQ(want[0], values[2 * o]) << "output " << o;
+        ASSERT_EQ(want[1], values[2 * o + 1]) << "output " << o;
+        ASSERT_EQ(want_ts, ts[o]) << "output " << o;
+    }
+    ASSERT_EQ(0u, stream.acc_n);
+
+    // two scans are summed but no output is complete, they wait for the third
+    ASSERT_EQ(0, mraa_aio_stream_read(&stream, values, ts, 1, 10));
+    ASSERT_EQ(2u, stream.acc_n);
+    push(14, 1);
+    ASSERT_EQ(1, mraa_aio_stream_read(&stream, values, ts, 1, 100));
+    expect(12, 3, want, &want_ts);
+    ASSERT_EQ(want[0], values[0]);
+    ASSERT_EQ(want[1], values[1]);
+    ASSERT_EQ(want_ts, ts[0]);
+    ASSERT_EQ(0u, stream.acc_n);
+    ASSERT_EQ(0, stream.acc[0]);
+    ASSERT_EQ(0, stream.acc[1]);
+
+    // calibrated outputs use the unrounded mean
+    float units[2];
+    push(15, 3);
+    ASSERT_EQ(1, mraa_aio_stream_read_calibrated(&stream, units, NULL, 1, 100));
+    for (int c = 0; c < 2; c++) {
+        double mean = (value(c, 15) + value(c, 16) + value(c, 17)) / 3.0;
+        ASSERT_FLOAT_EQ((float) ((mean - 100.0) * 0.5), units[c]);
+    }
+}
+
+/* Means of negative sums round to nearest, halves away from zero */
+TEST_F(api_aio_stream_unit, test_decimation_rounding)
+{
+    int32_t values[2 * 16];
+    int32_t want[2];
+    int64_t want_ts;
+    bool half = false;
+
+    stream.decimation = 2;
+    push(0, 32);
+    ASSERT_EQ(16, mraa_aio_stream_read(&stream, values, NULL, 16, 100));
+    for (int o = 0; o < 16; o++) {
+        expect(o * 2, 2, want, &want_ts);
+        ASSERT_EQ(want[0], values[2 * o]) << "output " << o;
+        ASSERT_EQ(want[1], values[2 * o + 1]) << "output " << o;
+        for (int c = 0; c < 2; c++) {
+            int sum = value(c, o * 2) + value(c, o * 2 + 1);
+            half |= sum < 0 && sum % 2 != 0;
+        }
+    }
+    // the data has negative sums ending in a half
+    ASSERT_TRUE(half);
+}
+
+/* The mock ADC is read through replace hooks and has no IIO buffer */
+TEST_F(api_aio_h_unit, test_stream_unsupported)
+{
+    mraa_aio_context aio = mraa_aio_init(0);
+    ASSERT_TRUE(aio != NULL);
+    ASSERT_EQ(NULL, mraa_aio_stream_init(&aio, 1));
+    ASSERT_EQ(NULL, mraa_aio_stream_init(&aio, 0));
+    ASSERT_EQ(NULL, mraa_aio_stream_init(NULL, 1));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_close(aio));
+}
+
+/* Stream calls refuse a NULL context */
+TEST_F(api_aio_h_unit, test_stream_invalid_handle)
+{
+    int32_t values[4];
+    ASSERT_EQ(MRAA_ERROR_INVALID_HANDLE, mraa_aio_stream_set_trigger(NULL, "hrtimer0", 1000));
+    ASSERT_EQ(MRAA_ERROR_INVALID_HANDLE, mraa_aio_stream_set_buffer(NULL, 64, 16));
+    ASSERT_EQ(MRAA_ERROR_INVALID_HANDLE, mraa_aio_stream_start(NULL));
+    ASSERT_EQ(-1, mraa_aio_stream_read(NULL, values, NULL, 1, 0));
+    ASSERT_EQ(MRAA_ERROR_INVALID_HANDLE, mraa_aio_stream_stop(NULL));
+    ASSERT_EQ(MRAA_ERROR_INVALID_HANDLE, mraa_aio_stream_close(NULL));
+}
+
+/* All contexts are read in one call with a shared timestamp */
+TEST_F(api_aio_h_unit, test_read_multi)
+{
+    mraa_aio_context aio = mraa_aio_init(0);
+    ASSERT_TRUE(aio != NULL);
+    mraa_aio_context devs[3] = { aio, aio, aio };
+    int values[3] = { -1, -1, -1 };
+    int64_t ts = 0;
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_read_multi(devs, 3, values, &ts));
+    for (int i = 0; i < 3; i++) {
+        ASSERT_GE(values[i], 0);
+        ASSERT_LT(values[i], 1 << mraa_aio_get_bit(aio));
+    }
+    ASSERT_GT(ts, 0);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_read_multi(devs, 1, values, NULL));
+
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_aio_read_multi(devs, 0, values, NULL));
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_aio_read_multi(devs, 3, NULL, NULL));
+    devs[1] = NULL;
+    ASSERT_EQ(MRAA_ERROR_INVALID_HANDLE, mraa_aio_read_multi(devs, 3, values, NULL));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_close(aio));
+}
+
+/* Linear calibration of a block matches the scalar formula, SIMD and tail */
+TEST_F(api_aio_h_unit, test_convert_linear)
+{
+    mraa_aio_context aio = mraa_aio_init(0);
+    ASSERT_TRUE(aio != NULL);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_set_calibration(aio, 0.5f, -100.0f));
+
+    int32_t raw[11];
+    float units[11];
+    for (int i = 0; i < 11; i++)
+        raw[i] = i * 37 - 50;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_convert(aio, raw, units, 11));
+    for (int i = 0; i < 11; i++)
+        ASSERT_FLOAT_EQ((raw[i] - 100.0f) * 0.5f, units[i]) << "sample " << i;
+
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_aio_convert(aio, NULL, units, 1));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_close(aio));
+}
+
+/* Tables interpolate between points and extend the end segments */
+TEST_F(api_aio_h_unit, test_convert_table)
+{
+    mraa_aio_context aio = mraa_aio_init(0);
+    ASSERT_TRUE(aio != NULL);
+    const float raw_pts[] = { 0.0f, 100.0f, 300.0f };
+    const float unit_pts[] = { 10.0f, 20.0f, 0.0f };
+    const float bad_pts[] = { 0.0f, 100.0f, 100.0f };
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_aio_set_calibration_table(aio, raw_pts, unit_pts, 1));
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_aio_set_calibration_table(aio, bad_pts, unit_pts, 3));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_set_calibration_table(aio, raw_pts, unit_pts, 3));
+
+    int32_t raw[] = { -100, 0, 50, 100, 200, 300, 500 };
+    float expect[] = { 0.0f, 10.0f, 15.0f, 20.0f, 10.0f, 0.0f, -20.0f };
+    float units[7];
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_convert(aio, raw, units, 7));
+    for (int i = 0; i < 7; i++)
+        ASSERT_FLOAT_EQ(expect[i], units[i]) << "raw " << raw[i];
+
+    // a linear calibration replaces the table
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_set_calibration(aio, 2.0f, 0.0f));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_convert(aio, raw, units, 1));
+    ASSERT_FLOAT_EQ(-200.0f, units[0]);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_close(aio));
+}
+
+/* Oversampled and calibrated reads stay within the input range */
+TEST_F(api_aio_h_unit, test_oversampling)
+{
+    mraa_aio_context aio = mraa_aio_init(0);
+    ASSERT_TRUE(aio != NULL);
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_aio_set_oversampling(aio, 0));
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_aio_set_oversampling(aio, 4096));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_set_oversampling(aio, 16));
+
+    int value = mraa_aio_read(aio);
+    ASSERT_GE(value, 0);
+    ASSERT_LT(value, 1024);
+
+    float v = -1.0f;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_set_calibration(aio, 3.3f / 1023, 0.0f));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_read_calibrated(aio, &v));
+    ASSERT_GE(v, 0.0f);
+    ASSERT_LE(v, 3.3f);
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_set_bit(aio, 12));
+    float f = mraa_aio_read_float(aio);
+    ASSERT_GE(f, 0.0f);
+    ASSERT_LE(f, 1.0f);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_aio_close(aio));
+}
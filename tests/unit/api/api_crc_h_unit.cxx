@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gtest/gtest.h"
+#include "mraa/crc.h"
+#include <stdlib.h>
+#include <vector>
+
+/* Bit at a time reference for reflected CRCs up to 32 bits */
+static uint32_t
+reflected(const uint8_t* buf, size_t len, uint32_t crc, uint32_t poly)
+{
+    for (size_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int b = 0; b < 8; b++)
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+    }
+    return crc;
+}
+
+static uint16_t
+ccitt(const uint8_t* buf, size_t len, uint16_t crc)
+{
+    for (size_t i = 0; i < len; i++) {
+        crc ^= buf[i] << 8;
+        for (int b = 0; b < 8; b++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+class api_crc_h_unit : public ::testing::Test
+{
+};
+
+/* Catalogue check values over "123456789" */
+TEST_F(api_crc_h_unit, test_check_values)
+{
+    const uint8_t* check = (const uint8_t*) "123456789";
+    ASSERT_EQ(0xA1, mraa_crc8_maxim(check, 9, 0));
+    ASSERT_EQ(0x4B37, mraa_crc16_ibm(check, 9, 0xFFFF));
+    ASSERT_EQ(0xBB3D, mraa_crc16_ibm(check, 9, 0));
+    ASSERT_EQ(0x29B1, mraa_crc16_ccitt(check, 9, 0xFFFF));
+    ASSERT_EQ(0x31C3, mraa_crc16_ccitt(check, 9, 0));
+    ASSERT_EQ(0xCBF43926u, mraa_crc32(check, 9, 0));
+    ASSERT_EQ(0xE3069283u, mraa_crc32c(check, 9, 0));
+    ASSERT_EQ(0u, mraa_crc32(check, 0, 0));
+}
+
+/* Every length and alignment matches the bitwise reference, also in pieces */
+TEST_F(api_crc_h_unit, test_against_reference)
+{
+    std::vector<uint8_t> data(1024 + 8);
+    srand(42);
+    for (auto& b : data)
+        b = rand() & 0xFF;
+
+    for (size_t off = 0; off < 8; off++) {
+        for (size_t len = 0; len < 300; len += 7) {
+            const uint8_t* p = data.data() + off;
+            ASSERT_EQ(reflected(p, len, 0, 0x8C), mraa_crc8_maxim(p, len, 0));
+            ASSERT_EQ(reflected(p, len, 0xFFFF, 0xA001), mraa_crc16_ibm(p, len, 0xFFFF));
+            ASSERT_EQ(ccitt(p, len, 0xFFFF), mraa_crc16_ccitt(p, len, 0xFFFF));
+            ASSERT_EQ(~reflected(p, len, ~0u, 0xEDB88320), mraa_crc32(p, len, 0));
+            ASSERT_EQ(~reflected(p, len, ~0u, 0x82F63B78), mraa_crc32c(p, len, 0));
+        }
+    }
+
+    size_t split = 333;
+    uint32_t whole = mraa_crc32(data.data(), 1024, 0);
+    ASSERT_EQ(whole, mraa_crc32(data.data() + split, 1024 - split, mraa_crc32(data.data(), split, 0)));
+    whole = mraa_crc32c(data.data(), 1024, 0);
+    ASSERT_EQ(whole, mraa_crc32c(data.data() + split, 1024 - split, mraa_crc32c(data.data(), split, 0)));
+
+    // data followed by its crc checks to zero
+    uint8_t frame[11] = { 0x28, 1, 2, 3, 4, 5, 6 };
+    frame[7] = mraa_crc8_maxim(frame, 7, 0);
+    ASSERT_EQ(0, mraa_crc8_maxim(frame, 8, 0));
+    uint16_t crc = mraa_crc16_ibm(frame, 8, 0xFFFF);
+    frame[8] = crc & 0xFF;
+    frame[9] = crc >> 8;
+    ASSERT_EQ(0, mraa_crc16_ibm(frame, 10, 0xFFFF));
+}
@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gtest/gtest.h"
+#include "mraa_internal_types.h"
+#include "mraa/iio.h"
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <vector>
+
+static pthread_mutex_t batch_lock = PTHREAD_MUTEX_INITIALIZER;
+static std::vector<int> batch_sizes;
+static std::vector<char> batch_data;
+
+static void
+record_batch(char* data, int scans, int64_t timestamp, void* args)
+{
+    int size = *(int*) args;
+    pthread_mutex_lock(&batch_lock);
+    batch_sizes.push_back(scans);
+    batch_data.insert(batch_data.end(), data, data + scans * size);
+    pthread_mutex_unlock(&batch_lock);
+}
+
+/* MRAA IIO h test fixture, scans are decoded against a hand made layout */
+class api_iio_h_unit : public ::testing::Test
+{
+  protected:
+    static const int SCAN = 24;
+    static const int SCANS = 37;
+
+    virtual void
+    SetUp()
+    {
+        memset(chans, 0, sizeof(chans));
+        // le:s16/16>>0 at 0 and 2, le:u12/16>>4 at 4, le:s32/32>>0 at 8, le:s64 at 16
+        set_chan(0, 2, 16, 0, 1, 0);
+        set_chan(1, 2, 16, 0, 1, 2);
+        set_chan(2, 2, 12, 4, 0, 4);
+        set_chan(3, 4, 32, 0, 1, 8);
+        set_chan(4, 8, 64, 0, 1, 16);
+        memset(&dev, 0, sizeof(dev));
+        dev.fp = -1;
+        dev.fp_event = -1;
+        feed = -1;
+        dev.chan_num = 5;
+        dev.channels = chans;
+        dev.datasize = SCAN;
+
+        data.assign(SCAN * SCANS, 0);
+        for (int s = 0; s < SCANS; s++) {
+            char* scan = &data[s * SCAN];
+            int16_t a = (int16_t) (s * 1000 - 18000);
+            int16_t b = (int16_t) (-s * 7);
+            uint16_t c = (uint16_t) (((s * 101) & 0xFFF) << 4 | 0xF);
+            int32_t d = s * 100000 - 1700000;
+            int64_t ts = 1000000000LL + s * 1000;
+            memcpy(scan, &a, 2);
+            memcpy(scan + 2, &b, 2);
+            memcpy(scan + 4, &c, 2);
+            memcpy(scan + 8, &d, 4);
+            memcpy(scan + 16, &ts, 8);
+        }
+    }
+
+    virtual void
+    TearDown()
+    {
+        mraa_iio_close(&dev);
+        if (feed >= 0) {
+            close(feed);
+            feed = -1;
+        }
+    }
+
+    /* Hand the context a pipe in place of /dev/iio:deviceN */
+    void
+    open_feed()
+    {
+        int fds[2];
+        ASSERT_EQ(0, pipe(fds));
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        dev.fp = fds[0];
+        feed = fds[1];
+    }
+
+    /* Scans first to first + count, written at once so the reader sees whole scans */
+    void
+    push(int first, int count)
+    {
+        ASSERT_LE((first + count) * SCAN, (int) data.size());
+        ASSERT_EQ(count * SCAN, write(feed, &data[first * SCAN], count * SCAN));
+    }
+
+    /* Read count scans out of the ring as the reader thread delivers them */
+    void
+    pull(std::vector<char>& out, std::vector<int64_t>& stamps, int count)
+    {
+        out.assign(count * SCAN, 0);
+        stamps.assign(count, 0);
+        int got = 0;
+        for (int i = 0; i < 1000 && got < count; i++) {
+            int n = mraa_iio_ring_read(&dev, &out[got * SCAN], &stamps[got], count - got);
+            ASSERT_GE(n, 0);
+            got += n;
+            if (got < count) {
+                usleep(1000);
+            }
+        }
+        ASSERT_EQ(count, got);
+    }
+
+    void
+    set_chan(int i, unsigned int bytes, unsigned int bits, unsigned int shift, int sign, unsigned int location)
+    {
+        chans[i].index = i;
+        chans[i].enabled = 1;
+        chans[i].lendian = 1;
+        chans[i].signedd = sign;
+        chans[i].bytes = bytes;
+        chans[i].bits_used = bits;
+        chans[i].shift = shift;
+        chans[i].location = location;
+    }
+
+    mraa_iio_channel chans[5];
+    struct _iio dev;
+    std::vector<char> data;
+    int feed;
+};
+
+/* Every layout decodes to the values that were packed */
+TEST_F(api_iio_h_unit, test_demux)
+{
+    std::vector<int32_t> a(SCANS), b(SCANS), c(SCANS), d(SCANS);
+    int32_t* out[] = { &a[0], &b[0], &c[0], &d[0] };
+    int channels[] = { 0, 1, 2, 3 };
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_demux(&dev, &data[0], SCANS, channels, 4, out));
+    for (int s = 0; s < SCANS; s++) {
+        ASSERT_EQ(s * 1000 - 18000, a[s]) << "scan " << s;
+        ASSERT_EQ(-s * 7, b[s]) << "scan " << s;
+        ASSERT_EQ((s * 101) & 0xFFF, c[s]) << "scan " << s;
+        ASSERT_EQ(s * 100000 - 1700000, d[s]) << "scan " << s;
+    }
+
+    int bad[] = { 5 };
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_iio_demux(&dev, &data[0], SCANS, bad, 1, out));
+    chans[1].enabled = 0;
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_iio_demux(&dev, &data[0], SCANS, channels, 2, out));
+}
+
+/* Float conversion applies (raw + offset) * scale on the vector and tail paths */
+TEST_F(api_iio_h_unit, test_demux_float)
+{
+    std::vector<float> a(SCANS), c(SCANS), d(SCANS);
+    float* out[] = { &a[0], &c[0], &d[0] };
+    int channels[] = { 0, 2, 3 };
+    float scale[] = { 0.5f, 2.0f, 0.001f };
+    float offset[] = { 10.0f, -1.0f, 0.0f };
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_demux_float(&dev, &data[0], SCANS, channels, 3, scale, offset, out));
+    for (int s = 0; s < SCANS; s++) {
+        ASSERT_FLOAT_EQ((s * 1000 - 18000 + 10.0f) * 0.5f, a[s]) << "scan " << s;
+        ASSERT_FLOAT_EQ((((s * 101) & 0xFFF) - 1.0f) * 2.0f, c[s]) << "scan " << s;
+        ASSERT_NEAR((s * 100000 - 1700000) * 0.001f, d[s], 0.01f) << "scan " << s;
+    }
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_demux_float(&dev, &data[0], SCANS, channels, 1, NULL, NULL, out));
+    ASSERT_FLOAT_EQ(-18000.0f, a[0]);
+}
+
+/* The mount matrix rotates whole blocks in place */
+TEST_F(api_iio_h_unit, test_mount_matrix)
+{
+    const float mm[9] = { 0, 1, 0, -1, 0, 0, 0, 0, 2 };
+    float x[7], y[7], z[7];
+    for (int i = 0; i < 7; i++) {
+        x[i] = i;
+        y[i] = 10 + i;
+        z[i] = -i;
+    }
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_apply_mount_matrix(mm, x, y, z, 7));
+    for (int i = 0; i < 7; i++) {
+        ASSERT_FLOAT_EQ(10.0f + i, x[i]);
+        ASSERT_FLOAT_EQ(-i, y[i]);
+        ASSERT_FLOAT_EQ(-2.0f * i, z[i]);
+    }
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_iio_apply_mount_matrix(NULL, x, y, z, 7));
+}
+
+/* Two streams resampled between their samples line up with the signal */
+TEST_F(api_iio_h_unit, test_sync_linear)
+{
+    int a = 0, b = 1;
+    float values[2 * 20];
+    int64_t times[20];
+
+    // no sysfs behind this device, scale and offset stay 1 and 0
+    dev.num = 100000;
+    mraa_iio_sync_context sync = mraa_iio_sync_init(400000.0, MRAA_IIO_SYNC_LINEAR);
+    ASSERT_TRUE(sync != NULL);
+    ASSERT_EQ(0, mraa_iio_sync_add_stream(sync, &dev, &a, 1, 4, 64));
+    ASSERT_EQ(1, mraa_iio_sync_add_stream(sync, &dev, &b, 1, 4, 64));
+    ASSERT_EQ(2, mraa_iio_sync_width(sync));
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_sync_push(sync, 0, &data[0], SCANS, 1000036700LL));
+    ASSERT_EQ(0, mraa_iio_sync_read(sync, values, times, 20));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_sync_push(sync, 1, &data[0], SCANS, 1000036900LL));
+
+    // samples every 1000 ns up to 36000, outputs every 2500 ns
+    ASSERT_EQ(15, mraa_iio_sync_read(sync, values, times, 20));
+    for (int k = 0; k < 15; k++) {
+        ASSERT_EQ(1000000000LL + 2500 * k, times[k]) << "tuple " << k;
+        ASSERT_FLOAT_EQ(2500.0f * k - 18000.0f, values[2 * k]) << "tuple " << k;
+        ASSERT_FLOAT_EQ(-17.5f * k, values[2 * k + 1]) << "tuple " << k;
+    }
+    ASSERT_EQ(0, mraa_iio_sync_read(sync, values, times, 20));
+
+    int64_t offset;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_sync_clock_offset(sync, 0, &offset));
+    ASSERT_EQ(700, offset);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_sync_clock_offset(sync, 1, &offset));
+    ASSERT_EQ(900, offset);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_sync_close(sync));
+}
+
+/* Nearest picks a sample as is, and a full stream keeps the newest */
+TEST_F(api_iio_h_unit, test_sync_nearest)
+{
+    int a = 0;
+    float values[8];
+    int64_t times[8];
+
+    dev.num = 100000;
+    mraa_iio_sync_context sync = mraa_iio_sync_init(400000.0, MRAA_IIO_SYNC_NEAREST);
+    ASSERT_TRUE(sync != NULL);
+    ASSERT_EQ(0, mraa_iio_sync_add_stream(sync, &dev, &a, 1, 4, 16));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_sync_push(sync, 0, &data[0], SCANS, 1000037000LL));
+    ASSERT_EQ(21ULL, mraa_iio_sync_overruns(sync, 0));
+
+    // scans 21 to 36 are left, at 21000 to 36000 ns
+    ASSERT_EQ(7, mraa_iio_sync_read(sync, values, times, 8));
+    for (int k = 0; k < 7; k++) {
+        int s = 21 + (5 * k + 1) / 2;
+        ASSERT_EQ(1000021000LL + 2500 * k, times[k]) << "tuple " << k;
+        ASSERT_FLOAT_EQ(s * 1000.0f - 18000.0f, values[k]) << "tuple " << k;
+    }
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_sync_close(sync));
+}
+
+/* The ring keeps scans in order across its end and counts what did not fit */
+TEST_F(api_iio_h_unit, test_ring)
+{
+    std::vector<char> out;
+    std::vector<int64_t> stamps;
+
+    ASSERT_EQ(-1, mraa_iio_ring_read(&dev, &data[0], NULL, 1));
+    open_feed();
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_iio_trigger_buffer_ring(&dev, 0));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_trigger_buffer_ring(&dev, 10));
+    ASSERT_EQ(MRAA_ERROR_NO_RESOURCES, mraa_iio_trigger_buffer_ring(&dev, 10));
+
+    // 6 then 7 at a time wraps the 10 slots, and the counters, many times over
+    int next = 0;
+    for (int round = 0; round < 30; round++) {
+        int count = round % 2 ? 7 : 6;
+        if (next + count > SCANS) {
+            next = 0;
+        }
+        push(next, count);
+        pull(out, stamps, count);
+        ASSERT_EQ(0, memcmp(&out[0], &data[next * SCAN], count * SCAN)) << "round " << round;
+        for (int i = 1; i < count; i++) {
+            ASSERT_GE(stamps[i], stamps[i - 1]);
+        }
+        next += count;
+    }
+    ASSERT_EQ(0ULL, mraa_iio_ring_overruns(&dev));
+    ASSERT_EQ(0, mraa_iio_ring_read(&dev, &out[0], NULL, 1));
+
+    // 15 into a ring of 10 keeps the first 10 and drops the rest
+    push(0, 15);
+    for (int i = 0; i < 1000 && mraa_iio_ring_overruns(&dev) < 5; i++) {
+        usleep(1000);
+    }
+    ASSERT_EQ(5ULL, mraa_iio_ring_overruns(&dev));
+    out.assign(20 * SCAN, 0);
+    ASSERT_EQ(10, mraa_iio_ring_read(&dev, &out[0], NULL, 20));
+    ASSERT_EQ(0, memcmp(&out[0], &data[0], 10 * SCAN));
+    ASSERT_EQ(0, mraa_iio_ring_read(&dev, &out[0], NULL, 20));
+}
+
+/* The batch callback gets whole scans, as many per call as the read buffer holds */
+TEST_F(api_iio_h_unit, test_batch)
+{
+    int size = SCAN;
+    batch_sizes.clear();
+    batch_data.clear();
+
+    open_feed();
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_iio_trigger_buffer_batch(&dev, NULL, NULL));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_trigger_buffer_batch(&dev, record_batch, &size));
+
+    // more than the 128 scan read buffer, in one write the reader sees at once
+    std::vector<char> many;
+    for (int i = 0; i < 4; i++) {
+        many.insert(many.end(), data.begin(), data.end());
+    }
+    ASSERT_LE((int) many.size(), PIPE_BUF);
+    ASSERT_EQ((ssize_t) many.size(), write(feed, &many[0], many.size()));
+
+    size_t got = 0;
+    for (int i = 0; i < 1000 && got < many.size(); i++) {
+        usleep(1000);
+        pthread_mutex_lock(&batch_lock);
+        got = batch_data.size();
+        pthread_mutex_unlock(&batch_lock);
+    }
+    ASSERT_EQ(MRAA_SUCCESS, mraa_iio_close(&dev));
+
+    ASSERT_EQ(many, batch_data);
+    ASSERT_EQ(2u, batch_sizes.size());
+    ASSERT_EQ(128, batch_sizes[0]);
+    ASSERT_EQ(4 * SCANS - 128, batch_sizes[1]);
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gtest/gtest.h"
+#include "mraa_internal_types.h"
+#include "mraa/led_strip.h"
+#include <cstring>
+#include <vector>
+
+static std::vector<std::vector<uint8_t> > sent;
+
+/* Stands in for the mock spi transfer and keeps every message */
+static mraa_result_t
+record_transfer(mraa_spi_context dev, uint8_t* data, uint8_t* rxbuf, int length)
+{
+    sent.push_back(std::vector<uint8_t>(data, data + length));
+    return MRAA_SUCCESS;
+}
+
+/* MRAA LED strip h test fixture */
+class api_led_strip_h_unit : public ::testing::Test
+{
+};
+
+/* Expected bitstream for one data byte, four spi bits per data bit */
+static void
+encode_ref(uint8_t* out, uint8_t v)
+{
+    for (int bit = 7; bit >= 0; bit -= 2) {
+        uint8_t hi = (v >> bit) & 1 ? 0xE0 : 0x80;
+        uint8_t lo = (v >> (bit - 1)) & 1 ? 0x0E : 0x08;
+        *out++ = hi | lo;
+    }
+}
+
+/* Pixels are sent G R B with each bit stretched to a 4 bit symbol */
+TEST_F(api_led_strip_h_unit, test_render_ws2812)
+{
+    mraa_led_strip_context dev = mraa_led_strip_init(0, 1, MRAA_LED_STRIP_WS2812);
+    ASSERT_TRUE(dev != NULL);
+    int size = mraa_led_strip_frame_size(dev);
+    ASSERT_GT(size, 12);
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_set_pixel(dev, 0, 0xFF, 0x00, 0x0F, 0xAA));
+    std::vector<uint8_t> frame(size, 0x55);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_render(dev, frame.data()));
+
+    uint8_t expect[12];
+    encode_ref(expect + 0, 0x00);
+    encode_ref(expect + 4, 0xFF);
+    encode_ref(expect + 8, 0x0F);
+    for (int i = 0; i < 12; i++)
+        ASSERT_EQ(expect[i], frame[i]) << "byte " << i;
+    for (int i = 12; i < size; i++)
+        ASSERT_EQ(0, frame[i]) << "reset byte " << i;
+
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_led_strip_set_pixel(dev, 1, 0, 0, 0, 0));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_close(dev));
+}
+
+/* Long RGBW strips exercise the vector encoder and brightness scaling */
+TEST_F(api_led_strip_h_unit, test_render_rgbw_brightness)
+{
+    const int count = 37;
+    mraa_led_strip_context dev = mraa_led_strip_init(0, count, MRAA_LED_STRIP_SK6812_RGBW);
+    ASSERT_TRUE(dev != NULL);
+    for (int i = 0; i < count; i++)
+        ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_set_pixel(dev, i, i * 5, i * 3, 255 - i, i ^ 0x5A));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_set_brightness(dev, 128));
+
+    std::vector<uint8_t> frame(mraa_led_strip_frame_size(dev));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_render(dev, frame.data()));
+    for (int i = 0; i < count; i++) {
+        uint8_t wire[4] = { (uint8_t)(i * 3), (uint8_t)(i * 5), (uint8_t)(255 - i), (uint8_t)(i ^ 0x5A) };
+        for (int c = 0; c < 4; c++) {
+            uint8_t expect[4];
+            encode_ref(expect, (uint8_t)((wire[c] * 128 + 127) / 255));
+            for (int k = 0; k < 4; k++)
+                ASSERT_EQ(expect[k], frame[(i * 4 + c) * 4 + k]) << "led " << i << " channel " << c;
+        }
+    }
+    ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_close(dev));
+}
+
+/* Frames are queued to the sender thread and flushed through mock spi */
+TEST_F(api_led_strip_h_unit, test_show_flush)
+{
+    mraa_led_strip_context dev = mraa_led_strip_init(0, 300, MRAA_LED_STRIP_WS2812);
+    ASSERT_TRUE(dev != NULL);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_set_gamma(dev, 2.2f));
+    for (int n = 0; n < 10; n++) {
+        ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_fill(dev, n, 255 - n, n * 2, 0));
+        ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_show(dev));
+    }
+    ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_flush(dev));
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_led_strip_set_gamma(dev, 0.0f));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_close(dev));
+}
+
+/* Every frame leaves as one spi message holding the encoded pixels and the reset */
+TEST_F(api_led_strip_h_unit, test_show_sent)
+{
+    // the longest RGB strip whose frame fits the default 4096 byte bufsiz
+    const int count = 331;
+    mraa_led_strip_context dev = mraa_led_strip_init(0, count, MRAA_LED_STRIP_WS2812);
+    ASSERT_TRUE(dev != NULL);
+    mraa_adv_func_t func;
+    memcpy(&func, dev->spi->advance_func, sizeof(func));
+    func.spi_transfer_buf_replace = record_transfer;
+    dev->spi->advance_func = &func;
+    sent.clear();
+
+    for (int n = 0; n < 3; n++) {
+        for (int i = 0; i < count; i++)
+            ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_set_pixel(dev, i, i + n, 0xF0, i ^ 0x33, 0));
+        ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_show(dev));
+    }
+    ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_flush(dev));
+
+    ASSERT_EQ(3u, sent.size());
+    for (int n = 0; n < 3; n++) {
+        ASSERT_EQ((size_t) mraa_led_strip_frame_size(dev), sent[n].size());
+        for (int i = 0; i < count; i++) {
+            uint8_t wire[3] = { 0xF0, (uint8_t)(i + n), (uint8_t)(i ^ 0x33) };
+            for (int c = 0; c < 3; c++) {
+                uint8_t expect[4];
+                encode_ref(expect, wire[c]);
+                for (int k = 0; k < 4; k++)
+                    ASSERT_EQ(expect[k], sent[n][(i * 3 + c) * 4 + k]) << "frame " << n << " led " << i;
+            }
+        }
+        for (size_t i = count * 12; i < sent[n].size(); i++)
+            ASSERT_EQ(0, sent[n][i]) << "reset byte " << i;
+    }
+    ASSERT_EQ(MRAA_SUCCESS, mraa_led_strip_close(dev));
+}
+
+/* A frame longer than one spidev message is refused rather than split */
+TEST_F(api_led_strip_h_unit, test_frame_too_long)
+{
+    ASSERT_TRUE(mraa_led_strip_init(0, 332, MRAA_LED_STRIP_WS2812) == NULL);
+    ASSERT_TRUE(mraa_led_strip_init(0, 1 << 30, MRAA_LED_STRIP_WS2812) == NULL);
+}
+
+/* Invalid arguments are rejected */
+TEST_F(api_led_strip_h_unit, test_invalid)
+{
+    ASSERT_TRUE(mraa_led_strip_init(0, 0, MRAA_LED_STRIP_WS2812) == NULL);
+    ASSERT_TRUE(mraa_led_strip_init(0, 4, (mraa_led_strip_type_t) 7) == NULL);
+    ASSERT_EQ(-1, mraa_led_strip_frame_size(NULL));
+    ASSERT_EQ(MRAA_ERROR_INVALID_HANDLE, mraa_led_strip_show(NULL));
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gtest/gtest.h"
+#include "mraa/modbus.h"
+#include <atomic>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <stdlib.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static uint16_t
+crc16(const uint8_t* buf, int len)
+{
+    uint16_t crc = 0xFFFF;
+    for (int i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+        }
+    }
+    return crc;
+}
+
+/*
+ * Simulated slaves on the master side of a pty. Slaves 1 and 2 hold 100
+ * registers each with value slave * 1000 + address, slave 3 answers with
+ * exception 2, slave 4 never answers and slave 5 sends a broken CRC.
+ * Slave 6 serves the registers of slave 1 in two bursts 10 ms apart,
+ * like a USB serial adapter.
+ */
+class api_modbus_h_unit : public ::testing::Test
+{
+  protected:
+    int master;
+    mraa_uart_context uart;
+    mraa_modbus_context dev;
+    std::thread slave;
+    std::atomic<bool> stop;
+    uint16_t regs[3][100];
+
+    virtual void
+    SetUp()
+    {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        ASSERT_GE(master, 0);
+        ASSERT_EQ(0, grantpt(master));
+        ASSERT_EQ(0, unlockpt(master));
+        uart = mraa_uart_init_raw(ptsname(master));
+        ASSERT_TRUE(uart != NULL);
+        ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_baudrate(uart, 115200));
+        dev = mraa_modbus_init(uart);
+        ASSERT_TRUE(dev != NULL);
+        ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_set_timeout(dev, 50));
+
+        for (int s = 1; s < 3; s++) {
+            for (int a = 0; a < 100; a++) {
+                regs[s][a] = s * 1000 + a;
+            }
+        }
+        stop = false;
+        slave = std::thread(&api_modbus_h_unit::serve, this);
+    }
+
+    virtual void
+    TearDown()
+    {
+        stop = true;
+        slave.join();
+        mraa_modbus_close(dev);
+        mraa_uart_stop(uart);
+        close(master);
+    }
+
+    bool
+    read_exact(uint8_t* buf, int len)
+    {
+        int n = 0;
+        while (n < len) {
+            struct pollfd pfd = { master, POLLIN, 0 };
+            if (poll(&pfd, 1, 20) <= 0) {
+                if (stop) {
+                    return false;
+                }
+                continue;
+            }
+            int got = read(master, buf + n, len - n);
+            if (got <= 0) {
+                return false;
+            }
+            n += got;
+        }
+        return true;
+    }
+
+    void
+    reply(uint8_t* adu, int len, bool corrupt = false, bool split = false)
+    {
+        uint16_t crc = crc16(adu, len);
+        adu[len] = crc & 0xFF;
+        adu[len + 1] = (crc >> 8) ^ (corrupt ? 0x55 : 0);
+        int first = split ? 4 : 0;
+        if (first > 0) {
+            ASSERT_EQ(first, write(master, adu, first));
+            usleep(10000);
+        }
+        ASSERT_EQ(len + 2 - first, write(master, adu + first, len + 2 - first));
+    }
+
+    void
+    serve()
+    {
+        uint8_t req[260];
+        uint8_t resp[260];
+
+        while (!stop) {
+            if (!read_exact(req, 8)) {
+                return;
+            }
+            int len = 8;
+            if (req[1] == 0x10) {
+                if (!read_exact(req + 8, req[6] + 1)) {
+                    return;
+                }
+                len = 9 + req[6];
+            }
+            if (crc16(req, len) != 0) {
+                continue;
+            }
+
+            uint8_t id = req[0];
+            uint16_t addr = req[2] << 8 | req[3];
+            uint16_t count = req[4] << 8 | req[5];
+            resp[0] = id;
+            resp[1] = req[1];
+            if (id == 3) {
+                resp[1] |= 0x80;
+                resp[2] = 0x02;
+                reply(resp, 3);
+            } else if (id == 1 || id == 2 || id == 5 || id == 6) {
+                int s = id == 5 || id == 6 ? 1 : id;
+                if (req[1] == 0x03 || req[1] == 0x04) {
+                    resp[2] = count * 2;
+                    for (int i = 0; i < count; i++) {
+                        resp[3 + 2 * i] = regs[s][addr + i] >> 8;
+                        resp[4 + 2 * i] = regs[s][addr + i] & 0xFF;
+                    }
+                    reply(resp, 3 + count * 2, id == 5, id == 6);
+                } else if (req[1] == 0x06) {
+                    regs[s][addr] = count;
+                    memcpy(resp, req, 6);
+                    reply(resp, 6);
+                } else if (req[1] == 0x10) {
+                    for (int i = 0; i < count; i++) {
+                        regs[s][addr + i] = req[7 + 2 * i] << 8 | req[8 + 2 * i];
+                    }
+                    memcpy(resp, req, 6);
+                    reply(resp, 6);
+                }
+            }
+        }
+    }
+};
+
+/* Register reads and writes round trip through the simulated slave */
+TEST_F(api_modbus_h_unit, test_registers)
+{
+    uint16_t values[10];
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_read_holding_registers(dev, 1, 10, 10, values));
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(1010 + i, values[i]);
+    }
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_read_input_registers(dev, 2, 0, 3, values));
+    ASSERT_EQ(2000, values[0]);
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_write_register(dev, 1, 5, 0xBEEF));
+    uint16_t block[3] = { 7, 8, 9 };
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_write_registers(dev, 2, 40, 3, block));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_read_holding_registers(dev, 1, 5, 1, values));
+    ASSERT_EQ(0xBEEF, values[0]);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_read_holding_registers(dev, 2, 40, 3, values));
+    ASSERT_EQ(8, values[1]);
+
+    // raw transaction returns the response PDU
+    uint8_t pdu[5] = { 0x03, 0x00, 0x01, 0x00, 0x01 };
+    uint8_t resp[16];
+    ASSERT_EQ(4, mraa_modbus_transact(dev, 2, pdu, sizeof(pdu), resp, sizeof(resp)));
+    ASSERT_EQ(0x03, resp[0]);
+    ASSERT_EQ(2, resp[1]);
+}
+
+/* A known length reply is waited for across gaps longer than 3.5 chars */
+TEST_F(api_modbus_h_unit, test_burst_reply)
+{
+    uint16_t values[8];
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_read_holding_registers(dev, 6, 20, 8, values));
+    for (int i = 0; i < 8; i++) {
+        ASSERT_EQ(1020 + i, values[i]);
+    }
+}
+
+/* Exceptions, timeouts and corrupt frames are told apart and counted */
+TEST_F(api_modbus_h_unit, test_errors_and_stats)
+{
+    uint16_t values[2];
+    ASSERT_EQ(MRAA_ERROR_MODBUS_EXCEPTION, mraa_modbus_read_holding_registers(dev, 3, 0, 2, values));
+    ASSERT_EQ(2, mraa_modbus_last_exception(dev));
+    ASSERT_EQ(MRAA_ERROR_NO_DATA_AVAILABLE, mraa_modbus_read_holding_registers(dev, 4, 0, 2, values));
+    ASSERT_EQ(MRAA_ERROR_MODBUS_FRAME, mraa_modbus_read_holding_registers(dev, 5, 0, 2, values));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_read_holding_registers(dev, 1, 0, 2, values));
+    ASSERT_EQ(0, mraa_modbus_last_exception(dev));
+
+    mraa_modbus_stats_t stats;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_get_stats(dev, 3, &stats));
+    ASSERT_EQ(1ULL, stats.requests);
+    ASSERT_EQ(1ULL, stats.exceptions);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_get_stats(dev, 4, &stats));
+    ASSERT_EQ(1ULL, stats.timeouts);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_get_stats(dev, 5, &stats));
+    ASSERT_EQ(1ULL, stats.crc_errors);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_get_stats(dev, 1, &stats));
+    ASSERT_EQ(1ULL, stats.responses);
+    ASSERT_LE(stats.min_latency_us, stats.max_latency_us);
+}
+
+struct poll_sink {
+    std::mutex lock;
+    int results[3] = { 0, 0, 0 };
+    int failures = 0;
+};
+
+static void
+on_poll(uint8_t slave, uint8_t function, uint16_t address, const uint16_t* values, int count, mraa_result_t result, void* args)
+{
+    poll_sink* sink = (poll_sink*) args;
+    std::lock_guard<std::mutex> guard(sink->lock);
+    if (result != MRAA_SUCCESS || count != 4 || values[0] != slave * 1000 + address) {
+        sink->failures++;
+        return;
+    }
+    sink->results[slave]++;
+}
+
+/* The poller keeps both slaves busy */
+TEST_F(api_modbus_h_unit, test_poll_scheduler)
+{
+    poll_sink sink;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_poll_add(dev, 1, 0x03, 20, 4, 0, on_poll, &sink));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_poll_add(dev, 2, 0x04, 30, 4, 0, on_poll, &sink));
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_modbus_poll_add(dev, 2, 0x06, 30, 4, 0, on_poll, &sink));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_poll_start(dev));
+    usleep(200000);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_modbus_poll_stop(dev));
+
+    std::lock_guard<std::mutex> guard(sink.lock);
+    ASSERT_EQ(0, sink.failures);
+    ASSERT_GT(sink.results[1], 5);
+    ASSERT_GT(sink.results[2], 5);
+    ASSERT_LE(abs(sink.results[1] - sink.results[2]), 1);
+}
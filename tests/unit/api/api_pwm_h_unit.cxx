@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gtest/gtest.h"
+#include "mraa_internal.h"
+#include "mraa/pwm.h"
+#include <cstring>
+#include <unistd.h>
+#include <vector>
+
+static std::vector<int> written;
+
+static mraa_result_t
+record_write(mraa_pwm_context dev, float duty)
+{
+    written.push_back((int) duty);
+    return MRAA_SUCCESS;
+}
+
+static float
+read_off(mraa_pwm_context dev)
+{
+    return 0.0f;
+}
+
+/* Ramps for 20 updates, stalling the player on the first few */
+static int
+slow_gen(unsigned long long index, mraa_pwm_step_t* step, void* args)
+{
+    std::vector<unsigned long long>* calls = (std::vector<unsigned long long>*) args;
+    calls->push_back(index);
+    if (index >= 20) {
+        return 0;
+    }
+    if (calls->size() <= 3) {
+        usleep(5000);
+    }
+    step->period_ns = 1000000;
+    step->duty_ns = (int) index * 50000;
+    return 1;
+}
+
+/* MRAA PWM h test fixture, the sequence player writes through platform hooks */
+class api_pwm_h_unit : public ::testing::Test
+{
+  protected:
+    enum { PERIOD = 1000000 };
+
+    virtual void
+    SetUp()
+    {
+        memset(&func, 0, sizeof(func));
+        func.pwm_write_replace = record_write;
+        func.pwm_read_replace = read_off;
+        memset(&dev, 0, sizeof(dev));
+        dev.pin = 0;
+        dev.duty_fp = -1;
+        dev.period = PERIOD;
+        dev.advance_func = &func;
+        written.clear();
+
+        // generated steps are checked against the platform range
+        min_period = plat->pwm_min_period;
+        max_period = plat->pwm_max_period;
+        plat->pwm_min_period = 1;
+        plat->pwm_max_period = 1000000;
+    }
+
+    virtual void
+    TearDown()
+    {
+        mraa_pwm_seq_stop(&dev);
+        plat->pwm_min_period = min_period;
+        plat->pwm_max_period = max_period;
+    }
+
+    mraa_adv_func_t func;
+    struct _pwm dev;
+    int min_period;
+    int max_period;
+};
+
+/* Invalid sequences are refused before anything is started */
+TEST_F(api_pwm_h_unit, test_seq_invalid)
+{
+    float duty[2] = { 0.5f, 0.5f };
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_pwm_seq_play(&dev, NULL, 2, 100, MRAA_PWM_SEQ_LOOP, 0));
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_pwm_seq_play(&dev, duty, 0, 100, MRAA_PWM_SEQ_LOOP, 0));
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_pwm_seq_play(&dev, duty, 2, 0, MRAA_PWM_SEQ_LOOP, 0));
+    ASSERT_TRUE(dev.seq == NULL);
+    ASSERT_EQ(MRAA_ERROR_INVALID_HANDLE, mraa_pwm_seq_wait(&dev, 0));
+}
+
+/* A one-shot ramp is written in order and ends on its last step */
+TEST_F(api_pwm_h_unit, test_seq_oneshot)
+{
+    float duty[10];
+    for (int i = 0; i < 10; i++) {
+        duty[i] = (i + 1) / 10.0f;
+    }
+    ASSERT_EQ(MRAA_SUCCESS, mraa_pwm_seq_play(&dev, duty, 10, 1000, MRAA_PWM_SEQ_ONESHOT, 0));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_pwm_seq_wait(&dev, 2000));
+
+    mraa_pwm_seq_stats_t stats;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_pwm_seq_get_stats(&dev, &stats));
+    ASSERT_EQ(0, (int) stats.errors);
+    ASSERT_EQ(stats.updates, written.size());
+    ASSERT_GE(stats.max_lateness_ns, 0);
+
+    // a late thread skips steps, but every step is either written or missed
+    size_t step = 0;
+    for (size_t i = 0; i < written.size(); i++) {
+        while (step < 10 && (int) (duty[step] * PERIOD) != written[i]) {
+            step++;
+        }
+        ASSERT_LT(step, 10u);
+        step++;
+    }
+    ASSERT_EQ(10, (int) (stats.updates + stats.missed));
+    ASSERT_EQ(PERIOD, written.back());
+}
+
+/* A crossfade blends from the current output over the given time */
+TEST_F(api_pwm_h_unit, test_seq_crossfade)
+{
+    float duty[8];
+    for (int i = 0; i < 8; i++) {
+        duty[i] = 1.0f;
+    }
+    // 4 ms at 1 kHz fades over the first four updates, starting from 0
+    ASSERT_EQ(MRAA_SUCCESS, mraa_pwm_seq_play(&dev, duty, 8, 1000, MRAA_PWM_SEQ_ONESHOT, 4));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_pwm_seq_wait(&dev, 2000));
+
+    mraa_pwm_seq_stats_t stats;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_pwm_seq_get_stats(&dev, &stats));
+    for (size_t i = 0; i < written.size(); i++) {
+        ASSERT_EQ(0, written[i] % (PERIOD / 4));
+        if (i > 0) {
+            ASSERT_GE(written[i], written[i - 1]);
+        }
+    }
+    ASSERT_EQ(PERIOD, written.back());
+    ASSERT_EQ(8, (int) (stats.updates + stats.missed));
+    if (stats.missed == 0) {
+        ASSERT_EQ(PERIOD / 4, written[0]);
+        ASSERT_EQ(PERIOD / 2, written[1]);
+        ASSERT_EQ(PERIOD / 4 * 3, written[2]);
+        ASSERT_EQ(PERIOD, written[3]);
+    }
+}
+
+/* A looping sequence keeps going until stopped, and owns the context meanwhile */
+TEST_F(api_pwm_h_unit, test_seq_loop)
+{
+    float duty[2] = { 0.25f, 0.75f };
+    ASSERT_EQ(MRAA_SUCCESS, mraa_pwm_seq_play(&dev, duty, 2, 500, MRAA_PWM_SEQ_LOOP, 0));
+    ASSERT_EQ(MRAA_ERROR_NO_DATA_AVAILABLE, mraa_pwm_seq_wait(&dev, 0));
+
+    mraa_pwm_seq_stats_t stats;
+    for (int i = 0; i < 500; i++) {
+        ASSERT_EQ(MRAA_SUCCESS, mraa_pwm_seq_get_stats(&dev, &stats));
+        if (stats.updates >= 4) {
+            break;
+        }
+        usleep(10000);
+    }
+    ASSERT_GE(stats.updates, 4ULL);
+    ASSERT_GT(stats.rate_hz, 0.0f);
+
+    ASSERT_EQ(MRAA_ERROR_INVALID_RESOURCE, mraa_pwm_write(&dev, 0.5f));
+    ASSERT_EQ(MRAA_ERROR_INVALID_RESOURCE, mraa_pwm_config(&dev, PERIOD, 0));
+    ASSERT_EQ(MRAA_ERROR_INVALID_RESOURCE, mraa_pwm_enable(&dev, 0));
+    float now = mraa_pwm_read(&dev);
+    ASSERT_TRUE(now == 0.25f || now == 0.75f);
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_pwm_seq_stop(&dev));
+    ASSERT_TRUE(dev.seq == NULL);
+    for (size_t i = 0; i < written.size(); i++) {
+        ASSERT_TRUE(written[i] == PERIOD / 4 || written[i] == PERIOD / 4 * 3);
+    }
+}
+
+/* A generator that keeps the player late has the skipped updates counted */
+TEST_F(api_pwm_h_unit, test_seq_gen_late)
+{
+    std::vector<unsigned long long> calls;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_pwm_seq_play_gen(&dev, slow_gen, &calls, 1000, 0));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_pwm_seq_wait(&dev, 2000));
+
+    mraa_pwm_seq_stats_t stats;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_pwm_seq_get_stats(&dev, &stats));
+    ASSERT_EQ(0, (int) stats.errors);
+    ASSERT_EQ(calls.size() - 1, stats.updates);
+    ASSERT_EQ(stats.updates, written.size());
+
+    // every index up to the final one was either generated or missed
+    ASSERT_GE(calls.back(), 20ULL);
+    ASSERT_EQ(calls.back() + 1 - calls.size(), stats.missed);
+    // three 5 ms stalls at 1 kHz cannot all be absorbed
+    ASSERT_GT(stats.missed, 0ULL);
+    ASSERT_GE(stats.max_lateness_ns, 0LL);
+    ASSERT_GT(stats.rate_hz, 0.0f);
+}
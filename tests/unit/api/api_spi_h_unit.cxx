@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gtest/gtest.h"
+#include "mraa/spi.h"
+#include <cstring>
+#include <time.h>
+#include <unistd.h>
+
+/* MRAA SPI h test fixture */
+class api_spi_h_unit : public ::testing::Test
+{
+  protected:
+    mraa_spi_context dev;
+
+    virtual void
+    SetUp()
+    {
+        dev = mraa_spi_init(0);
+        ASSERT_TRUE(dev != NULL);
+    }
+
+    virtual void
+    TearDown()
+    {
+        mraa_spi_stop(dev);
+    }
+};
+
+/* A timer driven stream fills the ring with timestamped transfers */
+TEST_F(api_spi_h_unit, test_stream_timer)
+{
+    uint8_t tx[3] = { 0x01, 0x02, 0x03 };
+    uint8_t rx[64 * 3];
+    mraa_timestamp_t stamps[64];
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_spi_stream_start(dev, tx, sizeof(tx), 1000, 64));
+    ASSERT_NE(MRAA_SUCCESS, mraa_spi_stream_start(dev, tx, sizeof(tx), 1000, 64));
+    usleep(30000);
+
+    int count = mraa_spi_stream_read(dev, rx, stamps, 64);
+    ASSERT_GT(count, 0);
+    for (int i = 0; i < count; i++) {
+        // the same buffer goes out every time so the same reply comes back
+        ASSERT_EQ(0, memcmp(rx, rx + i * 3, 3));
+        if (i > 0) {
+            ASSERT_GT(stamps[i], stamps[i - 1]);
+        }
+    }
+
+    mraa_spi_stream_stats_t stats;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_spi_stream_get_stats(dev, &stats));
+    ASSERT_GE(stats.transfers, (unsigned long long) count);
+    ASSERT_EQ(0, stats.errors);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_spi_stream_stop(dev));
+    ASSERT_EQ(-1, mraa_spi_stream_read(dev, rx, stamps, 64));
+}
+
+/* A ring that is not drained reports overruns instead of overwriting */
+TEST_F(api_spi_h_unit, test_stream_overrun)
+{
+    uint8_t tx[1] = { 0x5A };
+    uint8_t rx[4];
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_spi_stream_start(dev, tx, sizeof(tx), 500, 3));
+    usleep(20000);
+
+    mraa_spi_stream_stats_t stats;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_spi_stream_get_stats(dev, &stats));
+    ASSERT_GT(stats.overruns, 0);
+    // a depth of 3 is rounded up to 4 slots
+    ASSERT_EQ(4, mraa_spi_stream_read(dev, rx, NULL, 8));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_spi_stream_stop(dev));
+}
+
+/* Rings beyond the depth limit are refused before rounding */
+TEST_F(api_spi_h_unit, test_stream_depth_limit)
+{
+    uint8_t tx[1] = { 0x5A };
+
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_spi_stream_start(dev, tx, sizeof(tx), 500, 0));
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_spi_stream_start(dev, tx, sizeof(tx), 500, (1u << 20) + 1));
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_spi_stream_start(dev, tx, sizeof(tx), 500, 0x80000001u));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_spi_stream_start(dev, tx, sizeof(tx), 500, 4));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_spi_stream_stop(dev));
+}
+
+/* Stopping does not wait for the next period of a slow stream */
+TEST_F(api_spi_h_unit, test_stream_stop)
+{
+    uint8_t tx[1] = { 0x5A };
+    struct timespec start, end;
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_spi_stream_start(dev, tx, sizeof(tx), 5000000, 4));
+    usleep(10000);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_spi_stream_stop(dev));
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ASSERT_LT(end.tv_sec - start.tv_sec, 2);
+}
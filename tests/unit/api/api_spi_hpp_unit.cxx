@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "mraa/spi.hpp"
+#include "gtest/gtest.h"
+#include <vector>
+
+/* MRAA SPI hpp test fixture */
+class api_spi_hpp_unit : public ::testing::Test
+{
+};
+
+/* Transfer into caller owned vectors matches single byte writes */
+TEST_F(api_spi_hpp_unit, test_transfer_vector)
+{
+    mraa::Spi spi(0);
+    std::vector<uint8_t> tx = { 0x00, 0x55, 0xAA, 0xFF };
+    std::vector<uint8_t> rx;
+
+    ASSERT_EQ(mraa::SUCCESS, spi.transfer(tx, rx));
+    ASSERT_EQ(tx.size(), rx.size());
+    for (size_t i = 0; i < tx.size(); i++) {
+        ASSERT_EQ(spi.writeByte(tx[i]), rx[i]);
+    }
+
+    /* A second transfer reuses the receive storage */
+    const uint8_t* storage = rx.data();
+    ASSERT_EQ(mraa::SUCCESS, spi.transfer(tx, rx));
+    ASSERT_EQ(storage, rx.data());
+}
+
+/* Word transfer into caller owned vectors matches single word writes */
+TEST_F(api_spi_hpp_unit, test_transfer_word_vector)
+{
+    mraa::Spi spi(0);
+    std::vector<uint16_t> tx = { 0x0000, 0x1234, 0xFFFF };
+    std::vector<uint16_t> rx;
+
+    ASSERT_EQ(mraa::SUCCESS, spi.transfer_word(tx, rx));
+    ASSERT_EQ(tx.size(), rx.size());
+    for (size_t i = 0; i < tx.size(); i++) {
+        ASSERT_EQ(spi.writeWord(tx[i]), rx[i]);
+    }
+}
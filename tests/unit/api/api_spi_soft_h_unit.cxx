@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gtest/gtest.h"
+#include "mraa_internal.h"
+#include <cstring>
+#include <vector>
+
+/* MRAA SPI software conversion test fixture, on a context built in the test */
+class api_spi_soft_h_unit : public ::testing::Test
+{
+  protected:
+    // long enough for the SIMD paths plus a tail
+    static const int LEN = 40;
+
+    virtual void
+    SetUp()
+    {
+        memset(&dev, 0, sizeof(dev));
+        for (int i = 0; i < LEN; i++) {
+            data[i] = (uint8_t) (i * 37 + 11);
+        }
+    }
+
+    /* Value of the word at p in host order */
+    static uint32_t
+    load(const uint8_t* p, int bytes)
+    {
+        if (bytes == 4) {
+            uint32_t v;
+            memcpy(&v, p, 4);
+            return v;
+        }
+        if (bytes == 2) {
+            uint16_t v;
+            memcpy(&v, p, 2);
+            return v;
+        }
+        return *p;
+    }
+
+    /* Bits on the wire when words of the given size go out in the given order */
+    static std::vector<int>
+    shift_out(const uint8_t* buf, int len, int bits, bool lsb)
+    {
+        std::vector<int> wire;
+        for (int i = 0; i + bits / 8 <= len; i += bits / 8) {
+            uint32_t v = load(buf + i, bits / 8);
+            for (int b = 0; b < bits; b++) {
+                wire.push_back((v >> (lsb ? b : bits - 1 - b)) & 1);
+            }
+        }
+        return wire;
+    }
+
+    /* What the caller asked for must be what the controller sends after conversion */
+    void
+    check(int bits)
+    {
+        uint8_t out[LEN];
+        mraa_spi_soft_convert(&dev, out, data, LEN);
+        int hw_bits = dev.soft_word16 ? 8 : dev.bpw;
+        bool hw_lsb = dev.soft_lsb ? false : dev.lsb;
+        ASSERT_EQ(shift_out(data, LEN, bits, dev.lsb), shift_out(out, LEN, hw_bits, hw_lsb));
+
+        uint8_t back[LEN];
+        mraa_spi_soft_convert(&dev, back, out, LEN);
+        ASSERT_EQ(0, memcmp(back, data, LEN));
+    }
+
+    struct _spi dev;
+    uint8_t data[LEN];
+};
+
+/* 8 bit words lsb first on a msb only controller */
+TEST_F(api_spi_soft_h_unit, test_soft_lsb_8)
+{
+    dev.bpw = 8;
+    dev.lsb = 1;
+    dev.soft_lsb = 1;
+    check(8);
+
+    uint8_t one = 0x01, out;
+    mraa_spi_soft_convert(&dev, &out, &one, 1);
+    ASSERT_EQ(0x80, out);
+}
+
+/* 16 bit words lsb first on a controller with 16 bit words but no lsb first */
+TEST_F(api_spi_soft_h_unit, test_soft_lsb_16)
+{
+    dev.bpw = 16;
+    dev.lsb = 1;
+    dev.soft_lsb = 1;
+    check(16);
+
+    // 0x0001 must be shifted out as 10000000 00000000
+    uint16_t word = 0x0001, out;
+    mraa_spi_soft_convert(&dev, (uint8_t*) &out, (const uint8_t*) &word, 2);
+    ASSERT_EQ(0x8000, out);
+}
+
+/* 32 bit words lsb first on a msb only controller */
+TEST_F(api_spi_soft_h_unit, test_soft_lsb_32)
+{
+    dev.bpw = 32;
+    dev.lsb = 1;
+    dev.soft_lsb = 1;
+    check(32);
+}
+
+/* 16 bit words as byte pairs, msb first */
+TEST_F(api_spi_soft_h_unit, test_soft_word16_msb)
+{
+    dev.bpw = 8;
+    dev.soft_word16 = 1;
+    check(16);
+
+    uint16_t word = 0x0102;
+    uint8_t out[2];
+    mraa_spi_soft_convert(&dev, out, (const uint8_t*) &word, 2);
+    ASSERT_EQ(0x01, out[0]);
+    ASSERT_EQ(0x02, out[1]);
+}
+
+/* 16 bit words as byte pairs, lsb first with and without hardware lsb first */
+TEST_F(api_spi_soft_h_unit, test_soft_word16_lsb)
+{
+    dev.bpw = 8;
+    dev.lsb = 1;
+    dev.soft_word16 = 1;
+    check(16);
+
+    dev.soft_lsb = 1;
+    check(16);
+
+    uint16_t word = 0x0001;
+    uint8_t out[2];
+    mraa_spi_soft_convert(&dev, out, (const uint8_t*) &word, 2);
+    ASSERT_EQ(0x80, out[0]);
+    ASSERT_EQ(0x00, out[1]);
+}
@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gtest/gtest.h"
+#include "mraa/uart.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <stdlib.h>
+#include <string>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+/* MRAA UART h test fixture, the port is the slave side of a pty */
+class api_uart_h_unit : public ::testing::Test
+{
+  protected:
+    int master;
+    mraa_uart_context dev;
+
+    virtual void
+    SetUp()
+    {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        ASSERT_GE(master, 0);
+        ASSERT_EQ(0, grantpt(master));
+        ASSERT_EQ(0, unlockpt(master));
+        dev = mraa_uart_init_raw(ptsname(master));
+        ASSERT_TRUE(dev != NULL);
+    }
+
+    virtual void
+    TearDown()
+    {
+        mraa_uart_stop(dev);
+        close(master);
+    }
+
+    void
+    send(const std::string& data)
+    {
+        ASSERT_EQ((ssize_t) data.size(), write(master, data.data(), data.size()));
+    }
+
+    /* Read exactly len bytes from the master side, waiting up to a second */
+    std::string
+    read_master(size_t len)
+    {
+        std::string out;
+        char buf[64];
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (out.size() < len && std::chrono::steady_clock::now() < deadline) {
+            struct pollfd pfd = { master, POLLIN, 0 };
+            if (poll(&pfd, 1, 10) > 0) {
+                ssize_t n = read(master, buf, std::min(sizeof(buf), len - out.size()));
+                if (n > 0) {
+                    out.append(buf, n);
+                }
+            }
+        }
+        return out;
+    }
+
+    /* Pop the next frame, waiting up to a second for it */
+    std::string
+    pop()
+    {
+        const uint8_t* data;
+        for (int i = 0; i < 1000; i++) {
+            int len = mraa_uart_async_pop(dev, &data);
+            if (len > 0) {
+                return std::string((const char*) data, len);
+            }
+            usleep(1000);
+        }
+        return "<timeout>";
+    }
+};
+
+struct frame_sink {
+    std::mutex lock;
+    std::vector<std::string> frames;
+    int batches = 0;
+};
+
+static void
+collect(const mraa_uart_frame_t* frames, int count, void* args)
+{
+    frame_sink* sink = (frame_sink*) args;
+    std::lock_guard<std::mutex> guard(sink->lock);
+    for (int i = 0; i < count; i++) {
+        sink->frames.push_back(std::string((const char*) frames[i].data, frames[i].length));
+    }
+    sink->batches++;
+}
+
+/* Delimited frames are split, empty ones skipped and partial ones held back */
+TEST_F(api_uart_h_unit, test_async_delimiter)
+{
+    const uint8_t* data;
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_async_start(dev, MRAA_UART_FRAME_DELIMITER, '\n', 256, NULL, NULL));
+    ASSERT_NE(MRAA_SUCCESS, mraa_uart_async_start(dev, MRAA_UART_FRAME_RAW, 0, 256, NULL, NULL));
+    char buf[4];
+    ASSERT_EQ(-1, mraa_uart_read(dev, buf, sizeof(buf)));
+
+    send("abc\nde\n\nfg");
+    ASSERT_EQ("abc", pop());
+    ASSERT_EQ("de", pop());
+    usleep(10000);
+    ASSERT_EQ(0, mraa_uart_async_pop(dev, &data));
+    send("h\n");
+    ASSERT_EQ("fgh", pop());
+
+    mraa_uart_async_stats_t stats;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_async_get_stats(dev, &stats));
+    ASSERT_EQ(12ULL, stats.bytes);
+    ASSERT_EQ(3ULL, stats.frames);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_async_stop(dev));
+}
+
+/* Frames keep their content when they wrap around a small ring */
+TEST_F(api_uart_h_unit, test_async_wrap)
+{
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_async_start(dev, MRAA_UART_FRAME_DELIMITER, ';', 16, NULL, NULL));
+    for (int i = 0; i < 50; i++) {
+        std::string frame = std::to_string(i * 7919);
+        send(frame + ";");
+        ASSERT_EQ(frame, pop());
+    }
+}
+
+/* Length prefixed frames, including one too large for the ring */
+TEST_F(api_uart_h_unit, test_async_length)
+{
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_uart_async_start(dev, MRAA_UART_FRAME_LENGTH, 0, 64, NULL, NULL));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_async_start(dev, MRAA_UART_FRAME_LENGTH, 2, 64, NULL, NULL));
+
+    send(std::string("\x00\x03" "abc", 5));
+    send(std::string("\x00\x00", 2));
+    send(std::string("\x00\x50", 2) + std::string(0x50, 'x'));
+    send(std::string("\x00\x02" "yz", 4));
+    ASSERT_EQ("abc", pop());
+    ASSERT_EQ("yz", pop());
+
+    mraa_uart_async_stats_t stats;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_async_get_stats(dev, &stats));
+    ASSERT_EQ(1ULL, stats.errors);
+}
+
+/* SLIP escapes are undone */
+TEST_F(api_uart_h_unit, test_async_slip)
+{
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_async_start(dev, MRAA_UART_FRAME_SLIP, 0, 64, NULL, NULL));
+    send(std::string("\xC0" "a\xDB\xDC" "b\xDB\xDD" "c\xC0", 9));
+    ASSERT_EQ(std::string("a\xC0" "b\xDB" "c", 5), pop());
+}
+
+/* COBS frames are decoded and delivered in batches to the callback */
+TEST_F(api_uart_h_unit, test_async_cobs_callback)
+{
+    frame_sink sink;
+    const uint8_t* data;
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_async_start(dev, MRAA_UART_FRAME_COBS, 0, 128, collect, &sink));
+    ASSERT_EQ(-1, mraa_uart_async_pop(dev, &data));
+
+    // 11 22 00 33 and a frame made of a single zero, then a broken frame
+    send(std::string("\x03\x11\x22\x02\x33\x00" "\x01\x01\x00" "\x05\x11\x00", 12));
+    for (int i = 0; i < 1000; i++) {
+        std::lock_guard<std::mutex> guard(sink.lock);
+        if (sink.frames.size() >= 2) {
+            break;
+        }
+        usleep(1000);
+    }
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_async_stop(dev));
+
+    ASSERT_EQ(2u, sink.frames.size());
+    ASSERT_EQ(std::string("\x11\x22\x00\x33", 4), sink.frames[0]);
+    ASSERT_EQ(std::string("\x00", 1), sink.frames[1]);
+    ASSERT_GE(sink.batches, 1);
+}
+
+/* One poll set reports which of several ports became ready */
+TEST_F(api_uart_h_unit, test_poll_set)
+{
+    int master2 = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_GE(master2, 0);
+    ASSERT_EQ(0, grantpt(master2));
+    ASSERT_EQ(0, unlockpt(master2));
+    mraa_uart_context dev2 = mraa_uart_init_raw(ptsname(master2));
+    ASSERT_TRUE(dev2 != NULL);
+
+    mraa_uart_poll_set set = mraa_uart_poll_set_create();
+    ASSERT_TRUE(set != NULL);
+    int tag1 = 1, tag2 = 2;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_poll_set_add(set, dev, MRAA_UART_POLL_READABLE, &tag1));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_poll_set_add(set, dev2, MRAA_UART_POLL_READABLE, &tag2));
+    ASSERT_NE(MRAA_SUCCESS, mraa_uart_poll_set_add(set, dev2, MRAA_UART_POLL_READABLE, NULL));
+
+    mraa_uart_poll_event_t events[4];
+    ASSERT_EQ(0, mraa_uart_poll_set_wait(set, events, 4, 10));
+
+    ASSERT_EQ(1, write(master2, "x", 1));
+    ASSERT_EQ(1, mraa_uart_poll_set_wait(set, events, 4, 1000));
+    ASSERT_TRUE(events[0].uart == dev2);
+    ASSERT_EQ(&tag2, events[0].user);
+    ASSERT_EQ((unsigned int) MRAA_UART_POLL_READABLE, events[0].events);
+
+    char c;
+    ASSERT_EQ(1, mraa_uart_read(dev2, &c, 1));
+    ASSERT_EQ(0, mraa_uart_poll_set_wait(set, events, 4, 10));
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_poll_set_modify(set, dev, MRAA_UART_POLL_READABLE | MRAA_UART_POLL_WRITABLE));
+    ASSERT_EQ(1, mraa_uart_poll_set_wait(set, events, 4, 1000));
+    ASSERT_TRUE(events[0].uart == dev);
+    ASSERT_TRUE(events[0].events & MRAA_UART_POLL_WRITABLE);
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_poll_set_remove(set, dev));
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_uart_poll_set_remove(set, dev));
+    ASSERT_EQ(0, mraa_uart_poll_set_wait(set, events, 4, 10));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_poll_set_destroy(set));
+
+    mraa_uart_stop(dev2);
+    close(master2);
+}
+
+/* data_available works on descriptors select() cannot handle */
+TEST_F(api_uart_h_unit, test_data_available_high_fd)
+{
+    std::vector<int> fillers;
+    while (fillers.size() < 1100) {
+        int fd = open("/dev/null", O_RDONLY);
+        if (fd < 0) {
+            break;
+        }
+        fillers.push_back(fd);
+    }
+
+    mraa_uart_context high = mraa_uart_init_raw(ptsname(master));
+    for (int fd : fillers) {
+        close(fd);
+    }
+    ASSERT_TRUE(high != NULL);
+
+    ASSERT_EQ(0, mraa_uart_data_available(high, 10));
+    ASSERT_EQ(1, write(master, "x", 1));
+    ASSERT_EQ(1, mraa_uart_data_available(high, 1000));
+    mraa_uart_stop(high);
+}
+
+/* Rates without a Bxxx constant go through termios2 and read back */
+TEST_F(api_uart_h_unit, test_baudrate)
+{
+    unsigned int baud = 0;
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_get_baudrate(dev, &baud));
+    ASSERT_EQ(9600u, baud);
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_baudrate(dev, 250000));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_get_baudrate(dev, &baud));
+    ASSERT_EQ(250000u, baud);
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_baudrate(dev, 115200));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_get_baudrate(dev, &baud));
+    ASSERT_EQ(115200u, baud);
+
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_uart_set_baudrate(dev, 0));
+}
+
+/* Low latency falls back to termios tuning on drivers without TIOCSSERIAL */
+TEST_F(api_uart_h_unit, test_low_latency)
+{
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_low_latency(dev, 1));
+    ASSERT_EQ(1, write(master, "x", 1));
+    char c = 0;
+    ASSERT_EQ(1, mraa_uart_read(dev, &c, 1));
+    ASSERT_EQ('x', c);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_low_latency(dev, 0));
+}
+
+/* Disabling low latency puts back the read settings it replaced */
+TEST_F(api_uart_h_unit, test_low_latency_restore)
+{
+    // the slave side shares its termios with the port
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    ASSERT_GE(slave, 0);
+    struct termios termio;
+    ASSERT_EQ(0, tcgetattr(slave, &termio));
+    termio.c_lflag |= ICANON;
+    termio.c_cc[VMIN] = 0;
+    termio.c_cc[VTIME] = 5;
+    ASSERT_EQ(0, tcsetattr(slave, TCSANOW, &termio));
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_low_latency(dev, 1));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_low_latency(dev, 1));
+    ASSERT_EQ(0, tcgetattr(slave, &termio));
+    ASSERT_EQ(0u, termio.c_lflag & ICANON);
+    ASSERT_EQ(1, termio.c_cc[VMIN]);
+    ASSERT_EQ(0, termio.c_cc[VTIME]);
+
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_low_latency(dev, 0));
+    ASSERT_EQ(0, tcgetattr(slave, &termio));
+    ASSERT_NE(0u, termio.c_lflag & ICANON);
+    ASSERT_EQ(0, termio.c_cc[VMIN]);
+    ASSERT_EQ(5, termio.c_cc[VTIME]);
+
+    // nothing saved, nothing to restore
+    termio.c_cc[VTIME] = 7;
+    ASSERT_EQ(0, tcsetattr(slave, TCSANOW, &termio));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_low_latency(dev, 0));
+    ASSERT_EQ(0, tcgetattr(slave, &termio));
+    ASSERT_EQ(7, termio.c_cc[VTIME]);
+    close(slave);
+}
+
+struct write_sink {
+    std::mutex lock;
+    std::condition_variable sent;
+    unsigned int bytes = 0;
+
+    /* Wait up to a second for the writer to report total bytes sent */
+    bool
+    wait(unsigned int total)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        return sent.wait_for(guard, std::chrono::seconds(1), [&] { return bytes >= total; }) && bytes == total;
+    }
+};
+
+static void
+write_done(unsigned int bytes, void* args)
+{
+    write_sink* sink = (write_sink*) args;
+    std::lock_guard<std::mutex> guard(sink->lock);
+    sink->bytes += bytes;
+    sink->sent.notify_all();
+}
+
+/* Small writes are queued and leave in one go */
+TEST_F(api_uart_h_unit, test_write_buffer)
+{
+    write_sink sink;
+    char buf[64];
+
+    ASSERT_EQ(MRAA_ERROR_INVALID_RESOURCE, mraa_uart_set_write_callback(dev, write_done, &sink));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_write_buffer(dev, 16));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_write_callback(dev, write_done, &sink));
+
+    ASSERT_EQ(5, mraa_uart_write(dev, "hello", 5));
+    ASSERT_EQ(1, mraa_uart_write(dev, " ", 1));
+    ASSERT_EQ(6, mraa_uart_output_pending(dev));
+    ASSERT_EQ(0, fcntl(master, F_SETFL, O_NONBLOCK));
+    ASSERT_EQ(-1, read(master, buf, sizeof(buf)));
+    ASSERT_EQ(0, mraa_uart_write_flush(dev));
+    ASSERT_TRUE(sink.wait(6));
+    ASSERT_EQ("hello ", read_master(6));
+
+    // overflowing the queue sends queue and new data together
+    ASSERT_EQ(10, mraa_uart_write(dev, "0123456789", 10));
+    ASSERT_EQ(10, mraa_uart_write(dev, "abcdefghij", 10));
+    ASSERT_TRUE(sink.wait(26));
+    ASSERT_EQ("0123456789abcdefghij", read_master(20));
+
+    ASSERT_EQ(3, mraa_uart_write(dev, "xyz", 3));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_write_buffer(dev, 0));
+    ASSERT_TRUE(sink.wait(29));
+    ASSERT_EQ("xyz", read_master(3));
+}
+
+/* A pty has no RS-485 support, so enabling without a DE gpio is refused */
+TEST_F(api_uart_h_unit, test_rs485_unsupported)
+{
+    ASSERT_EQ(MRAA_ERROR_FEATURE_NOT_SUPPORTED, mraa_uart_set_rs485(dev, 1, -1, 0));
+    ASSERT_EQ(MRAA_UART_RS485_OFF, mraa_uart_get_rs485_mode(dev));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_rs485(dev, 0, -1, 0));
+
+    const char* path = mraa_uart_get_dev_path(dev);
+    unsigned int enabled = 1;
+    ASSERT_EQ(MRAA_ERROR_FEATURE_NOT_SUPPORTED, mraa_uart_rs485_settings(-1, &path, &enabled, NULL, NULL));
+
+    // the port keeps working in full duplex
+    char buf[8];
+    ASSERT_EQ(4, mraa_uart_write(dev, "full", 4));
+    usleep(10000);
+    ASSERT_EQ(4, read(master, buf, sizeof(buf)));
+}
@@ -0,0 +1,461 @@
+/*
+ * Copyright (c) 2026 ADLINK Technology Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gtest/gtest.h"
+#include "mraa/uart_ow.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/* Dallas CRC8, bit by bit, to build valid rom codes and scratchpads */
+static uint8_t
+crc8(const uint8_t* buf, int len)
+{
+    uint8_t crc = 0;
+    for (int i = 0; i < len; i++) {
+        uint8_t data = buf[i];
+        for (int b = 0; b < 8; b++) {
+            uint8_t mix = (crc ^ data) & 0x01;
+            crc >>= 1;
+            if (mix)
+                crc ^= 0x8C;
+            data >>= 1;
+        }
+    }
+    return crc;
+}
+
+/*
+ * A DS18B20 style device, fed one timeslot at a time. slot() gets the bit
+ * the master drove and returns the bit the device leaves on the bus, 0
+ * meaning it pulled the line low.
+ */
+struct ow_device {
+    enum { ROM_CMD, MATCH, SEARCH, READ_ROM, FUNC_CMD, READ_SCRATCH, BUSY, IDLE } state;
+    uint8_t rom[8];
+    uint8_t scratch[9];
+    int16_t temp;
+    int bit;
+    uint8_t acc;
+    int converts;
+    int busy;
+
+    ow_device(uint8_t serial, int16_t t, uint8_t family = 0x28)
+    : state(IDLE), temp(t), bit(0), acc(0), converts(0), busy(0)
+    {
+        rom[0] = family;
+        for (int i = 1; i < 7; i++)
+            rom[i] = serial * (i + 3);
+        rom[7] = crc8(rom, 7);
+        memset(scratch, 0, sizeof(scratch));
+    }
+
+    void
+    reset()
+    {
+        state = ROM_CMD;
+        bit = 0;
+        acc = 0;
+    }
+
+    // devices finish converting at different times
+    int
+    serial_delay()
+    {
+        return rom[1] % 64;
+    }
+
+    int
+    rom_bit(int n)
+    {
+        return (rom[n / 8] >> (n % 8)) & 1;
+    }
+
+    bool
+    take(int in)
+    {
+        acc |= in << bit;
+        return ++bit == 8;
+    }
+
+    int
+    slot(int in)
+    {
+        switch (state) {
+            case ROM_CMD:
+                if (take(in)) {
+                    bit = 0;
+                    if (acc == 0x55)
+                        state = MATCH;
+                    else if (acc == 0xCC)
+                        state = FUNC_CMD;
+                    else if (acc == 0xF0)
+                        state = SEARCH;
+                    else if (acc == 0x33)
+                        state = READ_ROM;
+                    else
+                        state = IDLE;
+                    acc = 0;
+                }
+                return 1;
+            case MATCH:
+                if (in != rom_bit(bit)) {
+                    state = IDLE;
+                } else if (++bit == 64) {
+                    state = FUNC_CMD;
+                    bit = 0;
+                }
+                return 1;
+            case SEARCH: {
+                // three slots per rom bit: bit, complement, master choice
+                int n = bit / 3;
+                int step = bit % 3;
+                bit++;
+                if (step == 0)
+                    return rom_bit(n);
+                if (step == 1)
+                    return !rom_bit(n);
+                if (in != rom_bit(n) || n == 63)
+                    state = IDLE;
+                return 1;
+            }
+            case READ_ROM: {
+                int out = rom_bit(bit);
+                if (++bit == 64)
+                    state = IDLE;
+                return out;
+            }
+            case FUNC_CMD:
+                if (take(in)) {
+                    bit = 0;
+                    if (rom[0] != 0x28) {
+                        // an id chip or eeprom knows no thermometer commands
+                        state = IDLE;
+                    } else if (acc == 0x44) {
+                        converts++;
+                        scratch[0] = temp & 0xFF;
+                        scratch[1] = temp >> 8;
+                        scratch[2] = 0x4B;
+                        scratch[3] = 0x46;
+                        scratch[4] = 0x7F;
+                        scratch[5] = 0xFF;
+                        scratch[6] = 0x0C;
+                        scratch[7] = 0x10;
+                        scratch[8] = crc8(scratch, 8);
+                        busy = 100 + serial_delay();
+                        state = BUSY;
+                    } else if (acc == 0xBE) {
+                        state = READ_SCRATCH;
+                    } else {
+                        state = IDLE;
+                    }
+                    acc = 0;
+                }
+                return 1;
+            case READ_SCRATCH: {
+                int out = (scratch[bit / 8] >> (bit % 8)) & 1;
+                if (++bit == 72)
+                    state = IDLE;
+                return out;
+            }
+            case BUSY:
+                // read slots stay low until the conversion is done
+                if (busy > 0) {
+                    busy--;
+                    return 0;
+                }
+                return 1;
+            default:
+                return 1;
+        }
+    }
+};
+
+class api_uart_ow_h_unit : public ::testing::Test
+{
+  protected:
+    int master;
+    mraa_uart_ow_context dev;
+    std::thread bus;
+    std::atomic<bool> stop;
+    std::atomic<bool> mute;
+    std::mutex lock;
+    std::vector<ow_device> devices;
+    int resets;
+    int exchanges;
+
+    virtual void
+    SetUp()
+    {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        ASSERT_GE(master, 0);
+        ASSERT_EQ(0, grantpt(master));
+        ASSERT_EQ(0, unlockpt(master));
+        dev = mraa_uart_ow_init_raw(ptsname(master));
+        ASSERT_TRUE(dev != NULL);
+
+        devices.push_back(ow_device(0x11, 0x0191)); // 25.0625 C
+        devices.push_back(ow_device(0x22, 0xFF5E)); // -10.125 C
+        devices.push_back(ow_device(0x33, 0x0550)); // 85 C
+        resets = 0;
+        exchanges = 0;
+        stop = false;
+        mute = false;
+        bus = std::thread(&api_uart_ow_h_unit::serve, this);
+    }
+
+    virtual void
+    TearDown()
+    {
+        stop = true;
+        bus.join();
+        mraa_uart_ow_stop(dev);
+        close(master);
+    }
+
+    void
+    serve()
+    {
+        uint8_t buf[1024];
+        while (!stop) {
+            struct pollfd pfd = { master, POLLIN, 0 };
+            if (poll(&pfd, 1, 20) <= 0)
+                continue;
+            int n = read(master, buf, sizeof(buf));
+            if (n <= 0 || mute)
+                continue;
+            std::lock_guard<std::mutex> guard(lock);
+            exchanges++;
+            for (int i = 0; i < n; i++) {
+                if (buf[i] == 0xF0) {
+                    // reset pulse at 9600 baud, answer with a presence pulse
+                    resets++;
+                    for (auto& d : devices)
+                        d.reset();
+                    buf[i] = devices.empty() ? 0xF0 : 0xE0;
+                    continue;
+                }
+                // a master 0 holds the line low whatever the devices do
+                int in = buf[i] == 0xFF;
+                int out = in;
+                for (auto& d : devices)
+                    out &= d.slot(in);
+                buf[i] = out ? 0xFF : 0xFC;
+            }
+            ASSERT_EQ(n, write(master, buf, n));
+        }
+    }
+};
+
+/* Reading a scratchpad takes one exchange for the command and one for the data */
+TEST_F(api_uart_ow_h_unit, test_block_read_scratchpad)
+{
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_ow_command(dev, 0x44, devices[1].rom));
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        exchanges = 0;
+    }
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_ow_command(dev, 0xBE, devices[1].rom));
+    uint8_t scratch[9];
+    memset(scratch, 0xFF, sizeof(scratch));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_ow_block(dev, scratch, sizeof(scratch)));
+    ASSERT_EQ(0, mraa_uart_ow_crc8(scratch, 9));
+    ASSERT_EQ(0x5E, scratch[0]);
+    ASSERT_EQ(0xFF, scratch[1]);
+
+    std::lock_guard<std::mutex> guard(lock);
+    // reset, rom selection plus command, scratchpad
+    ASSERT_LE(exchanges, 4);
+    ASSERT_EQ(1, devices[1].converts);
+    ASSERT_EQ(0, devices[0].converts);
+}
+
+/* Single byte and bit helpers keep working on top of the block path */
+TEST_F(api_uart_ow_h_unit, test_read_rom_bytes)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        devices.erase(devices.begin() + 1, devices.end());
+    }
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_ow_reset(dev));
+    ASSERT_EQ(0x33, mraa_uart_ow_write_byte(dev, 0x33));
+    uint8_t rom[8];
+    for (int i = 0; i < 4; i++)
+        rom[i] = mraa_uart_ow_read_byte(dev);
+    for (int i = 4; i < 8; i++) {
+        uint8_t byte = 0;
+        for (int b = 0; b < 8; b++)
+            byte |= mraa_uart_ow_bit(dev, 1) << b;
+        rom[i] = byte;
+    }
+    ASSERT_EQ(0, memcmp(rom, devices[0].rom, 8));
+}
+
+/* The search walks all devices on the bus */
+TEST_F(api_uart_ow_h_unit, test_rom_search)
+{
+    uint8_t id[8];
+    int found = 0;
+    mraa_boolean_t start = 1;
+    while (mraa_uart_ow_rom_search(dev, start, id) == MRAA_SUCCESS) {
+        start = 0;
+        ASSERT_EQ(0, mraa_uart_ow_crc8(id, 8));
+        bool known = false;
+        for (auto& d : devices)
+            known |= memcmp(d.rom, id, 8) == 0;
+        ASSERT_TRUE(known);
+        found++;
+        ASSERT_LE(found, 3);
+    }
+    ASSERT_EQ(3, found);
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        devices.clear();
+    }
+    ASSERT_EQ(MRAA_ERROR_UART_OW_NO_DEVICES, mraa_uart_ow_reset(dev));
+}
+
+/* A silent bus fails within the configured timeout without spinning */
+TEST_F(api_uart_ow_h_unit, test_timeout)
+{
+    ASSERT_EQ(MRAA_ERROR_INVALID_PARAMETER, mraa_uart_ow_set_timeout(dev, -1, 10));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_ow_set_timeout(dev, 30, 20));
+    mute = true;
+
+    struct timespec cpu0, cpu1;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu0);
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(MRAA_ERROR_NO_DATA_AVAILABLE, mraa_uart_ow_reset(dev));
+    ASSERT_EQ(-1, mraa_uart_ow_read_byte(dev));
+    auto wall = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu1);
+    long long cpu_ms = (cpu1.tv_sec - cpu0.tv_sec) * 1000 + (cpu1.tv_nsec - cpu0.tv_nsec) / 1000000;
+
+    ASSERT_GE(wall, 50);
+    ASSERT_LT(wall, 500);
+    ASSERT_LT(cpu_ms, wall / 2);
+
+    // the bus answers again once it is back
+    mute = false;
+    usleep(30000);
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_ow_reset(dev));
+}
+
+/* All sensors convert together and are read in one pass */
+TEST_F(api_uart_ow_h_unit, test_bulk_temperatures)
+{
+    uint8_t ids[4 * MRAA_UART_OW_ROMCODE_SIZE];
+    ASSERT_EQ(3, mraa_uart_ow_devices(dev, ids, 4, 0));
+
+    // nothing asked for, nothing converted
+    float temps[4];
+    ASSERT_EQ(0, mraa_uart_ow_read_temperatures(dev, temps, 0, 750));
+    ASSERT_EQ(3, mraa_uart_ow_read_temperatures(dev, temps, 4, 750));
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (int i = 0; i < 3; i++) {
+            ow_device* d = NULL;
+            for (auto& e : devices)
+                if (memcmp(e.rom, ids + i * 8, 8) == 0)
+                    d = &e;
+            ASSERT_TRUE(d != NULL);
+            ASSERT_FLOAT_EQ(d->temp / 16.0f, temps[i]);
+            ASSERT_EQ(1, d->converts);
+        }
+    }
+
+    // the cache is used while presence does not change
+    int resets_before;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        resets_before = resets;
+    }
+    ASSERT_EQ(3, mraa_uart_ow_devices(dev, NULL, 0, 0));
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        ASSERT_EQ(resets_before + 1, resets);
+        // a sensor drops off the bus
+        devices.erase(devices.begin());
+    }
+
+    uint8_t pads[3 * MRAA_UART_OW_SCRATCHPAD_SIZE];
+    mraa_result_t results[3];
+    ASSERT_EQ(3, mraa_uart_ow_read_scratchpads(dev, pads, results, 3));
+    int failed = 0;
+    for (int i = 0; i < 3; i++)
+        failed += results[i] != MRAA_SUCCESS;
+    ASSERT_EQ(1, failed);
+
+    // the failure invalidates the cache, the next call searches again
+    ASSERT_EQ(2, mraa_uart_ow_devices(dev, NULL, 0, 0));
+    ASSERT_EQ(2, mraa_uart_ow_read_temperatures(dev, temps, 4, 750));
+    ASSERT_FALSE(std::isnan(temps[0]));
+    ASSERT_FALSE(std::isnan(temps[1]));
+
+    // sensors still converting past the timeout are reported
+    ASSERT_EQ(MRAA_ERROR_NO_DATA_AVAILABLE, mraa_uart_ow_convert_all(dev, 0));
+}
+
+/* Devices that are not thermometers are skipped without a new search */
+TEST_F(api_uart_ow_h_unit, test_mixed_bus)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        devices.push_back(ow_device(0x44, 0, 0x01)); // DS2401 silicon serial number
+        devices.push_back(ow_device(0x55, 0, 0x2D)); // DS2431 eeprom
+    }
+    uint8_t ids[5 * MRAA_UART_OW_ROMCODE_SIZE];
+    ASSERT_EQ(5, mraa_uart_ow_devices(dev, ids, 5, 1));
+
+    float temps[5];
+    ASSERT_EQ(5, mraa_uart_ow_read_temperatures(dev, temps, 5, 750));
+    int resets_before;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (int i = 0; i < 5; i++) {
+            if (ids[i * 8] != 0x28) {
+                ASSERT_TRUE(std::isnan(temps[i]));
+                continue;
+            }
+            ow_device* d = NULL;
+            for (auto& e : devices)
+                if (memcmp(e.rom, ids + i * 8, 8) == 0)
+                    d = &e;
+            ASSERT_TRUE(d != NULL);
+            ASSERT_FLOAT_EQ(d->temp / 16.0f, temps[i]);
+        }
+        resets_before = resets;
+    }
+
+    uint8_t pads[5 * MRAA_UART_OW_SCRATCHPAD_SIZE];
+    mraa_result_t results[5];
+    ASSERT_EQ(5, mraa_uart_ow_read_scratchpads(dev, pads, results, 5));
+    for (int i = 0; i < 5; i++) {
+        if (ids[i * 8] == 0x28) {
+            ASSERT_EQ(MRAA_SUCCESS, results[i]);
+        } else {
+            ASSERT_EQ(MRAA_ERROR_FEATURE_NOT_SUPPORTED, results[i]);
+            for (int j = 0; j < MRAA_UART_OW_SCRATCHPAD_SIZE; j++)
+                ASSERT_EQ(0, pads[i * MRAA_UART_OW_SCRATCHPAD_SIZE + j]);
+        }
+    }
+
+    // one reset per thermometer, then one presence check and no search
+    ASSERT_EQ(5, mraa_uart_ow_devices(dev, NULL, 0, 0));
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        ASSERT_EQ(resets_before + 3 + 1, resets);
+    }
+}
@@ -109,6 +109,36 @@ TEST_F(mraa_initio_h_unit, test_uart_init)
     ASSERT_EQ(status, MRAA_SUCCESS);
 }
 
+/* Test for RS-485 UART init, the mock UART has no driver RS-485 support. */
+TEST_F(mraa_initio_h_unit, test_uart_rs485_init)
+{
+    mraa_io_descriptor* desc;
+    mraa_result_t status;
+
+    status = mraa_io_init("u:0x0:9600:8N1:rs485", &desc);
+    ASSERT_NE(status, MRAA_SUCCESS);
+    status = mraa_io_init("u:0x0:9600:8N1:rs422", &desc);
+    ASSERT_NE(status, MRAA_SUCCESS);
+
+    status = mraa_io_init("u:0x0:9600:8N1:rs485:0", &desc);
+    ASSERT_EQ(status, MRAA_SUCCESS);
+    ASSERT_EQ(MRAA_UART_RS485_GPIO, mraa_uart_get_rs485_mode(desc->uarts[0]));
+    ASSERT_EQ(4, mraa_uart_write(desc->uarts[0], "ping", 4));
+    ASSERT_EQ(MRAA_ERROR_INVALID_RESOURCE, mraa_uart_set_write_buffer(desc->uarts[0], 64));
+
+    // a failed switch keeps the current mode, the same DE pin can be reconfigured
+    ASSERT_EQ(MRAA_ERROR_FEATURE_NOT_SUPPORTED, mraa_uart_set_rs485(desc->uarts[0], 1, -1, 0));
+    ASSERT_EQ(MRAA_UART_RS485_GPIO, mraa_uart_get_rs485_mode(desc->uarts[0]));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_rs485(desc->uarts[0], 1, 0, 1));
+    ASSERT_EQ(MRAA_UART_RS485_GPIO, mraa_uart_get_rs485_mode(desc->uarts[0]));
+    ASSERT_EQ(4, mraa_uart_write(desc->uarts[0], "ping", 4));
+    ASSERT_EQ(MRAA_SUCCESS, mraa_uart_set_rs485(desc->uarts[0], 0, -1, 0));
+    ASSERT_EQ(MRAA_UART_RS485_OFF, mraa_uart_get_rs485_mode(desc->uarts[0]));
+
+    status = mraa_io_close(desc);
+    ASSERT_EQ(status, MRAA_SUCCESS);
+}
+
 /* Test for a successful UART_OW init. */
 TEST_F(mraa_initio_h_unit, test_uart_ow_init)
 {